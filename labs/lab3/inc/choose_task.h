@@ -8,3 +8,24 @@
 
 // Chosen task
 #define CHOSEN           TASK2_2
+
+// Set to 1 to let the ADC digital comparators classify the temperature in task 1,
+// so that the CPU is only interrupted when the number of blinking LEDs changes
+#define USE_ADC_COMPARATOR      0U
+
+// Set to 1 to let the clock governor pick the system clock of tasks 1 and 2.1 from the
+// temperature and the CPU load. SW1 and SW2 are ignored while it is in charge
+#define USE_GOVERNOR            0U
+
+// Set to 1 to send the temperature of task 2.1 as binary telemetry (about 5 bytes per
+// reading instead of a 32-byte text line). Decode it with tools/telemetry_decode.py
+#define USE_TELEMETRY           0U
+
+// Set to 1 to make task 2.2 a bridge between UART0 (ICDI) and UART3 (Bluetooth) in both
+// directions, instead of echoing the Bluetooth traffic back
+#define USE_UART_BRIDGE         0U
+
+// Set to 1 to run a command shell on UART0 in task 2.1, to read the counters and change
+// the sample period, the blink period and the clock without reflashing ("help" lists
+// the commands). The temperature lines keep going out unless "set print 0"
+#define USE_SHELL               0U
@@ -7,7 +7,13 @@
 enum frequency {PRESET1 = 120, PRESET2 = 60, PRESET3 = 12};
 
 // Initialize the PLL module and generates a system clock frequency
-// that equal to the frequency preset
+// that equal to the frequency preset. The UARTs clocked from the system
+// clock get new baud divisors (UART_SetSystemClock)
 // Returns 1 if configured successfully, -1 if you select a non-exist preset
+// (the clock is not changed then)
 int PLL_Init(enum frequency freq);
 
+// Returns the system clock frequency in MHz set by the last PLL_Init
+// (16 MHz from PIOSC before the first one)
+uint32_t PLL_GetFrequency(void);
+
@@ -2,6 +2,9 @@
 
 #include "choose_task.h"
 #include "tm4c1294ncpdt.h"
+#include "temperature.h"
+#include "snapshot.h"
+#include "governor.h"
 #include "clock.h"
 
 /*
@@ -13,6 +16,7 @@ extern GPIO_RegDef_t *LedsPortList[];
 extern uint8_t LedsPinList[];
 extern volatile uint8_t SW2_pressed;
 extern volatile uint8_t SW1_pressed;
+extern Snapshot_t TempSnapshot;
 
 // Possible settings in task 1 and 2.1
 typedef enum {
@@ -23,6 +27,7 @@ typedef enum {
 // Constants related to frequency or period for Task 1 and 2.1
 #define PIOSC_FREQ                              16000000UL
 #define SECONDS_TO_COUNT(SECONDS, FREQ)         ((SECONDS) * (FREQ))
+#define MS_TO_COUNT(MS, FREQ)                   ((MS) * ((FREQ) / 1000UL))
 #define BLINKING_PERIOD_IN_COUNTS               8000000UL
 #define ADC_TRIGGER_PERIOD                      1UL
 #define LED_BLINK_PERIOD                        2UL    
@@ -33,6 +38,12 @@ typedef enum {
 #define SYSCTL_ALTCLKCFG            *((volatile uint32_t *) (SYSCTL_BASE + SYSCTL_ALTCLKCFG_OFFSET))
 #define SYSCTL_ALTCLKCFG_MASK       0xFU
 
+// Clock governor (USE_GOVERNOR): runs at 12, 60 or 120 MHz, throttles above 60 C
+#define GOVERNOR_THROTTLE_TEMP      TEMP_CENTI(60)
+#define GOVERNOR_RELEASE_TEMP       TEMP_CENTI(55)
+#define GOVERNOR_HIGH_LOAD          80U
+#define GOVERNOR_TARGET_LOAD        50U
+
 /**
   * @brief  Initializes Timer0 as a periodic downcounter
   *         which triggers an ADC conversion every second
@@ -64,7 +75,7 @@ void SW_Init(void);
 
 /**
   * @brief  Initializes ADC0 to get triggered by Timer0 
-  *         to read the on-board temperature sensor
+  *         to read the on-board temperature sensor (task 2.1)
   * @retval None
   */
 void ADC_Init(void);
@@ -76,12 +87,58 @@ void ADC_Init(void);
   *           respectively.
   *         - Timer0 to trigger an ADC conversion every second
   *         - Timer1 to blink LEDs each 0.5 seconds
-  *         - ADC0 to get triggered by Timer0 to read the temperature sensor
   *         - GPIOs J0 and J1 as digital inputs to read switches SW1 and SW2
   * @retval None
   */
 void Task_Common_Init(void);
 
+/**
+  * @brief  Changes the period of the ADC conversions (Timer0) while it runs. The
+  *         initial period is ADC_TRIGGER_PERIOD
+  * @param  ms: Period in milliseconds
+  * @retval None
+  */
+void Task_SetSamplePeriod(uint32_t ms);
+uint32_t Task_GetSamplePeriod(void);
+
+/**
+  * @brief  Changes the time between two toggles of the LEDs (Timer1) while it runs.
+  *         The initial time is BLINKING_PERIOD_IN_COUNTS
+  * @param  ms: Time in milliseconds
+  * @retval None
+  */
+void Task_SetBlinkPeriod(uint32_t ms);
+uint32_t Task_GetBlinkPeriod(void);
+
+/**
+  * @brief  Starts the clock governor at 12 MHz, the clock set by Task_Common_Init()
+  *         (does nothing unless USE_GOVERNOR is set)
+  * @retval None
+  */
+void Task_Governor_Init(void);
+
+/**
+  * @brief  Marks the start and the end of a wait of the main loop, for the load
+  *         measured by the governor (do nothing unless USE_GOVERNOR is set)
+  * @retval None
+  */
+void Task_Governor_IdleEnter(void);
+void Task_Governor_IdleExit(void);
+
+/**
+  * @brief  Lets the governor pick the clock for the next period and applies it
+  *         with PLL_Init() (does nothing unless USE_GOVERNOR is set)
+  * @param  celsius: Latest temperature in centi-degrees Celsius
+  * @retval None
+  */
+void Task_Governor_Update(int32_t celsius);
+
+/**
+  * @brief  Returns the CPU load of the last period measured by the governor
+  * @retval Load in percent (0 unless USE_GOVERNOR is set)
+  */
+uint8_t Task_Governor_GetLoad(void);
+
 /**
   * @brief  Toggles LEDs D0, ..., D[num_leds - 1] and turns
   *         the rest OFF
@@ -2,13 +2,55 @@
 #pragma once
 
 #include "common.h"
+#include "adc_bucket.h"
+#include "sampler.h"
+#include "dsp.h"
+
+// Temperatures between the LED buckets, and how far past them the temperature
+// has to go before the number of LEDs changes (in centi-degrees)
+#define TEMP_EDGE_LOW                   TEMP_CENTI(20)
+#define TEMP_EDGE_MID                   TEMP_CENTI(24)
+#define TEMP_EDGE_HIGH                  TEMP_CENTI(28)
+#define TEMP_HYSTERESIS                 50L
+
+// The temperature sensor is the only channel of the sampler. It is converted
+// TASK1_TEMP_OVERSAMPLING times per ADC_TRIGGER_PERIOD, and a CIC decimator averages
+// those conversions into one reading so that the sensor noise does not reach the LEDs.
+// Order 1 (a boxcar) has no start-up transient, so the first reading is already valid
+#define TASK1_TEMP_CHANNEL              0U
+#define TASK1_TEMP_OVERSAMPLING         8U
+#define TASK1_TEMP_RATE_HZ              (TASK1_TEMP_OVERSAMPLING / ADC_TRIGGER_PERIOD)
+#define TASK1_TEMP_CIC_ORDER            1U
+#define TASK1_TEMP_BUFFER_SIZE          16U
 
 /**
-  * @brief  Reads the temperature sensor and decides on the number
-  *         of LEDs that will blink
+  * @brief  Configures the sampler to read the temperature sensor, and its decimator.
+  *         This also turns ADC0 on for the comparators
   * @retval None
   */
-void ADC0Sequence3_Handler(void);
+void Task1_Sampler_Init(void);
+
+/**
+  * @brief  Takes the conversions out of the sampler, decimates them into readings,
+  *         publishes them and decides on the number of LEDs that will blink
+  * @retval None
+  */
+void Task1_TakeSamples(void);
+
+/**
+  * @brief  Sets the number of blinking LEDs when the digital comparators
+  *         report that the temperature moved to another bucket
+  * @param  bucket: Bucket of the ADC code (0 is the hottest)
+  * @retval None
+  */
+void Task1_BucketCallback(uint8_t bucket, void *arg);
+
+/**
+  * @brief  Hands the LED bucket logic over to the ADC digital comparators
+  * @retval 1 on success, -1 if the comparators cannot be set up (the sampler
+  *         then keeps classifying every sample)
+  */
+int Task1_Comparator_Init(void);
 
 /**
   * @brief  Implements the main loop of task 1 of Laboratory #3:
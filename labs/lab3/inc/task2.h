@@ -1,11 +1,35 @@
 #pragma once
 
 #include "common.h"
+#include "snapshot.h"
+#include "uart_ring.h"
+#include "fmt.h"
+#include "telemetry.h"
+#include "uart_bridge.h"
+#include "shell.h"
 
-// Frequencies for UART0 and UART3 (for tasks 2.1 and 2.2, respectively)
+// Frequencies for UART0 and UART3 (for tasks 2.1 and 2.2, respectively). Both UARTs run
+// from PIOSC (0.08% slow at 115200, 0.005% at 9600): the buttons and the governor change
+// the system clock while text is going out, which would garble it on the system clock
 #define UART0_BaudRate                  115200UL
 #define Bluetooth_Baudrate              9600UL
-#define PIOSC_Freq                      16000000UL
+
+// Sizes of the UART ring buffers (powers of two). UART0 holds a few temperature lines
+// or a whole telemetry frame, UART3 a burst of echoed characters. The receive rings also
+// buffer the bridge (USE_UART_BRIDGE) between two polls
+#define UART0_TX_SIZE                   256U
+#define UART0_RX_SIZE                   64U
+#define UART3_TX_SIZE                   64U
+#define UART3_RX_SIZE                   64U
+
+// Without the bridge, UART3 receives each burst into a message buffer (UART_MSG_SIZE
+// bytes) of a pool, echoed whole
+#define UART3_MSG_COUNT                 4U
+
+// Telemetry (USE_TELEMETRY): channel of the temperature (centi-degrees Celsius), and
+// number of readings sent together in a frame
+#define TELEMETRY_TEMP_CHANNEL          0U
+#define TELEMETRY_BATCH                 8U
 
 /**
   * @brief  Implements the main loop of task 2.1 of Laboratory #3:
@@ -24,6 +48,8 @@ void Task2_1(void);
 /**
   * @brief  Implements task 2.2 of laboratory #3:
   *         - UART Return-to-Sender feature, using an HC-06 bluetooth module
+  *         - With USE_UART_BRIDGE, forwards the traffic between the ICDI (UART0)
+  *           and the HC-06 (UART3) in both directions instead
   * @retval None
   */
 void Task2_2(void);
@@ -44,7 +70,8 @@ void ADC0Sequence3_Handler(void);
 void UART0_TxRx_Init(void);
 
 /**
-  * @brief  Initializes UART0 for communication (to send temperature)
+  * @brief  Initializes UART0 for communication (to send temperature), with its FIFOs
+  *         and ring buffers so sending never blocks the main loop
   * @retval None
   */
 void UART0_Init(void);
@@ -72,7 +99,8 @@ void Task2_1_Init(void);
 void UART3_TxRx_Init(void);
 
 /**
-  * @brief  Initializes UART3 for communication (for the Return-to-Sender feature)
+  * @brief  Initializes UART3 for communication (for the Return-to-Sender feature), with
+  *         its FIFOs and ring buffers
   * @retval None
   */
 void UART3_Init(void);
@@ -1,7 +1,16 @@
 #include "tm4c1294ncpdt.h"
 #include "clock.h"
+#include "uart_ring.h"
+
+// System clock in MHz, PIOSC until the PLL is set up
+static uint32_t CurrentFreq = 16U;
 
 int PLL_Init(enum frequency freq) {
+    // Check the preset before the clock is touched, so that a wrong one changes nothing
+    if (freq != PRESET1 && freq != PRESET2 && freq != PRESET3) {
+        return -1;
+    }
+
     SYSCTL->MOSCCTL &= ~(0x4);                      // Power up MOSC
     SYSCTL->MOSCCTL &= ~(0x8);                      // Enable MOSC
     while ((SYSCTL->RIS & 0x100) == 0) {};          // Wait for MOSC to be ready
@@ -44,5 +53,12 @@ int PLL_Init(enum frequency freq) {
     while ((SYSCTL->PLLSTAT & 0x1) == 0) {};        // Wait for PLL to lock and stabilize
 
     SYSCTL->RSCLKCFG |= (0x1u << 31) | (0x1 << 28);  // Use PLL and update Memory Timing Register
+
+    UART_SetSystemClock((uint32_t) freq * 1000000UL);  // Recompute the UART baud divisors
+    CurrentFreq = freq;
     return 1;
 }
+
+uint32_t PLL_GetFrequency(void) {
+    return CurrentFreq;
+}
@@ -1,5 +1,6 @@
 
 #include "common.h"
+#include "latency.h"
 
 /*  
  *  Contains a list of the ports where each LED D<i> is connected
@@ -25,6 +26,19 @@ volatile uint8_t num_leds = 0;
 volatile uint8_t SW2_pressed = RESET;
 volatile uint8_t SW1_pressed = RESET;
 
+// Latest temperature (in centi-degrees Celsius), published by the task that reads the sensor
+Snapshot_t TempSnapshot;
+
+// Clock governor and the preset of each of its levels, slowest first
+#if (USE_GOVERNOR)
+static Governor_t Governor;
+static const enum frequency GovernorPresets[] = {PRESET3, PRESET2, PRESET1};
+#endif
+
+// Periods of Timer0 and Timer1, which can be changed at run time
+static uint32_t SamplePeriodMs = ADC_TRIGGER_PERIOD * 1000UL;
+static uint32_t BlinkPeriodMs = BLINKING_PERIOD_IN_COUNTS / (PIOSC_FREQ / 1000UL);
+
 void Timer0_Init(void) {
     // Enable the clock for Timer0
     SYSCTL_RCGCTIMER_CMD(SYSCTL_RCGCTIMER_TIM0_MASK, ENABLE);
@@ -45,7 +59,7 @@ void Timer0_Init(void) {
 
     // Initialize
     TIM_Init(TIM0, &adctrigger, TIM_Port_Concatenated);
-    TIM_ConfigIntervalConc(TIM0, SECONDS_TO_COUNT(ADC_TRIGGER_PERIOD, PIOSC_FREQ));
+    TIM_ConfigIntervalConc(TIM0, MS_TO_COUNT(SamplePeriodMs, PIOSC_FREQ));
     TIM_ConfigADCTrigger(TIM0, ENABLE, TIM_ADCEvent_TimeoutA);
     TIM_EnableADCTrigger(TIM0, ENABLE, TIM_Port_Concatenated);
 }
@@ -71,7 +85,7 @@ void Timer1_Init(void) {
     // Initialize
     TIM_Init(TIM1, &blinker, TIM_Port_Concatenated);
     
-    TIM_ConfigIntervalConc(TIM1, BLINKING_PERIOD_IN_COUNTS);
+    TIM_ConfigIntervalConc(TIM1, MS_TO_COUNT(BlinkPeriodMs, PIOSC_FREQ));
 
     // Clear previous events and enable interrupt generation
     TIM_ClearITAll(TIM1);
@@ -176,7 +190,73 @@ void Task_Common_Init(void) {
     Timer1_Init();
     LED_Init();
     SW_Init();
-    ADC_Init();
+    Task_Governor_Init();
+}
+
+void Task_SetSamplePeriod(uint32_t ms) {
+    SamplePeriodMs = ms;
+    TIM_ConfigIntervalConc(TIM0, MS_TO_COUNT(ms, PIOSC_FREQ));
+}
+
+uint32_t Task_GetSamplePeriod(void) {
+    return SamplePeriodMs;
+}
+
+void Task_SetBlinkPeriod(uint32_t ms) {
+    BlinkPeriodMs = ms;
+    TIM_ConfigIntervalConc(TIM1, MS_TO_COUNT(ms, PIOSC_FREQ));
+}
+
+uint32_t Task_GetBlinkPeriod(void) {
+    return BlinkPeriodMs;
+}
+
+void Task_Governor_Init(void) {
+    #if (USE_GOVERNOR)
+    GovernorConfig_t config;
+    config.NumLevels = sizeof(GovernorPresets) / sizeof(GovernorPresets[0]);
+    for (uint8_t level = 0; level < config.NumLevels; level++) {
+        config.LevelsMHz[level] = GovernorPresets[level];
+    }
+    config.ThrottleCentiC = GOVERNOR_THROTTLE_TEMP;
+    config.ReleaseCentiC = GOVERNOR_RELEASE_TEMP;
+    config.HighLoadPct = GOVERNOR_HIGH_LOAD;
+    config.TargetLoadPct = GOVERNOR_TARGET_LOAD;
+
+    // The load is timed with the DWT cycle counter
+    Latency_Init(PRESET3 * 1000000UL);
+    Governor_Init(&Governor, &config, 0);
+    #endif
+}
+
+void Task_Governor_IdleEnter(void) {
+    #if (USE_GOVERNOR)
+    Governor_IdleEnter(&Governor);
+    #endif
+}
+
+void Task_Governor_IdleExit(void) {
+    #if (USE_GOVERNOR)
+    Governor_IdleExit(&Governor);
+    #endif
+}
+
+void Task_Governor_Update(int32_t celsius) {
+    #if (USE_GOVERNOR)
+    uint8_t level = Governor.Level;
+
+    if (Governor_Update(&Governor, celsius) != level) {
+        PLL_Init(GovernorPresets[Governor.Level]);
+    }
+    #endif
+}
+
+uint8_t Task_Governor_GetLoad(void) {
+    #if (USE_GOVERNOR)
+    return Governor_GetLoad(&Governor);
+    #else
+    return 0;
+    #endif
 }
 
 void Timer1A_Handler(void) {
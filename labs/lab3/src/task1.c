@@ -1,51 +1,131 @@
 
 #include "task1.h"
 
-#if (CHOSEN == TASK1)
-void ADC0Sequence3_Handler(void) {
-    // Clear the IT Flag
-    ADC_ClearIT(ADC0, ADC_ITReadPos_Sequencer3);
-
-    // take the sample and decode the temperature
-    float temp;
-    temp = ADC_ReadValue(ADC0, ADC_FIFO3) * 247.5 / 4096.0;
-    temp = -temp;
-    temp = temp + 147.5;
-
-    // Decide on number of blinking LEDs value based on temperature
-    if (temp < 20.0) {
-        num_leds = 1U;
-    } else if(temp < 24.0) {
-        num_leds = 2U;
-    } else if(temp < 28.0) {
-        num_leds = 3U;
-    } else {
-        num_leds = 4U;
+#include <stddef.h>
+
+static SamplerSample_t TempSamples[TASK1_TEMP_BUFFER_SIZE];
+static DspCic_t TempDecimator;
+
+// Set once the comparators classify the temperature in place of every sample
+static uint8_t ComparatorActive = RESET;
+
+void Task1_BucketCallback(uint8_t bucket, void *arg) {
+    (void) arg;
+    // The ADC code goes down as the temperature goes up: bucket 0 is the hottest
+    num_leds = 4U - bucket;
+}
+
+int Task1_Comparator_Init(void) {
+    // Edges in ascending ADC codes, i.e. descending temperatures
+    AdcBucketConfig_t buckets;
+    buckets.Input = ADC_BUCKET_TEMP;
+    buckets.Edges[0] = TEMP_CENTI_TO_ADC(TEMP_EDGE_HIGH);
+    buckets.Edges[1] = TEMP_CENTI_TO_ADC(TEMP_EDGE_MID);
+    buckets.Edges[2] = TEMP_CENTI_TO_ADC(TEMP_EDGE_LOW);
+    buckets.NumEdges = 3U;
+    buckets.Hysteresis = TEMP_DELTA_TO_ADC(TEMP_HYSTERESIS);
+    buckets.Callback = Task1_BucketCallback;
+    buckets.Arg = NULL;
+
+    int bucket = AdcBucket_Init(&buckets);
+    if (bucket < 0) {
+        return -1;
+    }
+
+    // Sequencer 2 samples the sensor on the Timer0 trigger
+    num_leds = 4U - (uint8_t) bucket;
+    ComparatorActive = SET;
+    return 1;
+}
+
+void Task1_Sampler_Init(void) {
+    SamplerChannel_t temp;
+    temp.Input = SAMPLER_TEMP;
+    temp.RateHz = TASK1_TEMP_RATE_HZ;
+    temp.Buffer = TempSamples;
+    temp.Size = TASK1_TEMP_BUFFER_SIZE;
+
+    Sampler_Init(&temp, 1U);
+    Dsp_CicInit(&TempDecimator, TASK1_TEMP_CIC_ORDER, TASK1_TEMP_OVERSAMPLING);
+}
+
+void Task1_TakeSamples(void) {
+    static uint32_t readings = 0;
+    SamplerSample_t sample;
+    uint16_t code;
+
+    while (Sampler_Read(TASK1_TEMP_CHANNEL, &sample)) {
+        // One reading per TASK1_TEMP_OVERSAMPLING conversions
+        if (!Dsp_CicProcess(&TempDecimator, sample.Value, &code)) {
+            continue;
+        }
+
+        // decode the temperature (in centi-degrees, no floating point)
+        int32_t temp = Temp_AdcToCentiC(code);
+        Snapshot_Publish(&TempSnapshot, temp, readings++);
+
+        // Decide on number of blinking LEDs value based on temperature, unless the
+        // comparators already do
+        if (ComparatorActive) {
+            continue;
+        }
+        if (temp < TEMP_EDGE_LOW) {
+            num_leds = 1U;
+        } else if(temp < TEMP_EDGE_MID) {
+            num_leds = 2U;
+        } else if(temp < TEMP_EDGE_HIGH) {
+            num_leds = 3U;
+        } else {
+            num_leds = 4U;
+        }
     }
 }
-#endif
 
 void Task1(void) {
-    // Initialize peripherals common for task 1 and 2.1
+    // Initialize peripherals common for task 1 and 2.1, then the temperature sensor
     Task_Common_Init();
+    Task1_Sampler_Init();
+
+    // If the comparators cannot be set up, the LEDs keep following every sample
+    #if (USE_ADC_COMPARATOR)
+    Task1_Comparator_Init();
+    #endif
 
     // Start in slow mode (12MHz)
     TM_states_e present_state = TM_SLOW;
     TM_states_e next_state = TM_SLOW;
+    SnapshotSample_t reading;
+    uint32_t seen = 0;
     
     // Start the timers
     TIM_Command(TIM0, ENABLE, TIM_Port_Concatenated);
     TIM_Command(TIM1, ENABLE, TIM_Port_Concatenated);
 
+    // The sampler ticks at SAMPLER_TICK_HZ, so it only runs when its readings are used
+    if (!ComparatorActive || USE_GOVERNOR) {
+        Sampler_Start();
+    }
+
     // Let the CPU start taking interrupts
-    NVIC_EnableIRQ(ADC0_Sequence3_IRQNumber);
     NVIC_EnableIRQ(TIM1A_IRQNumber);
     NVIC_EnableIRQ(GPIOJ_IRQNumber);
 
     while(1) {
         
-        // Wait until a button is pressed
-        while (!SW1_pressed && !SW2_pressed);
+        // Wait until a button is pressed or until the sampler has a new reading
+        Task_Governor_IdleEnter();
+        while (!SW1_pressed && !SW2_pressed && !Sampler_Available(TASK1_TEMP_CHANNEL));
+        Task_Governor_IdleExit();
+        Task1_TakeSamples();
+
+        // The governor picks the clock once per reading, the buttons are ignored
+        if (Snapshot_Read(&TempSnapshot, &reading, &seen)) {
+            Task_Governor_Update(reading.Value);
+        }
+        if (USE_GOVERNOR) {
+            SW1_pressed = RESET;
+            SW2_pressed = RESET;
+        }
 
         // decide on what will be the next state
         switch (present_state) {
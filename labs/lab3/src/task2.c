@@ -1,35 +1,175 @@
 
 #include "task2.h"
 
-#include <string.h>
-#include <stdio.h>
+#include <stddef.h>
+
+// Long enough for the message and any temperature (FMT_NUMBER_LEN)
+static char buffer[40];
+
+// Ring buffers of the UARTs, emptied and filled by their interrupts
+static uint8_t Uart0Tx[UART0_TX_SIZE];
+static uint8_t Uart0Rx[UART0_RX_SIZE];
+static uint8_t Uart3Tx[UART3_TX_SIZE];
+#if (USE_UART_BRIDGE)
+static uint8_t Uart3Rx[UART3_RX_SIZE];
+#else
+static UartMessage_t Uart3Messages[UART3_MSG_COUNT];
+#endif
+
+#if (USE_TELEMETRY)
+// Binary telemetry of task 2.1
+static Telemetry_t Telemetry;
+
+// Queues a telemetry frame on UART0. A frame that does not fit is dropped whole, which
+// the receiver sees as a gap in the sequence numbers
+static void Task2_TelemetryWrite(const uint8_t *data, uint16_t len, void *arg) {
+    (void) arg;
+    if (UART_TxSpace(UART_PORT_0) >= len) {
+        UART_Write(UART_PORT_0, data, len);
+    }
+}
+#endif
+
+#if (USE_SHELL)
+// Command shell of task 2.1 on UART0
+static Shell_t Shell;
+
+// The temperature lines can be silenced, so that they do not get in the way of the shell
+static uint8_t PrintTemperature = 1;
+
+static int32_t Task2_GetSamplePeriod(void) {
+    return (int32_t) Task_GetSamplePeriod();
+}
+
+static int Task2_SetSamplePeriod(int32_t ms) {
+    Task_SetSamplePeriod((uint32_t) ms);
+    return 1;
+}
+
+static int32_t Task2_GetBlinkPeriod(void) {
+    return (int32_t) Task_GetBlinkPeriod();
+}
+
+static int Task2_SetBlinkPeriod(int32_t ms) {
+    Task_SetBlinkPeriod((uint32_t) ms);
+    return 1;
+}
+
+static int32_t Task2_GetClock(void) {
+    return (int32_t) PLL_GetFrequency();
+}
+
+static int Task2_SetClock(int32_t mhz) {
+    // PLL_Init() refuses anything but the presets and leaves the clock as it is
+    return PLL_Init((enum frequency) mhz);
+}
+
+static int32_t Task2_GetPrint(void) {
+    return PrintTemperature;
+}
+
+static int Task2_SetPrint(int32_t print) {
+    PrintTemperature = (uint8_t) print;
+    return 1;
+}
+
+static int32_t Task2_GetTemperature(void) {
+    SnapshotSample_t reading;
+    uint32_t seen = 0;
+
+    Snapshot_Read(&TempSnapshot, &reading, &seen);
+    return reading.Value;
+}
+
+static int32_t Task2_GetReadings(void) {
+    SnapshotSample_t reading;
+    uint32_t seen = 0;
 
-static uint8_t PrintRequested = RESET;
-static float temp = 0.0;
-static uint8_t buffer[30];
+    // The timestamp is the number of the reading, counted from 0
+    return Snapshot_Read(&TempSnapshot, &reading, &seen) ? (int32_t) reading.Timestamp + 1 : 0;
+}
+
+static int32_t Task2_GetLoad(void) {
+    return Task_Governor_GetLoad();
+}
+
+static int32_t Task2_GetRxOverruns(void) {
+    return (int32_t) UART_GetRxOverruns(UART_PORT_0);
+}
+
+static int32_t Task2_GetBaudError(void) {
+    return UART_GetBaudError(UART_PORT_0);
+}
+
+static const ShellVar_t ShellVars[] = {
+    { "sample_ms", "Time between readings, ms", Task2_GetSamplePeriod, Task2_SetSamplePeriod, 10, 60000, 0 },
+    { "blink_ms", "Time between LED toggles, ms", Task2_GetBlinkPeriod, Task2_SetBlinkPeriod, 50, 10000, 0 },
+    { "clock", "System clock: 12, 60 or 120 MHz", Task2_GetClock, Task2_SetClock, 12, 120, 0 },
+    { "print", "1 to print the temperature", Task2_GetPrint, Task2_SetPrint, 0, 1, 0 },
+    { "temp", "Last temperature, C", Task2_GetTemperature, NULL, 0, 0, 2 },
+    { "readings", "Readings taken", Task2_GetReadings, NULL, 0, 0, 0 },
+    { "load", "CPU load (governor), %", Task2_GetLoad, NULL, 0, 0, 0 },
+    { "rx_overruns", "Bytes lost by UART0", Task2_GetRxOverruns, NULL, 0, 0, 0 },
+    { "baud_error", "UART0 baud error, ppm", Task2_GetBaudError, NULL, 0, 0, 0 },
+};
+#endif
+
+// Shell of task 2.1 (USE_SHELL). Without it the temperature is always printed
+static void Task2_ShellInit(void) {
+    #if (USE_SHELL)
+    ShellConfig_t config;
+    config.Port = UART_PORT_0;
+    config.Commands = NULL;
+    config.NumCommands = 0;
+    config.Vars = ShellVars;
+    config.NumVars = sizeof(ShellVars) / sizeof(ShellVars[0]);
+    Shell_Init(&Shell, &config);
+    #endif
+}
+
+static uint8_t Task2_ShellBusy(void) {
+    #if (USE_SHELL)
+    return Shell_Busy(&Shell);
+    #else
+    return 0;
+    #endif
+}
+
+static void Task2_ShellPoll(void) {
+    #if (USE_SHELL)
+    Shell_Poll(&Shell);
+    #endif
+}
+
+static uint8_t Task2_ShellPrint(void) {
+    #if (USE_SHELL)
+    return PrintTemperature;
+    #else
+    return 1;
+    #endif
+}
 
 #if (CHOSEN == TASK2_1)
 void ADC0Sequence3_Handler(void) {
+    static uint32_t readings = 0;
+
     // Clear the IT Flag
     ADC_ClearIT(ADC0, ADC_ITReadPos_Sequencer3);
 
-    // take the sample and decode the temperature
-    temp = ADC_ReadValue(ADC0, ADC_FIFO3) * 247.5 / 4096.0;
-    temp = -temp;
-    temp = temp + 147.5;
+    // take the sample and decode the temperature (in centi-degrees, no floating point)
+    int32_t celsius = Temp_AdcToCentiC(ADC_ReadValue(ADC0, ADC_FIFO3));
+    Snapshot_Publish(&TempSnapshot, celsius, readings++);
 
     // Decide on number of blinking LEDs value based on temperature
-    if (temp < 20.0) {
+    if (celsius < TEMP_CENTI(20)) {
         num_leds = 1U;
-    } else if(temp < 24.0) {
+    } else if(celsius < TEMP_CENTI(24)) {
         num_leds = 2U;
-    } else if(temp < 28.0) {
+    } else if(celsius < TEMP_CENTI(28)) {
         num_leds = 3U;
     } else {
         num_leds = 4U;
     }
-
-    PrintRequested = SET;
 }
 #endif
 
@@ -55,33 +195,34 @@ void UART0_Init(void) {
     UART0_TxRx_Init();
 
     // Configure UART0 with a baud rate of 115200 bits/s, no parity, 1 stop-bit, and 8-bits of data
-    UART_Config_t uart;
+    UartRingConfig_t uart;
     uart.BaudRate = UART0_BaudRate;
-    uart.BreakCommand = DISABLE;
-    uart.ClockFreq = PIOSC_Freq;
-    uart.ClockSource = UART_ClockSource_ALTCLK;
-    uart.FifoCommand = DISABLE;
-    uart.HardwareCTS = DISABLE;
-    uart.HardwareRTS = DISABLE;
-    uart.HighSpeedCommand = DISABLE;
-    uart.LoopbackCommand = DISABLE;
-    uart.Parity = UART_Parity_Disabled;
-    uart.StopBits = UART_StopLen_1;
-    uart.WordLen = UART_WordLen_8;
-
-    // Enable the clock and wait until the peripheral is ready
-    SYSCTL_RCGCUART_CMD(SYSCTL_RCGCUART_UART0_MASK, ENABLE);
-    while(!(SYSCTL_PRUART_READ(SYSCTL_PRUART_UART0_POS)));
-
-    // Configure and enable
-    UART_Config(UART0, &uart);
-    UART_Command(UART0, ENABLE);
+    uart.ClockSource = UART_CLOCK_PIOSC;
+    uart.TxBuffer = Uart0Tx;
+    uart.TxSize = UART0_TX_SIZE;
+    uart.RxBuffer = Uart0Rx;
+    uart.RxSize = UART0_RX_SIZE;
+    uart.MsgPool = NULL;
+    uart.MsgCount = 0;
+    uart.DmaTasks = NULL;
+    uart.DmaMaxTasks = 0;
+    uart.FlowControl = 0;
+
+    // Enable the clock, the FIFOs and the interrupts, then the UART
+    UART_RingInit(UART_PORT_0, &uart);
 }
 
 void Task2_1_Init(void) {
-    // Initialize the common peripherals and then UART0
+    // Initialize the common peripherals, the temperature sensor and then UART0
     Task_Common_Init();
+    ADC_Init();
     UART0_Init();
+
+    #if (USE_TELEMETRY)
+    Telemetry_Init(&Telemetry, Task2_TelemetryWrite, NULL);
+    #endif
+
+    Task2_ShellInit();
 }
 
 void UART3_TxRx_Init(void) {
@@ -105,32 +246,37 @@ void UART3_Init(void) {
     UART3_TxRx_Init();
 
     // Configure with baud rate of 9600 bits/s, no parity, 1 stop bit, 8 bits of data
-    UART_Config_t uart;
+    UartRingConfig_t uart;
     uart.BaudRate = Bluetooth_Baudrate;
-    uart.BreakCommand = DISABLE;
-    uart.ClockFreq = PIOSC_Freq;
-    uart.ClockSource = UART_ClockSource_ALTCLK;
-    uart.FifoCommand = DISABLE;
-    uart.HardwareCTS = DISABLE;
-    uart.HardwareRTS = DISABLE;
-    uart.HighSpeedCommand = DISABLE;
-    uart.LoopbackCommand = DISABLE;
-    uart.Parity = UART_Parity_Disabled;
-    uart.StopBits = UART_StopLen_1;
-    uart.WordLen = UART_WordLen_8;
-
-    // Enable the clock and wait until the peripheral is ready
-    SYSCTL_RCGCUART_CMD(SYSCTL_RCGCUART_UART3_MASK, ENABLE);
-    while(!(SYSCTL_PRUART_READ(SYSCTL_PRUART_UART3_POS)));
-
-    // Configure and enable
-    UART_Config(UART3, &uart);
-    UART_Command(UART3, ENABLE);
+    uart.ClockSource = UART_CLOCK_PIOSC;
+    uart.TxBuffer = Uart3Tx;
+    uart.TxSize = UART3_TX_SIZE;
+    #if (USE_UART_BRIDGE)
+    uart.RxBuffer = Uart3Rx;
+    uart.RxSize = UART3_RX_SIZE;
+    uart.MsgPool = NULL;
+    uart.MsgCount = 0;
+    #else
+    // Each burst lands in a message buffer, found by the end of the burst (receive time-out)
+    uart.RxBuffer = NULL;
+    uart.RxSize = 0;
+    uart.MsgPool = Uart3Messages;
+    uart.MsgCount = UART3_MSG_COUNT;
+    #endif
+    uart.DmaTasks = NULL;
+    uart.DmaMaxTasks = 0;
+    uart.FlowControl = 0;
+
+    // Enable the clock, the FIFOs and the interrupts, then the UART
+    UART_RingInit(UART_PORT_3, &uart);
 }
 
 void Task2_2_Init(void) {
-    // Initialize UART3 connected to the HC-06 module
+    // Initialize UART3 connected to the HC-06 module, and UART0 for the bridge
     UART3_Init();
+    #if (USE_UART_BRIDGE)
+    UART0_Init();
+    #endif
 }
 
 void Task2_1(void) {
@@ -140,6 +286,8 @@ void Task2_1(void) {
     // Start in slow mode (12MHz)
     TM_states_e present_state = TM_SLOW;
     TM_states_e next_state = TM_SLOW;
+    SnapshotSample_t reading;
+    uint32_t seen = 0;
     
     // Start the timers
     TIM_Command(TIM0, ENABLE, TIM_Port_Concatenated);
@@ -152,18 +300,44 @@ void Task2_1(void) {
 
     while(1) {
         
-        // Wait until a button is pressed or until we have to print
-        while (!SW1_pressed && !SW2_pressed && !PrintRequested);
+        // Wait until a button is pressed, until we have to print or until the shell
+        // has received something
+        Task_Governor_IdleEnter();
+        while (!SW1_pressed && !SW2_pressed && !Snapshot_IsNew(&TempSnapshot, seen) &&
+               !Task2_ShellBusy());
+        Task_Governor_IdleExit();
+
+        Task2_ShellPoll();
         
-        if (PrintRequested) {
-            // This should never be a problem since the ADC is triggered once per second
-            // But to be safe, make a critical section to avoid corruption of temp
-            __asm volatile("cpsid i\t\n");
-            sprintf((char *) buffer, "Temperature in celcius: %.2f\r\n", temp);
-            __asm volatile("cpsie i\t\n");
-
-            UART_SendData(UART0, buffer, strlen((char *) buffer));
-            PrintRequested = RESET;
+        // Consistent copy of the latest reading, interrupts stay enabled
+        if (Snapshot_Read(&TempSnapshot, &reading, &seen)) {
+            #if (USE_TELEMETRY)
+            // The reading number is the time: one tick per conversion
+            Telemetry_PutInt(&Telemetry, TELEMETRY_TEMP_CHANNEL, reading.Value, reading.Timestamp);
+            if (reading.Timestamp % TELEMETRY_BATCH == TELEMETRY_BATCH - 1U) {
+                Telemetry_Flush(&Telemetry);
+            }
+            #else
+            FmtSink_t line;
+            Fmt_BufferSink(&line, buffer, sizeof(buffer));
+            Fmt_Str(&line, "Temperature in celcius: ");
+            Fmt_Fixed(&line, reading.Value, 2);
+            Fmt_Str(&line, "\r\n");
+
+            // Queued for the UART0 interrupt, a line that does not fit is dropped whole
+            if (Task2_ShellPrint() && UART_TxSpace(UART_PORT_0) >= line.Len) {
+                UART_Write(UART_PORT_0, (const uint8_t *) buffer, line.Len);
+            }
+            #endif
+
+            // The governor picks the clock once per reading
+            Task_Governor_Update(reading.Value);
+        }
+
+        // The buttons only choose the clock when the governor does not
+        if (USE_GOVERNOR) {
+            SW1_pressed = RESET;
+            SW2_pressed = RESET;
         }
 
         // decide on what will be the next state
@@ -202,13 +376,27 @@ void Task2_2(void) {
     // Initialize the peripherals used in task 2.2 (which is UART3)
     Task2_2_Init();
 
-    // Buffer for a single byte of data (one char)
-    uint8_t buffer;
+    #if (USE_UART_BRIDGE)
+    // Both directions at once, the UART interrupts keep the FIFOs going between polls
+    UartBridge_t bridge;
+    UartBridge_Init(&bridge, UART_PORT_0, UART_PORT_3);
     while(1) {
-        // Wait until a char is received
-        UART_ReceiveDataSimple(UART3, &buffer, 1);
+        UartBridge_Poll(&bridge);
+    }
+    #else
+    // Each burst is returned to the sender from its message buffer, once the transmit
+    // ring has room for it. The interrupt fills the other buffers of the pool meanwhile
+    UartMessage_t *message = NULL;
+    while(1) {
+        if (message == NULL) {
+            message = UART_ReceiveMessage(UART_PORT_3);
+        }
 
-        // Return that char to the sender
-        UART_SendData(UART3, &buffer, 1);
+        if (message != NULL && UART_TxSpace(UART_PORT_3) >= message->Length) {
+            UART_Write(UART_PORT_3, message->Data, message->Length);
+            UART_ReleaseMessage(UART_PORT_3, message);
+            message = NULL;
+        }
     }
+    #endif
 }
\ No newline at end of file
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "touch_dispatch.h"
+#include "scope.h"
+
+// Register definition for alternate clock configuration (the capture timer runs on PIOSC)
+#define SYSCTL_ALTCLKCFG_OFFSET     0x138U
+#define SYSCTL_ALTCLKCFG            *((volatile uint32_t *) (SYSCTL_BASE + SYSCTL_ALTCLKCFG_OFFSET))
+#define SYSCTL_ALTCLKCFG_MASK       0xFU
+
+// Input under test: AIN0 on PE3
+#define SCOPE_INPUT                 0U
+
+// Trigger: mid-scale, rising edge, re-armed 64 codes below the level
+#define SCOPE_LEVEL                 2048U
+#define SCOPE_HYSTERESIS            64U
+
+// Trace area, below the status line
+#define SCOPE_X                     10U
+#define SCOPE_Y                     30U
+#define SCOPE_HEIGHT                200U
+
+// Colors
+#define SCOPE_BACKGROUND_COLOR      Color4[0]
+#define SCOPE_TRACE_COLOR           Color4[10]
+#define SCOPE_SCREEN_COLOR          Color4[8]
+
+// How often the frame rate and the capture rate are printed
+#define SCOPE_REPORT_MS             1000UL
+
+/**
+  * @brief  Oscilloscope on AIN0: 
+  *         - A tap on the screen selects the next sampling rate
+  *         - A long press toggles the trigger between rising and falling edges
+  *         - The frame rate, capture rate and overflows are printed every second
+  * @retval None
+  */
+void ScopeTask(void);
+
+/**
+  * @brief  Touch dispatcher callback for the whole screen. Sets the flag of the action
+  *         requested by a tap or a long press
+  * @retval None
+  */
+void ScopeTask_TouchCallback(int8_t region, const TouchEvent_t *event, void *arg);
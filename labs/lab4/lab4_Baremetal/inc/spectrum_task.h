@@ -0,0 +1,51 @@
+#pragma once
+
+#include "fft.h"
+#include "spectrum_view.h"
+
+// Register definition for alternate clock configuration (the capture timer runs on PIOSC)
+#define SYSCTL_ALTCLKCFG_OFFSET     0x138U
+#define SYSCTL_ALTCLKCFG            *((volatile uint32_t *) (SYSCTL_BASE + SYSCTL_ALTCLKCFG_OFFSET))
+#define SYSCTL_ALTCLKCFG_MASK       0xFU
+
+// CPU clock while the task runs (PRESET1), used to convert the benchmarks
+#define SPECTRUM_CPU_FREQ           120000000UL
+
+// Input under test: AIN0 on PE3, sampled at 8 kHz in blocks of 256 points (31.25 Hz per bin)
+#define SPECTRUM_INPUT              0U
+#define SPECTRUM_RATE_HZ            8000UL
+#define SPECTRUM_POINTS             256U
+
+// Bar graph: 64 bars of 4 columns below the text
+#define SPECTRUM_X                  0U
+#define SPECTRUM_Y                  80U
+#define SPECTRUM_HEIGHT             160U
+#define SPECTRUM_BARS               64U
+#define SPECTRUM_BAR_WIDTH          4U
+#define SPECTRUM_BAR_GAP            1U
+
+// Colors
+#define SPECTRUM_BACKGROUND_COLOR   Color4[0]
+#define SPECTRUM_BAR_COLOR          Color4[11]
+#define SPECTRUM_SCREEN_COLOR       Color4[8]
+
+// Sizes benchmarked at start-up
+#define SPECTRUM_BENCH_MIN          64U
+#define SPECTRUM_BENCH_MAX          1024U
+#define SPECTRUM_BENCH_SIZES        5U
+
+// Cycles taken by each step of one benchmarked transform
+typedef struct {
+    uint16_t Points;
+    uint32_t WindowCycles;
+    uint32_t TransformCycles;
+    uint32_t MagnitudeCycles;
+} SpectrumBench_t;
+
+/**
+  * @brief  Spectrum analyzer on AIN0:
+  *         - Benchmarks the FFT from 64 to 1024 points and prints the cycle counts
+  *         - Then shows the spectrum of the input as a bar graph, and the peak frequency
+  * @retval None
+  */
+void SpectrumTask(void);
@@ -4,6 +4,13 @@
 #include "tm4c1294ncpdt.h"
 #include "SSD2119_Display.h"
 #include "SSD2119_Touch.h"
+#include "touch_dispatch.h"
+#include "timebase.h"
+#include "temperature.h"
+#include "fmt_lcd.h"
+#include "chart.h"
+#include "dsp.h"
+#include "snapshot.h"
 #include "clock.h"
 
 // Possible settings in task 1B
@@ -47,17 +54,27 @@ typedef enum {
 #define FAST_COLOR                  convertColor(255, 0, 0)
 #define SLOW_COLOR                  convertColor(0, 255, 0)
 
+// Temperature history chart, below the buttons of task 1C
+// One column every CHART_DECIMATION readings: 300 columns are 10 minutes at 1 reading per second
+// The readings go through a low-pass of about 2^CHART_SMOOTHING readings first, so the
+// trace does not jitter with the noise of the sensor
+#define CHART_X                     10U
+#define CHART_Y                     160U
+#define CHART_WIDTH                 300U
+#define CHART_HEIGHT                70U
+#define CHART_MIN                   TEMP_CENTI(15)
+#define CHART_MAX                   TEMP_CENTI(35)
+#define CHART_DECIMATION            2U
+#define CHART_SMOOTHING             2U
+#define CHART_BACKGROUND_COLOR      Color4[0]
+#define CHART_TRACE_COLOR           Color4[14]
+#define CHART_FRAME_COLOR           Color4[15]
+
 // Register definition for alternate clock configuration for task 1B and 1C
 #define SYSCTL_ALTCLKCFG_OFFSET     0x138U
 #define SYSCTL_ALTCLKCFG            *((volatile uint32_t *) (SYSCTL_BASE + SYSCTL_ALTCLKCFG_OFFSET))
 #define SYSCTL_ALTCLKCFG_MASK       0xFU
 
-// Celcius to Farenheit Conversion
-#define CELCIUS_TO_FARENH(C)        ((C) * 1.8 + 32.0)
-
-// ADC value to Celcius
-#define ADC_TO_CELCIUS(A)           (147.5 - ((A) * 247.5 / 4096.0))
-
 /**
   * @brief  Initializes Timer0 as a periodic downcounter
   *         which triggers an ADC conversion every second
@@ -118,6 +135,7 @@ void Task1B_Init(void);
   *         - Timer0 to trigger an ADC conversion every second
   *         - Timer1 to blink LEDs each 0.5 seconds
   *         - ADC0 to get triggered by Timer0 to read the temperature sensor
+  *         - SysTick as the millisecond timebase of the touch dispatcher
   *         - The LCD screen and touch functions using ADC1 and the following GPIOs:
   *             * Data:    D2, K5, M7, P0-1, Q0, Q2-3
   *             * Control: N4-5, P3-4
@@ -125,6 +143,20 @@ void Task1B_Init(void);
   */
 void Task1C_Init(void);
 
+/**
+  * @brief  Draws the empty temperature history chart
+  * @retval None
+  */
+void Task1_ChartInit(void);
+
+/**
+  * @brief  Adds a temperature reading to the history and, when a decimated
+  *         sample is complete, plots it as the newest column of the chart
+  * @param  celsius: Temperature in centi-degrees Celsius
+  * @retval None
+  */
+void Task1_ChartUpdate(int32_t celsius);
+
 /**
   * @brief  Toggles LEDs D0, ..., D[num_leds - 1] and turns
   *         the rest OFF
@@ -164,6 +196,13 @@ void Task1B(void);
   */
 void Task1C(void);
 
+/**
+  * @brief  Touch dispatcher callback for the FAST and SLOW buttons of task 1C.
+  *         Sets the flag passed as the argument of the region when it is pressed
+  * @retval None
+  */
+void Task1C_ButtonCallback(int8_t region, const TouchEvent_t *event, void *arg);
+
 /**
   * @brief  Reads the temperature sensor and decides on the number
   *         of LEDs that will blink. Also requests the temperature be
@@ -1,6 +1,10 @@
 
 #pragma once
 
+#include "touch_dispatch.h"
+#include "shell.h"
+#include "log.h"
+
 // All possibles states of the FSM 
 typedef enum {
     IDLE,
@@ -19,13 +23,7 @@ typedef enum {
 #define SYSCTL_ALTCLKCFG            *((volatile uint32_t *) (SYSCTL_BASE + SYSCTL_ALTCLKCFG_OFFSET))
 #define SYSCTL_ALTCLKCFG_MASK       0xFU
 
-// Timers used 
-#define PEDESTRIAN_BUTTON_TIMER         TIM1
-#define PEDESTRIAN_BUTTON_TIMER_MASK    SYSCTL_RCGCTIMER_TIM1_MASK   
-#define PEDESTRIAN_BUTTON_TIMER_POS     SYSCTL_PRTIMER_TIM1_POS  
-#define START_STOP_BUTTON_TIMER         TIM2
-#define START_STOP_BUTTON_TIMER_MASK    SYSCTL_RCGCTIMER_TIM2_MASK  
-#define START_STOP_BUTTON_TIMER_POS     SYSCTL_PRTIMER_TIM2_POS 
+// Timer used (the 2-second button presses are timed by the touch dispatcher)
 #define TRANSITION_TIMER                TIM3
 #define TRANSITION_TIMER_MASK           SYSCTL_RCGCTIMER_TIM3_MASK  
 #define TRANSITION_TIMER_POS            SYSCTL_PRTIMER_TIM3_POS 
@@ -68,9 +66,31 @@ typedef enum {
 #define PED_LABEL_X                     195
 #define PED_LABEL_Y                     90
 
+// Initial timings, the shell (USE_SHELL) can change them at run time
 #define BUTTON_PRESS_IN_S               2UL
 #define TRANSITION_TIMEOUT_IN_S         5UL
 
+// Set to 1 to run a command shell on UART0, to change the timings without reflashing
+// ("help" lists the commands). The latency report still goes out through the console
+#define USE_SHELL                       0U
+
+// Set to 1 to send a deferred log of the buttons and transitions on UART0, as binary
+// frames that tools/log_decode.py prints with the ELF file of the build. UART0 then
+// carries the log only: no shell and no latency report
+#define USE_LOG                         0U
+
+#if (USE_LOG && USE_SHELL)
+#error "USE_LOG and USE_SHELL both need UART0"
+#endif
+
+// Ring buffers of UART0, shared by the shell and the log (powers of two)
+#define UART0_TX_SIZE                   1024U
+#define UART0_RX_SIZE                   64U
+
+// Longest latency report: about 40 bytes per stage plus 15 per non-empty bucket. The
+// report goes out through the uDMA straight from its buffer, and a longer one is skipped
+#define LATENCY_REPORT_SIZE             512U
+
 
 // Radius of buttons and lights
 #define RADIUS                          20
@@ -86,18 +106,28 @@ void Task2A(void);
   * 1) The LCD screen and touch functions using ADC1 and the following GPIOs:
   *        * Data:    D2, K5, M7, P0-1, Q0, Q2-3
   *        * Control: N4-5, P3-4
-  * 2) Timers TIM1, TIM2, and TIM3 that are associated
-  * to the pedestrian button, the start/stop button, and
-  * the transition timer, respectively 
+  * 2) Timer TIM3, which is the transition timer
+  * 3) SysTick as the millisecond timebase of the touch dispatcher
+  * 4) The cycle counter and UART0 (ring buffers and uDMA) for the touch-to-photon
+  *    latency report
+  * 5) The command shell on UART0, with USE_SHELL
+  * 6) The deferred log on UART0, with USE_LOG
   * @retval None
   */
 void Task2A_Init(void);
 
 /**
-  * @brief  Initializes the Timers used in task 2A:
-  * Timers TIM1, TIM2, and TIM3 that are associated
-  * to the pedestrian button, the start/stop button, and
-  * the transition timer, respectively 
+  * @brief  Touch dispatcher callback for the buttons of task 2A.
+  *         Sets the flag passed as the argument of the region once 
+  *         the button has been held for BUTTON_PRESS_IN_S seconds, and
+  *         again every BUTTON_PRESS_IN_S seconds while it stays held
+  * @retval None
+  */
+void Task2A_ButtonCallback(int8_t region, const TouchEvent_t *event, void *arg);
+
+/**
+  * @brief  Initializes the Timer used in task 2A:
+  * Timer TIM3, which is the transition timer
   * @retval None
   */
 void Task2A_Timers_Init(void);
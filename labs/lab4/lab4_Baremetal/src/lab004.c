@@ -1,11 +1,15 @@
 
 #include "task1.h"
 #include "task2.h"
+#include "scope_task.h"
+#include "spectrum_task.h"
 
 #define TASK1B              2U
 #define TASK1C              3U
 #define TASK2A              4U
 // Task 2B is not compiled here. It is run within the FreeRTOS demo project
+#define SCOPE_MODE          5U
+#define SPECTRUM_MODE       6U
 
 #define CHOSEN              TASK2A  
 
@@ -23,6 +27,14 @@ int main(void) {
         case TASK2A:
             Task2A();
             break;
+
+        case SCOPE_MODE:
+            ScopeTask();
+            break;
+
+        case SPECTRUM_MODE:
+            SpectrumTask();
+            break;
     }
 
     while(1);
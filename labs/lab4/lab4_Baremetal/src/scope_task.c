@@ -0,0 +1,123 @@
+#include "tm4c1294ncpdt.h"
+#include "SSD2119_Display.h"
+#include "SSD2119_Touch.h"
+#include "adc_stream.h"
+#include "timebase.h"
+#include "fmt_lcd.h"
+#include "clock.h"
+#include "scope_task.h"
+
+
+// Sampling rates selected by a tap, in samples per second
+static const uint32_t Rates[] = {1000UL, 10000UL, 50000UL, 100000UL, 200000UL};
+#define NUM_RATES       (sizeof(Rates) / sizeof(Rates[0]))
+
+// Actions requested from the touch callback
+static uint8_t NextRateRequested = RESET;
+static uint8_t EdgeToggleRequested = RESET;
+
+void ScopeTask_TouchCallback(int8_t region, const TouchEvent_t *event, void *arg) {
+    (void) region;
+    (void) arg;
+    if (event->Type == TOUCH_EVENT_TAP) {
+        NextRateRequested = SET;
+    } else if (event->Type == TOUCH_EVENT_LONG_PRESS) {
+        EdgeToggleRequested = SET;
+    }
+}
+
+// Prints the status line: frame rate, capture rate, sampling rate, edge and overflows
+static void ScopeTask_Report(uint32_t fps, uint32_t sps, ScopeEdge_e edge) {
+    FmtSink_t lcd;
+    Fmt_LcdSink(&lcd);
+
+    LCD_SetCursor(0, 0);
+    Fmt_UInt(&lcd, fps);
+    Fmt_Str(&lcd, " fps  ");
+    Fmt_UInt(&lcd, sps);
+    Fmt_Str(&lcd, " S/s (set ");
+    Fmt_UInt(&lcd, Scope_GetRate());
+    Fmt_Str(&lcd, edge == SCOPE_EDGE_RISING ? ")  rise  ovf " : ")  fall  ovf ");
+    Fmt_UInt(&lcd, AdcStream_GetOverflows());
+    Fmt_Repeat(&lcd, ' ', 4);
+}
+
+void ScopeTask(void) {
+    // Run fast to draw fast. The capture timer, the ADC and the timebase run on PIOSC
+    PLL_Init(PRESET1);
+    SYSCTL_ALTCLKCFG &= ~(SYSCTL_ALTCLKCFG_MASK);
+
+    Timebase_Init();
+    LCD_Init();
+    Touch_Init();
+
+    LCD_ColorFill(SCOPE_SCREEN_COLOR);
+    LCD_SetTextColor(255, 255, 255);
+
+    uint8_t rate = 0;
+    ScopeConfig_t config;
+    config.Input = SCOPE_INPUT;
+    config.RateHz = Rates[rate];
+    config.Trigger.Level = SCOPE_LEVEL;
+    config.Trigger.Hysteresis = SCOPE_HYSTERESIS;
+    config.Trigger.Edge = SCOPE_EDGE_RISING;
+    config.Auto = ENABLE;
+    config.X = SCOPE_X;
+    config.Y = SCOPE_Y;
+    config.Height = SCOPE_HEIGHT;
+    config.Background = SCOPE_BACKGROUND_COLOR;
+    config.Trace = SCOPE_TRACE_COLOR;
+    Scope_Init(&config);
+
+    // The whole screen is a single touch region
+    TouchRegion_t screen;
+    screen.Left = 0;
+    screen.Right = (1U << TOUCH_RAW_BITS) - 1U;
+    screen.Bottom = 0;
+    screen.Top = (1U << TOUCH_RAW_BITS) - 1U;
+    screen.Callback = ScopeTask_TouchCallback;
+    screen.Arg = 0;
+    TouchDispatch_Reset();
+    TouchDispatch_Register(&screen);
+
+    ScopeEdge_e edge = SCOPE_EDGE_RISING;
+    uint32_t last_report = Timebase_Millis();
+    uint32_t last_frames = 0;
+    uint32_t last_samples = 0;
+
+    Scope_Start();
+
+    while (1) {
+        TouchDispatch_Poll(Timebase_Millis());
+
+        if (NextRateRequested) {
+            NextRateRequested = RESET;
+            rate = (rate + 1U) % NUM_RATES;
+            Scope_SetRate(Rates[rate]);
+        }
+
+        if (EdgeToggleRequested) {
+            EdgeToggleRequested = RESET;
+            edge = (edge == SCOPE_EDGE_RISING) ? SCOPE_EDGE_FALLING : SCOPE_EDGE_RISING;
+            Scope_SetTrigger(SCOPE_LEVEL, edge);
+        }
+
+        Scope_Render();
+
+        // Sustained rates over the last report period
+        uint32_t now = Timebase_Millis();
+        uint32_t elapsed = now - last_report;
+        if (elapsed >= SCOPE_REPORT_MS) {
+            uint32_t frames = Scope_GetFrames();
+            uint32_t samples = Scope_GetSamples();
+
+            ScopeTask_Report((frames - last_frames) * 1000UL / elapsed,
+                             (uint32_t) ((uint64_t) (samples - last_samples) * 1000U / elapsed),
+                             edge);
+
+            last_report = now;
+            last_frames = frames;
+            last_samples = samples;
+        }
+    }
+}
@@ -0,0 +1,139 @@
+#include "tm4c1294ncpdt.h"
+#include "SSD2119_Display.h"
+#include "adc_stream.h"
+#include "latency.h"
+#include "fmt_lcd.h"
+#include "clock.h"
+#include "spectrum_task.h"
+
+
+// Results of the start-up benchmark (also readable with the debugger)
+SpectrumBench_t SpectrumBench[SPECTRUM_BENCH_SIZES];
+
+// Transform buffers, sized for the largest benchmark
+static FftComplex_t Data[FFT_MAX_POINTS];
+static uint16_t Magnitude[FFT_MAX_POINTS / 2U];
+static uint16_t Block[FFT_MAX_POINTS];
+
+// DMA buffers, and the flag that hands a copy of one of them to the main loop
+static uint16_t Buffers[2][SPECTRUM_POINTS];
+static volatile uint8_t BlockReady = RESET;
+
+// Runs in the ADC0 sequencer 0 interrupt: keeps a block unless the last one is still in use
+static void SpectrumTask_Capture(const uint16_t *samples, uint16_t count, void *arg) {
+    (void) arg;
+    if (BlockReady) {
+        return;
+    }
+    for (uint16_t i = 0; i < count; i++) {
+        Block[i] = samples[i];
+    }
+    BlockReady = SET;
+}
+
+// Times each step of the transform for every size, on a test tone
+static void SpectrumTask_Benchmark(void) {
+    FftPlan_t plan;
+    FmtSink_t lcd;
+    uint16_t points = SPECTRUM_BENCH_MIN;
+
+    Fmt_LcdSink(&lcd);
+
+    // Square wave at 1/16 of the sampling rate: rich in harmonics, not a trivial input
+    for (uint16_t i = 0; i < FFT_MAX_POINTS; i++) {
+        Block[i] = (i & 8U) ? 3000U : 1000U;
+    }
+
+    for (uint8_t i = 0; i < SPECTRUM_BENCH_SIZES; i++, points <<= 1) {
+        Fft_Init(&plan, points);
+
+        uint32_t start = Latency_Cycles();
+        Fft_Window(&plan, Block, 1, Data);
+        uint32_t windowed = Latency_Cycles();
+        Fft_Transform(&plan, Data);
+        uint32_t transformed = Latency_Cycles();
+        Fft_Magnitude(&plan, Data, Magnitude);
+        uint32_t end = Latency_Cycles();
+
+        SpectrumBench[i].Points = points;
+        SpectrumBench[i].WindowCycles = windowed - start;
+        SpectrumBench[i].TransformCycles = transformed - windowed;
+        SpectrumBench[i].MagnitudeCycles = end - transformed;
+
+        Fmt_Str(&lcd, "FFT ");
+        Fmt_UInt(&lcd, points);
+        Fmt_Str(&lcd, ": window ");
+        Fmt_UInt(&lcd, SpectrumBench[i].WindowCycles);
+        Fmt_Str(&lcd, ", fft ");
+        Fmt_UInt(&lcd, SpectrumBench[i].TransformCycles);
+        Fmt_Str(&lcd, ", mag ");
+        Fmt_UInt(&lcd, SpectrumBench[i].MagnitudeCycles);
+        Fmt_Str(&lcd, " cycles\r\n");
+    }
+}
+
+void SpectrumTask(void) {
+    PLL_Init(PRESET1);
+    SYSCTL_ALTCLKCFG &= ~(SYSCTL_ALTCLKCFG_MASK);
+
+    Latency_Init(SPECTRUM_CPU_FREQ);
+    LCD_Init();
+    LCD_ColorFill(SPECTRUM_SCREEN_COLOR);
+    LCD_SetTextColor(255, 255, 255);
+    LCD_SetCursor(0, 0);
+
+    SpectrumTask_Benchmark();
+
+    SpectrumView_t view;
+    SpectrumViewConfig_t config;
+    config.X = SPECTRUM_X;
+    config.Y = SPECTRUM_Y;
+    config.Height = SPECTRUM_HEIGHT;
+    config.NumBars = SPECTRUM_BARS;
+    config.BarWidth = SPECTRUM_BAR_WIDTH;
+    config.Gap = SPECTRUM_BAR_GAP;
+    config.Background = SPECTRUM_BACKGROUND_COLOR;
+    config.Bar = SPECTRUM_BAR_COLOR;
+    SpectrumView_Init(&view, &config);
+
+    FftPlan_t plan;
+    Fft_Init(&plan, SPECTRUM_POINTS);
+
+    FmtSink_t lcd;
+    Fmt_LcdSink(&lcd);
+
+    AdcStreamConfig_t stream;
+    stream.Channels[0] = SPECTRUM_INPUT;
+    stream.NumChannels = 1;
+    stream.RateHz = SPECTRUM_RATE_HZ;
+    stream.Buffers[0] = Buffers[0];
+    stream.Buffers[1] = Buffers[1];
+    stream.Length = SPECTRUM_POINTS;
+    stream.Callback = SpectrumTask_Capture;
+    stream.Arg = 0;
+    AdcStream_Init(&stream);
+    AdcStream_Start();
+
+    while (1) {
+        while (!BlockReady);
+
+        Fft_Window(&plan, Block, 1, Data);
+        BlockReady = RESET;
+        Fft_Transform(&plan, Data);
+        Fft_Magnitude(&plan, Data, Magnitude);
+
+        SpectrumView_Update(&view, Magnitude, SPECTRUM_POINTS / 2U);
+
+        // Strongest bin, without DC
+        uint16_t peak = 1;
+        for (uint16_t bin = 2; bin < SPECTRUM_POINTS / 2U; bin++) {
+            if (Magnitude[bin] > Magnitude[peak]) {
+                peak = bin;
+            }
+        }
+        LCD_SetCursor(0, SPECTRUM_Y - 10U);
+        Fmt_Str(&lcd, "Peak ");
+        Fmt_UInt(&lcd, peak * SPECTRUM_RATE_HZ / SPECTRUM_POINTS);
+        Fmt_Str(&lcd, " Hz    ");
+    }
+}
@@ -2,9 +2,9 @@
 #include "task1.h"
 
 
-// The ADC0 handler will request printing temperature
-static volatile uint8_t PrintRequested = RESET;
-static float temp = 0.0;
+// The ADC0 handler publishes each temperature (in centi-degrees Celsius) with its
+// reading number. The main loop prints every new one without masking interrupts
+static Snapshot_t TempSnapshot;
 
 /*  
  *  Contains a list of the ports where each LED D<i> is connected
@@ -30,25 +30,58 @@ volatile uint8_t num_leds = 0;
 volatile uint8_t SW2_pressed = RESET;
 volatile uint8_t SW1_pressed = RESET;
 
+// Temperature history and the chart that shows it
+static int32_t ChartSamples[CHART_WIDTH];
+static ChartHistory_t ChartHistory;
+static Chart_t Chart;
+static DspIir_t ChartFilter;
+
+void Task1_ChartInit(void) {
+    ChartConfig_t config;
+    config.X = CHART_X;
+    config.Y = CHART_Y;
+    config.Width = CHART_WIDTH;
+    config.Height = CHART_HEIGHT;
+    config.Min = CHART_MIN;
+    config.Max = CHART_MAX;
+    config.Background = CHART_BACKGROUND_COLOR;
+    config.Trace = CHART_TRACE_COLOR;
+    config.Frame = CHART_FRAME_COLOR;
+
+    Dsp_IirInit(&ChartFilter, CHART_SMOOTHING);
+    Chart_HistoryInit(&ChartHistory, ChartSamples, CHART_WIDTH, CHART_DECIMATION);
+    Chart_Init(&Chart, &config);
+}
+
+void Task1_ChartUpdate(int32_t celsius) {
+    int32_t sample;
+
+    // Only one column of the chart is drawn per decimated sample
+    if (Chart_HistoryAdd(&ChartHistory, Dsp_IirProcess(&ChartFilter, celsius), &sample)) {
+        Chart_Push(&Chart, sample);
+    }
+}
+
 void ADC0Sequence3_Handler(void) {
+    static uint32_t readings = 0;
+
     // Clear the IT Flag
     ADC_ClearIT(ADC0, ADC_ITReadPos_Sequencer3);
 
-    // take the sample and decode the temperature
-    temp = ADC_TO_CELCIUS(ADC_ReadValue(ADC0, ADC_FIFO3));
+    // take the sample and decode the temperature (in centi-degrees, no floating point)
+    int32_t celsius = Temp_AdcToCentiC(ADC_ReadValue(ADC0, ADC_FIFO3));
+    Snapshot_Publish(&TempSnapshot, celsius, readings++);
 
     // Decide on number of blinking LEDs value based on temperature
-    if (temp < 20.0) {
+    if (celsius < TEMP_CENTI(20)) {
         num_leds = 1U;
-    } else if(temp < 24.0) {
+    } else if(celsius < TEMP_CENTI(24)) {
         num_leds = 2U;
-    } else if(temp < 28.0) {
+    } else if(celsius < TEMP_CENTI(28)) {
         num_leds = 3U;
     } else {
         num_leds = 4U;
     }
-
-    PrintRequested = SET;
 }
 
 void Task1B(void) {
@@ -57,11 +90,14 @@ void Task1B(void) {
     // Start in slow mode (12MHz)
     TM_states_e present_state = TM_SLOW;
     TM_states_e next_state = TM_SLOW;
+    SnapshotSample_t reading;
+    uint32_t seen = 0;
     
     // Start the screen on cyan, text is white
     LCD_ColorFill(Color4[3]);
     LCD_SetCursor(0, 0);
     LCD_SetTextColor(255, 255, 255);
+    Task1_ChartInit();
 
     // Start the timers
     TIM_Command(TIM0, ENABLE, TIM_Port_Concatenated);
@@ -75,20 +111,20 @@ void Task1B(void) {
     while(1) {
         
         // Wait until a button is pressed or until we have to print
-        while (!SW1_pressed && !SW2_pressed && !PrintRequested);
+        while (!SW1_pressed && !SW2_pressed && !Snapshot_IsNew(&TempSnapshot, seen));
         
-        if (PrintRequested) {
-            PrintRequested = RESET;
+        // Consistent copy of the latest reading, interrupts stay enabled
+        if (Snapshot_Read(&TempSnapshot, &reading, &seen)) {
+            int32_t celsius = reading.Value;
 
-            // This should never be a problem since the ADC is triggered once per second
-            // But to be safe, make a critical section to avoid corruption of temp
+            // Temperatures are in centi-degrees, printed with two decimals
+            FmtSink_t lcd;
+            Fmt_LcdSink(&lcd);
             LCD_SetCursor(0, 0);
-            LCD_Printf("The current temperature is ");
-            __asm volatile("cpsid i\t\n");
-            LCD_PrintFloat(temp);
-            LCD_Printf(" C, ");
-            LCD_PrintFloat(CELCIUS_TO_FARENH(temp));
-            __asm volatile("cpsie i\t\n");
+            Fmt_Str(&lcd, "The current temperature is ");
+            Fmt_Fixed(&lcd, celsius, 2);
+            Fmt_Str(&lcd, " C, ");
+            Fmt_Fixed(&lcd, Temp_CentiCToCentiF(celsius), 2);
 
             if (present_state == TM_SLOW) {
                 // Extra space before 12 to normalize length of the string
@@ -96,6 +132,8 @@ void Task1B(void) {
             } else {
                 LCD_PrintString(" F\r\nThe current clock frequency is 120 MHz");
             }
+
+            Task1_ChartUpdate(celsius);
         }
 
         // decide on what will be the next state
@@ -130,12 +168,22 @@ void Task1B(void) {
     }
 }
 
+void Task1C_ButtonCallback(int8_t region, const TouchEvent_t *event, void *arg) {
+    (void) region;
+    // Register the press on the flag associated with the button
+    if (event->Type == TOUCH_EVENT_PRESS) {
+        *((volatile uint8_t *) arg) = SET;
+    }
+}
+
 void Task1C(void) {
     Task1C_Init();
 
     // Start in slow mode (12MHz)
     TM_states_e present_state = TM_SLOW;
     TM_states_e next_state = TM_SLOW;
+    SnapshotSample_t reading;
+    uint32_t seen = 0;
     
     // set the background to cyan, text is white
     LCD_ColorFill(Color4[3]);
@@ -151,6 +199,27 @@ void Task1C(void) {
     LCD_SetCursor(SLOW_LABEL_X, SLOW_LABEL_Y);
     LCD_PrintString("SLOW");
     LCD_SetCursor(0, 0);
+    Task1_ChartInit();
+
+    // Register the buttons with the touch dispatcher
+    // The FAST button acts as SW2 and the SLOW button acts as SW1
+    TouchRegion_t button;
+    button.Callback = Task1C_ButtonCallback;
+
+    button.Left = FAST_LEFT_LIMIT;
+    button.Right = FAST_RIGHT_LIMIT;
+    button.Bottom = FAST_BOT_LIMIT;
+    button.Top = FAST_TOP_LIMIT;
+    button.Arg = (void *) &SW2_pressed;
+    TouchDispatch_Reset();
+    TouchDispatch_Register(&button);
+
+    button.Left = SLOW_LEFT_LIMIT;
+    button.Right = SLOW_RIGHT_LIMIT;
+    button.Bottom = SLOW_BOT_LIMIT;
+    button.Top = SLOW_TOP_LIMIT;
+    button.Arg = (void *) &SW1_pressed;
+    TouchDispatch_Register(&button);
 
     // Start the timers
     TIM_Command(TIM0, ENABLE, TIM_Port_Concatenated);
@@ -163,33 +232,23 @@ void Task1C(void) {
     while(1) {
         
         // Wait until a button is pressed or until we have to print
-        while (!SW1_pressed && !SW2_pressed && !PrintRequested) {
-            unsigned long x = Touch_ReadX();
-            unsigned long y = Touch_ReadY();
-
-            if(FAST_LEFT_LIMIT < x && x < FAST_RIGHT_LIMIT && 
-                FAST_BOT_LIMIT < y && y < FAST_TOP_LIMIT) {
-                SW2_pressed = SET;
-            }
-
-            if(SLOW_LEFT_LIMIT < x && x < SLOW_RIGHT_LIMIT && 
-                SLOW_BOT_LIMIT < y && y < SLOW_TOP_LIMIT) {
-                SW1_pressed = SET;
-            }
+        // The dispatcher calls Task1C_ButtonCallback() when a button is pressed
+        while (!SW1_pressed && !SW2_pressed && !Snapshot_IsNew(&TempSnapshot, seen)) {
+            TouchDispatch_Poll(Timebase_Millis());
         }
         
-        if (PrintRequested) {
-            PrintRequested = RESET;
+        // Consistent copy of the latest reading, interrupts stay enabled
+        if (Snapshot_Read(&TempSnapshot, &reading, &seen)) {
+            int32_t celsius = reading.Value;
 
-            // This should never be a problem since the ADC is triggered once per second
-            // But to be safe, make a critical section to avoid corruption of temp
+            // Temperatures are in centi-degrees, printed with two decimals
+            FmtSink_t lcd;
+            Fmt_LcdSink(&lcd);
             LCD_SetCursor(0, 0);
-            LCD_Printf("The current temperature is ");
-            __asm volatile("cpsid i\t\n");
-            LCD_PrintFloat(temp);
-            LCD_Printf(" C, ");
-            LCD_PrintFloat(CELCIUS_TO_FARENH(temp));
-            __asm volatile("cpsie i\t\n");
+            Fmt_Str(&lcd, "The current temperature is ");
+            Fmt_Fixed(&lcd, celsius, 2);
+            Fmt_Str(&lcd, " C, ");
+            Fmt_Fixed(&lcd, Temp_CentiCToCentiF(celsius), 2);
 
             if (present_state == TM_SLOW) {
                 // Extra space before 12 to normalize length of the string
@@ -197,6 +256,8 @@ void Task1C(void) {
             } else {
                 LCD_PrintString(" F\r\nThe current clock frequency is 120 MHz");
             }
+
+            Task1_ChartUpdate(celsius);
         }
 
         // decide on what will be the next state
@@ -400,6 +461,9 @@ void Task1C_Init(void) {
     ADC_Init();
     LCD_Init();
     Touch_Init();
+
+    // Millisecond time of the touch events, from PIOSC like the timers
+    Timebase_Init();
 }
 
 void Timer1A_Handler(void) {
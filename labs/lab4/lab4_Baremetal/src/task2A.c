@@ -2,16 +2,119 @@
 #include "tm4c1294ncpdt.h"
 #include "SSD2119_Display.h"
 #include "SSD2119_Touch.h"
+#include "timebase.h"
+#include "latency.h"
+#include "console.h"
 #include "task2.h"
 
+#include <stddef.h>
+
+// Timings of the lights, in seconds
+static uint32_t TransitionTimeout = TRANSITION_TIMEOUT_IN_S;
+static uint32_t ButtonPress = BUTTON_PRESS_IN_S;
+
+// Number of changes of the lights
+static uint32_t Transitions = 0;
+
+// Log statements, compiled out without USE_LOG
+#if (USE_LOG)
+#define TASK2A_LOG(...)     LOG(__VA_ARGS__)
+
+// Sent as addresses: the host reads the names from the ELF file too
+static const char *const StateNames[] = { "IDLE", "STOP", "GO", "WARN" };
+#else
+#define TASK2A_LOG(...)
+#endif
+
+// Ring buffers of UART0, so that nothing in the loop waits on it
+static uint8_t Uart0Tx[UART0_TX_SIZE];
+static uint8_t Uart0Rx[UART0_RX_SIZE];
+
+// Latency report, formatted once per trace. The uDMA reads it until UART_DmaBusy() clears
+static char LatencyReport[LATENCY_REPORT_SIZE];
+
+#if (USE_SHELL)
+static Shell_t Shell;
+
+static int32_t Task2A_GetTransitionTimeout(void) {
+    return (int32_t) TransitionTimeout;
+}
+
+// Applies from the next change of the lights
+static int Task2A_SetTransitionTimeout(int32_t seconds) {
+    TransitionTimeout = (uint32_t) seconds;
+    return 1;
+}
+
+static int32_t Task2A_GetButtonPress(void) {
+    return (int32_t) ButtonPress;
+}
+
+static int Task2A_SetButtonPress(int32_t seconds) {
+    ButtonPress = (uint32_t) seconds;
+    TouchDispatch_SetLongPress(SEC_TO_MS(ButtonPress));
+    TouchDispatch_SetRepeat(SEC_TO_MS(ButtonPress));
+    return 1;
+}
+
+static int32_t Task2A_GetTransitions(void) {
+    return (int32_t) Transitions;
+}
+
+static const ShellVar_t ShellVars[] = {
+    { "transition_s", "Time of each light, s", Task2A_GetTransitionTimeout, Task2A_SetTransitionTimeout, 1, 60, 0 },
+    { "button_s", "Hold time of the buttons, s", Task2A_GetButtonPress, Task2A_SetButtonPress, 1, 10, 0 },
+    { "transitions", "Changes of the lights", Task2A_GetTransitions, NULL, 0, 0, 0 },
+};
+#endif
+
+// Starts the shell on UART0 (USE_SHELL)
+static void Task2A_ShellInit(void) {
+    #if (USE_SHELL)
+    ShellConfig_t config;
+    config.Port = UART_PORT_0;
+    config.Commands = NULL;
+    config.NumCommands = 0;
+    config.Vars = ShellVars;
+    config.NumVars = sizeof(ShellVars) / sizeof(ShellVars[0]);
+    Shell_Init(&Shell, &config);
+    #endif
+}
+
+static void Task2A_ShellPoll(void) {
+    #if (USE_SHELL)
+    Shell_Poll(&Shell);
+    #endif
+}
+
+#if (USE_LOG)
+// Log_Drain() sizes the frames to the room left, so they always fit
+static void Task2A_LogWrite(const uint8_t *data, uint16_t len, void *arg) {
+    (void) arg;
+    UART_Write(UART_PORT_0, data, len);
+}
+#endif
+
+// Starts the deferred log on UART0 (USE_LOG)
+static void Task2A_LogInit(void) {
+    #if (USE_LOG)
+    Log_Init(Task2A_LogWrite, NULL);
+    LOG("traffic light: %u s per light, %u s presses", TransitionTimeout, ButtonPress);
+    #endif
+}
+
+// Sends what the loop has logged, as much as UART0 can take without waiting
+static void Task2A_LogDrain(void) {
+    #if (USE_LOG)
+    Log_Drain(UART_TxSpace(UART_PORT_0));
+    #endif
+}
 
 void Task2A_Timers_Init(void) {
-    // Enable the clock of the timers utilized in this task
-    TIM_PeriphClockCtrlByMask(PEDESTRIAN_BUTTON_TIMER_MASK, ENABLE);
-    TIM_PeriphClockCtrlByMask(START_STOP_BUTTON_TIMER_MASK, ENABLE);
+    // Enable the clock of the timer utilized in this task
     TIM_PeriphClockCtrlByMask(TRANSITION_TIMER_MASK, ENABLE);
 
-    // Configure as periodic down counters
+    // Configure as a periodic down counter
     TIM_Init_t timers;
     timers.PeriodicModeCommand = ENABLE;
     timers.TIM_CompareAction = TIM_CompareAction_Disable;
@@ -19,37 +122,45 @@ void Task2A_Timers_Init(void) {
     timers.TIM_SnapshotCommand = DISABLE;
     timers.TIM_WaitOnTriggerCommand = DISABLE;
 
-    // wait until these are ready to be accessed
-    while(!(SYSCTL_PRTIMER_READ(PEDESTRIAN_BUTTON_TIMER_POS)));
-    while(!(SYSCTL_PRTIMER_READ(START_STOP_BUTTON_TIMER_POS)));
+    // wait until it is ready to be accessed
     while(!(SYSCTL_PRTIMER_READ(TRANSITION_TIMER_POS)));
 
-    TIM_ConfigAltClk(PEDESTRIAN_BUTTON_TIMER, ENABLE);
-    TIM_ConfigAltClk(START_STOP_BUTTON_TIMER, ENABLE);
     TIM_ConfigAltClk(TRANSITION_TIMER, ENABLE);
-
-    TIM_Init(PEDESTRIAN_BUTTON_TIMER, &timers, TIM_Port_Concatenated);
     TIM_Init(TRANSITION_TIMER, &timers, TIM_Port_Concatenated);
-    TIM_Init(START_STOP_BUTTON_TIMER, &timers, TIM_Port_Concatenated);
-
-    // the buttons must be pressed for two seconds for the system to register 
-    // the press
-    TIM_ConfigIntervalConc(PEDESTRIAN_BUTTON_TIMER, SECONDS_TO_COUNT(BUTTON_PRESS_IN_S, OSCILLATOR_FREQ));
-    TIM_ConfigIntervalConc(START_STOP_BUTTON_TIMER, SECONDS_TO_COUNT(BUTTON_PRESS_IN_S, OSCILLATOR_FREQ));
 
     // A transition normally occurs every 5 seconds
-    TIM_ConfigIntervalConc(TRANSITION_TIMER, SECONDS_TO_COUNT(TRANSITION_TIMEOUT_IN_S, OSCILLATOR_FREQ));
+    TIM_ConfigIntervalConc(TRANSITION_TIMER, SECONDS_TO_COUNT(TransitionTimeout, OSCILLATOR_FREQ));
 
     // Clear any previous events
-    TIM_ClearITAll(PEDESTRIAN_BUTTON_TIMER);
-    TIM_ClearITAll(START_STOP_BUTTON_TIMER);
     TIM_ClearITAll(TRANSITION_TIMER);
 }
 
+void Task2A_ButtonCallback(int8_t region, const TouchEvent_t *event, void *arg) {
+    (void) region;
+    // The input is registered once the button has been held for 2 seconds, and again
+    // every 2 seconds while it stays held
+    if (event->Type == TOUCH_EVENT_LONG_PRESS || event->Type == TOUCH_EVENT_REPEAT) {
+        *((uint8_t *) arg) = SET;
+        Latency_Mark(LATENCY_STAGE_DISPATCH);
+        TASK2A_LOG("button %d held at (%u, %u)", region, event->X, event->Y);
+    }
+}
+
 void Task2A_Init(void) {
     SYSCTL_ALTCLKCFG &= ~(SYSCTL_ALTCLKCFG_MASK);
     Task2A_Timers_Init();
 
+    // Millisecond time used by the touch dispatcher to detect 2-second presses
+    Timebase_Init();
+
+    // Touch-to-photon latency, timestamped with the CPU cycle counter and reported on
+    // UART0, which the shell or the log share
+    Latency_Init(OSCILLATOR_FREQ);
+    Console_Init();
+    Console_RingInit(Uart0Tx, UART0_TX_SIZE, Uart0Rx, UART0_RX_SIZE);
+    Task2A_ShellInit();
+    Task2A_LogInit();
+
     LCD_Init();
     Touch_Init();
 }
@@ -60,17 +171,9 @@ void Task2A(void) {
     TL_states_e present_state = IDLE;
     TL_states_e next_state = IDLE;  
 
-    // Software will keep track of the previous and new values to detect rising edges
-    // But must only register inputs after a 2-second press, thus the 'tmp' suffix-ed variables
-    // represent a button press that hasn't been held for 2 seconds yet
-    uint8_t startStop_prev = RESET;
-    uint8_t startSTop_new = RESET;
-    uint8_t startStop_tmp = RESET;
+    // Inputs are only registered after a 2-second press. The touch dispatcher
+    // times the presses and sets these flags through Task2A_ButtonCallback()
     uint8_t startStop_pressed = RESET;
-
-    uint8_t pedestrian_prev = RESET;
-    uint8_t pedestrian_new = RESET;
-    uint8_t pedestrian_tmp = RESET;
     uint8_t pedestrian_pressed = RESET;
 
     uint8_t transition_requested = RESET;
@@ -82,10 +185,6 @@ void Task2A(void) {
     GreenLightOn = RESET;
     YellowLightOn = RESET;
 
-    // x and y coordinates of a touch
-    static unsigned long x = 0;
-    static unsigned long y = 0;
-
     // Draw initial state of the screen
     LCD_ColorFill(BACKGROUND_COLOR);
     LCD_SetTextColor(255, 255, 255);
@@ -102,73 +201,36 @@ void Task2A(void) {
     LCD_PrintString("Pedestrian");
     LCD_SetCursor(0, 0);
 
+    // Register the buttons with the touch dispatcher
+    TouchRegion_t button;
+    button.Callback = Task2A_ButtonCallback;
+
+    button.Left = START_STOP_LEFT_LIMIT;
+    button.Right = START_STOP_RIGHT_LIMIT;
+    button.Bottom = START_STOP_BOTTOM_LIMIT;
+    button.Top = START_STOP_TOP_LIMIT;
+    button.Arg = &startStop_pressed;
+    TouchDispatch_SetLongPress(SEC_TO_MS(ButtonPress));
+    TouchDispatch_SetRepeat(SEC_TO_MS(ButtonPress));
+    TouchDispatch_Reset();
+    TouchDispatch_Register(&button);
+
+    button.Left = PED_LEFT_LIMIT;
+    button.Right = PED_RIGHT_LIMIT;
+    button.Bottom = PED_BOT_LIMIT;
+    button.Top = PED_TOP_LIMIT;
+    button.Arg = &pedestrian_pressed;
+    TouchDispatch_Register(&button);
+
     // Start the timer
     TIM_Command(TRANSITION_TIMER, ENABLE, TIM_Port_Concatenated);
 
     while (1) {
-        // Read the buttons
-        x = Touch_ReadX();
-        y = Touch_ReadY();
-
-        // Check if any of the buttons is being pressed
-        if (START_STOP_LEFT_LIMIT < x  && x < START_STOP_RIGHT_LIMIT && 
-           START_STOP_BOTTOM_LIMIT < y && y < START_STOP_TOP_LIMIT) {
-            startSTop_new = SET;
-        } else {
-            startSTop_new = RESET;
-        }
-
-        if (PED_LEFT_LIMIT < x && x < PED_RIGHT_LIMIT && 
-            PED_BOT_LIMIT < y && y < PED_TOP_LIMIT)     {
-            pedestrian_new = SET;
-        } else {
-            pedestrian_new = RESET;
-        }
-
-        // Check for rising edges
-        if (!startStop_prev && startSTop_new) {
-            startStop_tmp = SET;
-        } else if(startStop_prev && !startSTop_new) {
-            startStop_tmp = RESET;
-        }
-
-        if (!pedestrian_prev && pedestrian_new) {
-            pedestrian_tmp = SET; 
-        } else if (pedestrian_prev && !pedestrian_new) {
-            pedestrian_tmp = RESET;
-        }
-
-        // start counting if the button gets pressed, and restart the count if the button is not pressed
-        // for 2-seconds straight
-        if (pedestrian_tmp && !TIM_ReadCounterStatus(PEDESTRIAN_BUTTON_TIMER, TIM_Port_Concatenated)) {
-            TIM_Command(PEDESTRIAN_BUTTON_TIMER, ENABLE, TIM_Port_Concatenated);
-        } else if (!pedestrian_tmp) {
-            TIM_Command(PEDESTRIAN_BUTTON_TIMER, DISABLE, TIM_Port_Concatenated);
-            TIM_LoadCountConc(PEDESTRIAN_BUTTON_TIMER, SECONDS_TO_COUNT(BUTTON_PRESS_IN_S, OSCILLATOR_FREQ));
-        }
-
-        // Exactly as above
-        if (startStop_tmp && !TIM_ReadCounterStatus(START_STOP_BUTTON_TIMER, TIM_Port_Concatenated)) {
-            TIM_Command(START_STOP_BUTTON_TIMER, ENABLE, TIM_Port_Concatenated);
-        } else if (!startStop_tmp) {
-            TIM_Command(START_STOP_BUTTON_TIMER, DISABLE, TIM_Port_Concatenated);
-            TIM_LoadCountConc(START_STOP_BUTTON_TIMER, SECONDS_TO_COUNT(BUTTON_PRESS_IN_S, OSCILLATOR_FREQ));
-        }
-
-        // If a timer has expired, register the input
-        if (TIM_ReadRawITStatus(PEDESTRIAN_BUTTON_TIMER, TIM_ITReadPos_TimeoutA)) {
-            pedestrian_pressed = SET;
-            TIM_Command(PEDESTRIAN_BUTTON_TIMER, DISABLE, TIM_Port_Concatenated);
-            TIM_ClearIT(PEDESTRIAN_BUTTON_TIMER, TIM_ITReadPos_TimeoutA);
-            TIM_LoadCountConc(PEDESTRIAN_BUTTON_TIMER, SECONDS_TO_COUNT(BUTTON_PRESS_IN_S, OSCILLATOR_FREQ));
-        }
-
-        if (TIM_ReadRawITStatus(START_STOP_BUTTON_TIMER, TIM_ITReadPos_TimeoutA)) {
-            startStop_pressed = SET;
-            TIM_Command(START_STOP_BUTTON_TIMER, DISABLE, TIM_Port_Concatenated);
-            TIM_ClearIT(START_STOP_BUTTON_TIMER, TIM_ITReadPos_TimeoutA);
-            TIM_LoadCountConc(START_STOP_BUTTON_TIMER, SECONDS_TO_COUNT(BUTTON_PRESS_IN_S, OSCILLATOR_FREQ));
-        }
+        // Read the buttons, the dispatcher registers the 2-second presses
+        Latency_Mark(LATENCY_STAGE_TOUCH);
+        TouchDispatch_Poll(Timebase_Millis());
+        Task2A_ShellPoll();
+        Task2A_LogDrain();
 
         // next-state logic
         switch (present_state) {
@@ -286,25 +348,32 @@ void Task2A(void) {
                 break;
         }
 
+        // The screen now shows the state chosen by the last input: report the latencies
+        // unless the previous report is still going out, the next one includes this trace
+        // then (UART0 carries the log instead with USE_LOG)
+        if (Latency_Mark(LATENCY_STAGE_PHOTON) && !USE_LOG && !UART_DmaBusy(UART_PORT_0)) {
+            UartSegment_t report;
+            report.Data = (const uint8_t *) LatencyReport;
+            report.Length = Latency_Format(LatencyReport, LATENCY_REPORT_SIZE);
+            if (report.Length) {
+                UART_WriteDma(UART_PORT_0, &report, 1, NULL, NULL);
+            }
+        }
+
         // trigger a transition if the transition timer has expired
         transition_requested = TIM_ReadRawITStatus(TRANSITION_TIMER, TIM_ITReadPos_TimeoutA) ? SET : transition_requested;
         if (transition_requested) {
+            Latency_Mark(LATENCY_STAGE_FSM);
+            TASK2A_LOG("%s -> %s, %s", StateNames[present_state], StateNames[next_state],
+                       startStop_pressed ? "start/stop" : pedestrian_pressed ? "pedestrian" : "timer");
             present_state = next_state;
             transition_requested = RESET;
             pedestrian_pressed = RESET;
             startStop_pressed = RESET;
 
             TIM_ClearIT(TRANSITION_TIMER, TIM_ITReadPos_TimeoutA);
-            TIM_ClearIT(PEDESTRIAN_BUTTON_TIMER, TIM_ITReadPos_TimeoutA);
-            TIM_ClearIT(START_STOP_BUTTON_TIMER, TIM_ITReadPos_TimeoutA);
-
-            // restart the pedestrian count too, or else input would be ambigous
-            TIM_LoadCountConc(PEDESTRIAN_BUTTON_TIMER, SECONDS_TO_COUNT(BUTTON_PRESS_IN_S, OSCILLATOR_FREQ));
-            TIM_LoadCountConc(TRANSITION_TIMER, SECONDS_TO_COUNT(TRANSITION_TIMEOUT_IN_S, OSCILLATOR_FREQ));
+            TIM_LoadCountConc(TRANSITION_TIMER, SECONDS_TO_COUNT(TransitionTimeout, OSCILLATOR_FREQ));
+            Transitions++;
         }
-
-        // update data
-        startStop_prev = startSTop_new;
-        pedestrian_prev = pedestrian_new;
     }
 }
\ No newline at end of file
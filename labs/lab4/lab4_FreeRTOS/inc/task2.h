@@ -68,9 +68,39 @@ typedef enum {
 #define PED_LABEL_X                     195
 #define PED_LABEL_Y                     90
 
+// Initial timings, the shell (USE_SHELL) can change them at run time
 #define BUTTON_PRESS_IN_S               2UL
 #define TRANSITION_TIMEOUT_IN_S         5UL
 
+// Number of touch events each button task can have pending
+#define TOUCH_QUEUE_LENGTH              4U
+
+// Set to 1 to stream the state of the traffic light on UART0 as binary telemetry (live
+// watch), in place of the latency report. Plot it with tools/watch_plot.py -s main.c
+#define USE_WATCH                       0U
+
+// Live watch: period of a round in ticks (ms), full round every WATCH_KEYFRAME rounds
+// (the others only send what changed), and variables read per tick at most
+#define WATCH_PERIOD_MS                 50U
+#define WATCH_KEYFRAME                  20U
+#define WATCH_MAX_PER_POLL              4U
+
+// Set to 1 to run a command shell on UART0, to change the timings without reflashing
+// ("help" lists the commands). The latency report still goes out through the console
+#define USE_SHELL                       0U
+
+#if (USE_WATCH && USE_SHELL)
+#error "USE_WATCH and USE_SHELL both need UART0"
+#endif
+
+// Ring buffers of UART0, for the shell or the live watch (powers of two)
+#define UART0_TX_SIZE                   1024U
+#define UART0_RX_SIZE                   64U
+
+// Longest latency report: about 40 bytes per stage plus 15 per non-empty bucket. The
+// report goes out through the uDMA straight from its buffer, and a longer one is skipped
+#define LATENCY_REPORT_SIZE             512U
+
 
 // Radius of buttons and lights
 #define RADIUS                          20
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+
+#include "SSD2119_Touch.h"
+#include "touch_dispatch.h"
+#include "latency.h"
+
+// The touch service samples the panel at the scan rate of the touch profile
+#define TOUCH_SERVICE_PRIORITY              (tskIDLE_PRIORITY + 1U)
+#define TOUCH_SERVICE_STACK_SIZE            256U
+
+// Maximum number of (region, queue) subscriptions
+#define TOUCH_SERVICE_MAX_SUBSCRIBERS       8U
+
+// Item published to the subscriber queues
+typedef struct {
+    int8_t Region;
+    TouchEvent_t Event;
+} TouchServiceEvent_t;
+
+/**
+  * @brief  Registers a region with the touch dispatcher and subscribes a queue 
+  *         to its events. Must be called before the scheduler starts
+  * @param  region: Limits of the region (the callback fields are ignored)
+  * @param  queue: Queue of TouchServiceEvent_t items that receives the events
+  * @retval Id of the region, or TOUCH_NO_REGION if it could not be registered
+  */
+int8_t TouchService_Register(const TouchRegion_t *region, QueueHandle_t queue);
+
+/**
+  * @brief  Subscribes an additional queue to the events of an already registered region
+  * @param  region: Id returned by TouchService_Register()
+  * @param  queue: Queue of TouchServiceEvent_t items that receives the events
+  * @retval 1 if subscribed, -1 if the subscription table is full
+  */
+int TouchService_Subscribe(int8_t region, QueueHandle_t queue);
+
+/**
+  * @brief  Sets the hold time (ms) of the long-press events
+  * @retval None
+  */
+void TouchService_SetLongPress(uint32_t ms);
+
+/**
+  * @brief  Sets the period (ms) of the repeat events of a held long-press, 0 for none
+  * @retval None
+  */
+void TouchService_SetRepeat(uint32_t ms);
+
+/**
+  * @brief  Creates the touch service task
+  * @retval 1 if the task was created, -1 otherwise
+  */
+int TouchService_Start(void);
+
+/**
+  * @brief  Task function of the touch service. It is the only code that touches 
+  *         the panel: it samples it every Touch_GetScanPeriod() ms, runs the touch 
+  *         dispatcher and publishes the events to the subscribed queues
+  * @retval None
+  */
+void TouchService(void *p);
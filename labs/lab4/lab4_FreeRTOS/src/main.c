@@ -1,17 +1,36 @@
-
 #include "FreeRTOS.h"
 #include "task.h"
+#include "queue.h"
 
 // SSD2119 Display and Touch Drivers
 #include "SSD2119_Display.h"
 #include "SSD2119_Touch.h"
 
+// Task that owns the touch panel and publishes touch events
+#include "touch_service.h"
+
+// Touch-to-photon latency instrumentation, reported through UART0
+#include "latency.h"
+#include "console.h"
+#include "uart_ring.h"
+
+// Command shell on UART0, to change the timings at run time (USE_SHELL)
+#include "shell.h"
+
+// Live watch of the variables below, streamed through UART0 (USE_WATCH)
+#include "telemetry.h"
+#include "watch.h"
+
 // header file specific to task 2
 #include "task2.h"
 
 #define SET         1U 
 #define RESET       0U
 
+// Timings of the lights, in seconds
+static uint32_t transition_timeout = TRANSITION_TIMEOUT_IN_S;
+static uint32_t button_press = BUTTON_PRESS_IN_S;
+
 // Flags for the buttons and the timer
 int pedestrian_pressed = RESET;
 int onoff_pressed = RESET;
@@ -22,29 +41,94 @@ int time_expired = RESET;
 static int curr_light_tick_time = 0;
 static int prev_light_tick_time = 0;
 
-// ped_tick global because FSM() needs to reset this timer to ensure that
-// the pedestrian button be pressed for two seconds during GO before going to WARN
-static int curr_ped_tick_time = 0;
-static int prev_ped_tick_time = 0;
-
 // Since drawing circles on the screen is time-consuming, we'll keep track of the light states
 // so that we don't draw on an already drawn spot
 uint8_t GreenLightOn = RESET;
 uint8_t YellowLightOn = RESET;
 uint8_t RedLightOn = RESET;
 
-// Task function that checks the state of the virtual pedestrian button.
-// Keeps track of how many seconds the pedestrian button has been pressed.
-// Once the user has pressed the virtual pedestrian button for 2 seconds,
-// it will set the global flag indicating the virtual pedestrian button
-// has been pressed.
+// State of the FSM, at file scope so that the live watch can read it
+static TL_states_e present_state = IDLE;
+
+// Ring buffers of UART0, so that no task waits on it
+static uint8_t uart0_tx[UART0_TX_SIZE];
+static uint8_t uart0_rx[UART0_RX_SIZE];
+
+// Latency report, formatted once per trace. The uDMA reads it until UART_DmaBusy() clears
+static char latency_report[LATENCY_REPORT_SIZE];
+
+#if (USE_WATCH)
+// Variables streamed by the live watch, one telemetry channel each in this order
+static const WatchVar_t watch_vars[] = {
+  WATCH_VAR(present_state, WATCH_SIGNED),
+  WATCH_VAR(onoff_pressed, WATCH_SIGNED),
+  WATCH_VAR(pedestrian_pressed, WATCH_SIGNED),
+  WATCH_VAR(time_expired, WATCH_SIGNED),
+  WATCH_VAR(RedLightOn, WATCH_UNSIGNED),
+  WATCH_VAR(YellowLightOn, WATCH_UNSIGNED),
+  WATCH_VAR(GreenLightOn, WATCH_UNSIGNED),
+  WATCH_VAR(curr_light_tick_time, WATCH_SIGNED),
+  WATCH_VAR(prev_light_tick_time, WATCH_SIGNED),
+};
+
+static Telemetry_t telemetry;
+static Watch_t watch;
+
+// Queues a frame on UART0 whole, or drops it if the ring is too full
+static void WatchWrite(const uint8_t *data, uint16_t len, void *arg) {
+  (void) arg;
+  if (UART_TxSpace(UART_PORT_0) >= len) {
+    UART_Write(UART_PORT_0, data, len);
+  }
+}
+#endif
+
+#if (USE_SHELL)
+static Shell_t shell;
+
+static int32_t GetTransitionTimeout(void) {
+  return (int32_t) transition_timeout;
+}
+
+// Control() compares the time of the light with it every tick, so it applies at once
+static int SetTransitionTimeout(int32_t seconds) {
+  transition_timeout = (uint32_t) seconds;
+  return 1;
+}
+
+static int32_t GetButtonPress(void) {
+  return (int32_t) button_press;
+}
+
+static int SetButtonPress(int32_t seconds) {
+  button_press = (uint32_t) seconds;
+  TouchService_SetLongPress(SEC_TO_MS(button_press));
+  TouchService_SetRepeat(SEC_TO_MS(button_press));
+  return 1;
+}
+
+static const ShellVar_t shell_vars[] = {
+  { "transition_s", "Time of each light, s", GetTransitionTimeout, SetTransitionTimeout, 1, 60, 0 },
+  { "button_s", "Hold time of the buttons, s", GetButtonPress, SetButtonPress, 1, 10, 0 },
+};
+#endif
+
+// Queues where the touch service publishes the events of each virtual button
+static QueueHandle_t start_stop_queue = NULL;
+static QueueHandle_t ped_queue = NULL;
+
+// Task function that waits for events of the virtual pedestrian button.
+// Blocks on its queue until the touch service reports that the button
+// has been held for 2 seconds (and every 2 seconds after that while it
+// stays held), and then sets the global flag indicating the virtual
+// pedestrian button has been pressed.
 void Pedestrian(void *p);
 
-// Task function that checks the state of the virtual onoff button.
-// Keeps track of how many seconds the onoff button has been pressed.
-// Once the user has pressed the onoff button for 2 seconds,
-// it will set the global flag indicating the onoff button has been
-// pressed
+// Task function that waits for events of the virtual onoff button.
+// Blocks on its queue until the touch service reports that the button
+// has been held for 2 seconds (and every 2 seconds after that while it
+// stays held), and then sets the global flag indicating the onoff button
+// has been pressed
 void StartStop(void *p);
 
 // Task function that represents your Finite State Machine.
@@ -57,6 +141,15 @@ void Control(void *p);
 // Handles the traffic light state transition.
 void FSM(void);
 
+// Task function that runs the live watch (USE_WATCH). Samples a few
+// of the watched variables every tick, and queues a telemetry frame
+// on UART0 at the end of each round
+void Watch(void *p);
+
+// Task function that runs the command shell (USE_SHELL). Handles the
+// characters received on UART0 every tick
+void CommandShell(void *p);
+
 void vApplicationStackOverflowHook(TaskHandle_t xTask, char *pcTaskName) {
   while (1) {}
 }
@@ -66,6 +159,34 @@ int main(void) {
   // functionalities of the SSD2119 touch display assembly.
   LCD_Init();
   Touch_Init();
+  Latency_Init(OSCILLATOR_FREQ);
+  Console_Init();
+  Console_RingInit(uart0_tx, UART0_TX_SIZE, uart0_rx, UART0_RX_SIZE);
+
+#if (USE_WATCH)
+  Telemetry_Init(&telemetry, WatchWrite, NULL);
+
+  WatchConfig_t config;
+  config.Telemetry = &telemetry;
+  config.Vars = watch_vars;
+  config.NumVars = sizeof(watch_vars) / sizeof(watch_vars[0]);
+  config.FirstChannel = 0;
+  config.Period = WATCH_PERIOD_MS;
+  config.OnChange = 1;
+  config.Keyframe = WATCH_KEYFRAME;
+  config.MaxPerPoll = WATCH_MAX_PER_POLL;
+  Watch_Init(&watch, &config, 0);
+#endif
+
+#if (USE_SHELL)
+  ShellConfig_t shell_config;
+  shell_config.Port = UART_PORT_0;
+  shell_config.Commands = NULL;
+  shell_config.NumCommands = 0;
+  shell_config.Vars = shell_vars;
+  shell_config.NumVars = sizeof(shell_vars) / sizeof(shell_vars[0]);
+  Shell_Init(&shell, &shell_config);
+#endif
 
   // Draw initial state of the screen
   LCD_ColorFill(BACKGROUND_COLOR);
@@ -83,9 +204,38 @@ int main(void) {
   LCD_PrintString("Pedestrian");
   LCD_SetCursor(0, 0);
 
+  // Each button task gets its own queue of touch events
+  start_stop_queue = xQueueCreate(TOUCH_QUEUE_LENGTH, sizeof(TouchServiceEvent_t));
+  ped_queue = xQueueCreate(TOUCH_QUEUE_LENGTH, sizeof(TouchServiceEvent_t));
+
+  // A button press is only registered after holding it for button_press seconds,
+  // and again every button_press seconds while it stays held
+  TouchService_SetLongPress(SEC_TO_MS(button_press));
+  TouchService_SetRepeat(SEC_TO_MS(button_press));
+
+  TouchRegion_t button;
+  button.Left = START_STOP_LEFT_LIMIT;
+  button.Right = START_STOP_RIGHT_LIMIT;
+  button.Bottom = START_STOP_BOTTOM_LIMIT;
+  button.Top = START_STOP_TOP_LIMIT;
+  TouchService_Register(&button, start_stop_queue);
+
+  button.Left = PED_LEFT_LIMIT;
+  button.Right = PED_RIGHT_LIMIT;
+  button.Bottom = PED_BOT_LIMIT;
+  button.Top = PED_TOP_LIMIT;
+  TouchService_Register(&button, ped_queue);
+
+  TouchService_Start();
   xTaskCreate(StartStop, (const char *)"StartStopButton", 1024, NULL, 0U, NULL);
   xTaskCreate(Pedestrian, (const char *)"PedestrianButton", 1024, NULL, 0U, NULL);
   xTaskCreate(Control, (const char *)"Control FSM", 1024, NULL, 0U, NULL);
+#if (USE_WATCH)
+  xTaskCreate(Watch, (const char *)"Live watch", 256, NULL, 0U, NULL);
+#endif
+#if (USE_SHELL)
+  xTaskCreate(CommandShell, (const char *)"Shell", 256, NULL, 0U, NULL);
+#endif
 
   vTaskStartScheduler();
 
@@ -93,71 +243,32 @@ int main(void) {
 }
 
 void StartStop(void *p) {
-  // keep track of time
-  static int curr_onoff_tick_time = 0;
-  static int prev_onoff_tick_time = 0;
-  curr_onoff_tick_time = xTaskGetTickCount();
-  prev_onoff_tick_time = curr_onoff_tick_time;
-
-  // coordinates of a touch
-  unsigned long x = 0;
-  unsigned long y = 0;
+  TouchServiceEvent_t touch;
+
   while (1) {
-    curr_onoff_tick_time = xTaskGetTickCount();
-
-    // Check whether the virtual button is pressed
-    x = Touch_ReadX();
-    y = Touch_ReadY();
-    if ((START_STOP_LEFT_LIMIT < x && x < START_STOP_RIGHT_LIMIT && 
-         START_STOP_BOTTOM_LIMIT < y && y < START_STOP_TOP_LIMIT)) { 
-      if (curr_onoff_tick_time - prev_onoff_tick_time >= SEC_TO_MS(BUTTON_PRESS_IN_S)) {
-        // register the input
-        onoff_pressed = SET;
-        prev_onoff_tick_time = curr_onoff_tick_time;
-      }
-      else {
-        onoff_pressed = RESET;
-      }
-    } else {
-      onoff_pressed = RESET;
-      prev_onoff_tick_time = curr_onoff_tick_time;
-    }
+    // Sleep until the touch service has something for this button
+    xQueueReceive(start_stop_queue, &touch, portMAX_DELAY);
 
-    vTaskDelay(1);
+    // register the input, Control() clears it once consumed
+    if (touch.Event.Type == TOUCH_EVENT_LONG_PRESS || touch.Event.Type == TOUCH_EVENT_REPEAT) {
+      onoff_pressed = SET;
+      Latency_Mark(LATENCY_STAGE_DISPATCH);
+    }
   }
 }
 
 void Pedestrian(void *p) {
-  curr_ped_tick_time = xTaskGetTickCount();
-  prev_ped_tick_time = curr_ped_tick_time;
-
-  // coordinates of a touch
-  unsigned long x = 0;
-  unsigned long y = 0;
+  TouchServiceEvent_t touch;
 
   while (1) {
-    curr_ped_tick_time = xTaskGetTickCount();
-
-    // check if button has been pressed
-    x = Touch_ReadX();
-    y = Touch_ReadY();
-
-    if (PED_LEFT_LIMIT < x && x < PED_RIGHT_LIMIT && 
-        PED_BOT_LIMIT < y && y < PED_TOP_LIMIT) { 
-      if (curr_ped_tick_time - prev_ped_tick_time >= SEC_TO_MS(BUTTON_PRESS_IN_S)) {
-        // register the input
-        pedestrian_pressed = SET;
-        prev_ped_tick_time = curr_ped_tick_time;
-      }
-      else {
-        pedestrian_pressed = RESET;
-      }
-    } else {
-      pedestrian_pressed = RESET;
-      prev_ped_tick_time = curr_ped_tick_time;
-    }
+    // Sleep until the touch service has something for this button
+    xQueueReceive(ped_queue, &touch, portMAX_DELAY);
 
-    vTaskDelay(1);
+    // register the input, Control() clears it once consumed
+    if (touch.Event.Type == TOUCH_EVENT_LONG_PRESS || touch.Event.Type == TOUCH_EVENT_REPEAT) {
+      pedestrian_pressed = SET;
+      Latency_Mark(LATENCY_STAGE_DISPATCH);
+    }
   }
 }
 
@@ -171,15 +282,19 @@ void Control(void *p) {
     curr_light_tick_time = xTaskGetTickCount();
 
     // check if time to make a transition or if there's been virtual input
-    if (curr_light_tick_time - prev_light_tick_time >= SEC_TO_MS(TRANSITION_TIMEOUT_IN_S) || onoff_pressed || pedestrian_pressed) { 
+    if (curr_light_tick_time - prev_light_tick_time >= SEC_TO_MS(transition_timeout) || onoff_pressed || pedestrian_pressed) { 
       
       // register that timer has expired
-      if (curr_light_tick_time - prev_light_tick_time >= SEC_TO_MS(TRANSITION_TIMEOUT_IN_S)) {
+      if (curr_light_tick_time - prev_light_tick_time >= SEC_TO_MS(transition_timeout)) {
         time_expired = SET;
         prev_light_tick_time = curr_light_tick_time;
       } 
     
       FSM();
+
+      // inputs are events: each press is consumed by a single FSM step
+      onoff_pressed = RESET;
+      pedestrian_pressed = RESET;
     } else {
       time_expired = RESET;
     }
@@ -189,7 +304,6 @@ void Control(void *p) {
 }
 
 void FSM(void) {
-  static TL_states_e present_state = IDLE;
   static TL_states_e next_state = IDLE;
 
   // choose next state
@@ -233,12 +347,14 @@ void FSM(void) {
       break;
   } 
 
+  // the input (if any) has been consumed by this step
+  Latency_Mark(LATENCY_STAGE_FSM);
+
   if (next_state != present_state) {
     present_state = next_state;
     time_expired = RESET;
     prev_light_tick_time = curr_light_tick_time;
     pedestrian_pressed = RESET;
-    prev_ped_tick_time = curr_ped_tick_time;
   }
 
   // produce the output
@@ -318,4 +434,34 @@ void FSM(void) {
       }
       break;
   }
+
+  // the screen shows the result of the input: report the latencies unless
+  // the previous report is still going out, the next one includes this trace
+  // then (UART0 carries the live watch instead with USE_WATCH)
+  if (Latency_Mark(LATENCY_STAGE_PHOTON) && !USE_WATCH && !UART_DmaBusy(UART_PORT_0)) {
+    UartSegment_t report;
+    report.Data = (const uint8_t *) latency_report;
+    report.Length = Latency_Format(latency_report, LATENCY_REPORT_SIZE);
+    if (report.Length) {
+      UART_WriteDma(UART_PORT_0, &report, 1, NULL, NULL);
+    }
+  }
+}
+
+#if (USE_WATCH)
+void Watch(void *p) {
+  while (1) {
+    Watch_Poll(&watch, (uint32_t) xTaskGetTickCount());
+    vTaskDelay(1);
+  }
+}
+#endif
+
+#if (USE_SHELL)
+void CommandShell(void *p) {
+  while (1) {
+    Shell_Poll(&shell);
+    vTaskDelay(1);
+  }
 }
+#endif
@@ -0,0 +1,83 @@
+#include "touch_service.h"
+
+// A queue interested in the events of a region
+typedef struct {
+    int8_t Region;
+    QueueHandle_t Queue;
+} TouchSubscriber_t;
+
+static TouchSubscriber_t Subscribers[TOUCH_SERVICE_MAX_SUBSCRIBERS];
+static uint8_t NumSubscribers = 0;
+static uint8_t DispatcherReady = 0;
+
+// Dispatcher callback: forwards the event to every queue subscribed to the region
+static void TouchService_Publish(int8_t region, const TouchEvent_t *event, void *arg) {
+    (void) arg;
+    TouchServiceEvent_t item;
+    item.Region = region;
+    item.Event = *event;
+
+    for (uint8_t i = 0; i < NumSubscribers; i++) {
+        if (Subscribers[i].Region == region) {
+            // Never block the sampler: a full queue means the consumer is lagging
+            xQueueSend(Subscribers[i].Queue, &item, 0);
+        }
+    }
+}
+
+int8_t TouchService_Register(const TouchRegion_t *region, QueueHandle_t queue) {
+    if (!DispatcherReady) {
+        TouchDispatch_Reset();
+        DispatcherReady = 1;
+    }
+
+    TouchRegion_t entry = *region;
+    entry.Callback = TouchService_Publish;
+    entry.Arg = NULL;
+
+    int8_t id = TouchDispatch_Register(&entry);
+    if (id != TOUCH_NO_REGION && TouchService_Subscribe(id, queue) < 0) {
+        return TOUCH_NO_REGION;
+    }
+
+    return id;
+}
+
+int TouchService_Subscribe(int8_t region, QueueHandle_t queue) {
+    if (NumSubscribers >= TOUCH_SERVICE_MAX_SUBSCRIBERS) {
+        return -1;
+    }
+
+    Subscribers[NumSubscribers].Region = region;
+    Subscribers[NumSubscribers].Queue = queue;
+    NumSubscribers++;
+    return 1;
+}
+
+void TouchService_SetLongPress(uint32_t ms) {
+    TouchDispatch_SetLongPress(ms);
+}
+
+void TouchService_SetRepeat(uint32_t ms) {
+    TouchDispatch_SetRepeat(ms);
+}
+
+int TouchService_Start(void) {
+    if (xTaskCreate(TouchService, (const char *)"TouchService", TOUCH_SERVICE_STACK_SIZE, 
+                    NULL, TOUCH_SERVICE_PRIORITY, NULL) != pdPASS) {
+        return -1;
+    }
+
+    return 1;
+}
+
+void TouchService(void *p) {
+    TickType_t last_wake = xTaskGetTickCount();
+
+    while (1) {
+        // Sample at the rate of the touch profile, independently of how long the consumers take
+        vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(Touch_GetScanPeriod()));
+        Latency_Mark(LATENCY_STAGE_TOUCH);
+        TouchDispatch_Poll(xTaskGetTickCount() * portTICK_PERIOD_MS);
+    }
+}
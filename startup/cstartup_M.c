@@ -201,6 +201,7 @@ const intvec_elem __vector_table[] =
   PWM_Generator3_Handler,
   DMA0_Software_Handler,
   DMA0_Error_Handler,
+  ADC1Sequence0_Handler,
   ADC1Sequence1_Handler,
   ADC1Sequence2_Handler,
   ADC1Sequence3_Handler,
@@ -244,6 +245,7 @@ const intvec_elem __vector_table[] =
   GPIOQ3_Handler,
   GPIOQ4_Handler,
   GPIOQ5_Handler,
+  GPIOQ6_Handler,
   GPIOQ7_Handler,
   0,
   0,
@@ -72,7 +72,7 @@ void LCD_SetTextColor( unsigned char r,
 //   - %d   Signed decimal integer
 //   - %c   Character
 //   - %s   String of characters
-//   - %f   Decimal floating point    (Not Yet Implemented)
+//   - %f   Decimal floating point (two decimals)
 //   - %x   Unsigned hexadecimal integer
 //   - %b   Binary integer
 //   - %%   A single % output
@@ -95,7 +95,7 @@ void LCD_PrintHex( unsigned long n );
 void LCD_PrintBinary( unsigned long n );
 
 // ************** LCD_PrintFloat **************************
-// - Prints a floating point number (doesn't work right now)
+// - Prints a floating point number with two decimals
 // ********************************************************
 void LCD_PrintFloat( float num );
 
@@ -10,6 +10,44 @@
 //#define TOUCH_USE_ADC0
 #define TOUCH_USE_ADC1
 
+// Sampling profiles. Each profile sets the ADC sample rate, the
+// hardware averaging, the settle time after switching the panel
+// drive lines (in discarded conversions) and the recommended
+// period between two polls of the panel.
+//
+//   Profile       Rate      Avg  Settle  Scan    Conversion  ReadX+ReadY*
+//   DEFAULT       125 KS/s  8x   1       10 ms   64 us       ~256 us
+//   LOW_LATENCY   1 MS/s    4x   1       5 ms    4 us        ~16 us
+//   LOW_NOISE     250 KS/s  32x  2       10 ms   128 us      ~768 us
+//   LOW_POWER     125 KS/s  1x   1       50 ms   8 us        ~32 us
+//
+// * ADC time only: (settle + 1) conversions per axis.
+//   These figures are computed from the settings, none of
+//   them has been measured. Use Touch_Measure() to obtain
+//   the actual latency and noise on the target with a
+//   finger held on the panel.
+//
+// The driver only owns sample sequencer 3 of its ADC. The
+// sample rate (ADCPC) and the averaging (ADCSAC) are set for
+// the whole module, though: the other sequencers of the same
+// ADC (e.g. ADC1 SS0 of sampler.h) convert with the rate and
+// averaging of the current profile.
+typedef enum {
+    TOUCH_PROFILE_DEFAULT,
+    TOUCH_PROFILE_LOW_LATENCY,
+    TOUCH_PROFILE_LOW_NOISE,
+    TOUCH_PROFILE_LOW_POWER
+} TouchProfile;
+
+// Result of Touch_Measure() for one axis
+typedef struct {
+    unsigned long min;          // smallest sample
+    unsigned long max;          // largest sample
+    unsigned long mean;         // average of the samples
+    unsigned long variance;     // variance of the samples (counts^2)
+    unsigned long cycles;       // average CPU cycles per Touch_ReadX/Y call
+} TouchStats;
+
 // ************** Touch_Init *******************************
 // - Initializes the GPIO used for the touchpad
 // *********************************************************
@@ -34,4 +72,33 @@ unsigned long Touch_ReadX( void );
 // *********************************************************
 unsigned long Touch_ReadY( void );
 
+// ************** Touch_SetProfile *************************
+// - Selects the sampling profile (sample rate, averaging,
+//   settle time and scan rate). Can be called before or
+//   after Touch_Init()
+// *********************************************************
+// Input: profile
+// Output: none
+// *********************************************************
+void Touch_SetProfile( TouchProfile profile );
+
+// ************** Touch_GetScanPeriod **********************
+// - Period (ms) at which the panel should be polled with
+//   the current profile
+// *********************************************************
+// Input: none
+// Output: period in ms
+// *********************************************************
+unsigned long Touch_GetScanPeriod( void );
+
+// ************** Touch_Measure ****************************
+// - Takes n samples of each axis and reports the noise and
+//   the latency of the reads with the current profile.
+//   Keep a finger (or stylus) still on the panel meanwhile
+// *********************************************************
+// Input: n (number of samples), stats for x and y
+// Output: none
+// *********************************************************
+void Touch_Measure( unsigned short n, TouchStats *x, TouchStats *y );
+
 
@@ -28,6 +28,7 @@
 #include "SSD2119_Display.h"
 #include "official_tm4c1294ncpdt.h"
 #include <stdint.h>
+#include <stdarg.h>
 
 unsigned short cursorX;
 unsigned short cursorY;
@@ -595,46 +596,31 @@ void LCD_SetTextColor(unsigned char r, unsigned char g, unsigned char b){
 //   - %d   Signed decimal integer
 //   - %c   Character
 //   - %s   String of characters
-//   - %f   Decimal floating point    (Not Yet Implemented)
+//   - %f   Decimal floating point (two decimals)
 //   - %x   Unsigned hexadecimal integer
 //   - %b   Binary integer
 //   - %%   A single % output
+// - Arguments are read with va_arg: floats are promoted
+//   to double and chars to int by the caller
 // ********************************************************
 void LCD_Printf(char fmt[], ...) {
 	unsigned char k = 0;
-	void* next_arg = &fmt + 1;
+	va_list args;
+	va_start(args, fmt);
 	while (fmt[k] != 0) {
 		if (fmt[k] == '%') {                    // Special escape, look for next arg
 			if (fmt[k+1] == 'd') {              // Display integer
-				long* p = (long*) next_arg;
-				long x = *p;
-				next_arg = p + 1;
-				LCD_PrintInteger(x);
+				LCD_PrintInteger(va_arg(args, long));
 			} else if (fmt[k+1] == 'c') {       // Display character
-				long* p = (long*) next_arg;
-				char x = *p;
-				next_arg = p + 1;
-				LCD_PrintChar(x);
+				LCD_PrintChar((unsigned char) va_arg(args, int));
 			} else if (fmt[k+1] == 's') {       // Display string
-				char** p = (char**) next_arg;
-				char* x = *p;
-				next_arg = p + 1;
-				LCD_PrintString(x);
- 			} else if (fmt[k+1] == 'f') {       // Display float (not yet working)
- 				float* p = (float*) next_arg;
- 				float x = *p;
- 				next_arg = p + 1;
- 				LCD_PrintFloat(x);
+				LCD_PrintString(va_arg(args, char*));
+ 			} else if (fmt[k+1] == 'f') {       // Display float
+ 				LCD_PrintFloat((float) va_arg(args, double));
 			} else if (fmt[k+1] == 'x') {       // Display hexadecimal
-				long* p = (long*) next_arg;
-				long x = *p;
-				next_arg = p + 1;
-				LCD_PrintHex(x);
+				LCD_PrintHex(va_arg(args, unsigned long));
 			} else if (fmt[k+1] == 'b') {       // Display binary
-				long* p = (long*) next_arg;
-				long x = *p;
-				next_arg = p + 1;
-				LCD_PrintBinary(x);
+				LCD_PrintBinary(va_arg(args, unsigned long));
 			} else if (fmt[k+1] == '%') {       // Display '%'
 				LCD_PrintChar('%');
 			} else {
@@ -646,6 +632,7 @@ void LCD_Printf(char fmt[], ...) {
 			k = k + 1;
 		}
 	}
+	va_end(args);
 }
 
 // ************** LCD_PrintInteger ************************
@@ -770,6 +757,12 @@ void LCD_PrintFloat(float num) {
     long whole; 
     long fraction;
 
+    // Print the sign here so that the digits work on the magnitude
+    if (num < 0) {
+        LCD_PrintChar('-');
+        num = -num;
+    }
+
     // We only need two decimal places for this lab. 
     // Add 5 for rounding
     num = num * 1000 + 5;
@@ -779,12 +772,12 @@ void LCD_PrintFloat(float num) {
 
     LCD_PrintInteger(whole);
     LCD_PrintChar('.');
-    LCD_PrintInteger(fraction);
 
     // Pad with 0 so that we still have two decimals
     if (fraction < 10) {
         LCD_PrintInteger(0);
     }
+    LCD_PrintInteger(fraction);
 }
 
 ///////////////////////////////////////////////////////////
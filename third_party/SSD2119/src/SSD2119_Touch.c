@@ -45,6 +45,31 @@
 #define PD5  (1<<5)   //Y+    AIN6
 #define PD4  (1<<4)   //X+    AIN7
 
+// Cortex-M4 DWT cycle counter, used by Touch_Measure()
+#define DEMCR_R         (*((volatile uint32_t *)0xE000EDFC))
+#define DEMCR_TRCENA    0x01000000
+#define DWT_CTRL_R      (*((volatile uint32_t *)0xE0001000))
+#define DWT_CTRL_CYCEN  0x00000001
+#define DWT_CYCCNT_R    (*((volatile uint32_t *)0xE0001004))
+
+// Settings applied by each TouchProfile
+typedef struct {
+    unsigned char pc;           // ADCPC: sample rate
+    unsigned char sac;          // ADCSAC: hardware averaging
+    unsigned char settle;       // conversions discarded after switching the drive lines
+    unsigned char scanPeriod;   // recommended time between polls in ms
+} TouchProfileConfig;
+
+static const TouchProfileConfig Profiles[] = {
+    { ADC_PC_MCR_1_8,  ADC_SAC_AVG_8X,  1, 10 },    // TOUCH_PROFILE_DEFAULT
+    { ADC_PC_MCR_FULL, ADC_SAC_AVG_4X,  1, 5  },    // TOUCH_PROFILE_LOW_LATENCY
+    { ADC_PC_MCR_1_4,  ADC_SAC_AVG_32X, 2, 10 },    // TOUCH_PROFILE_LOW_NOISE
+    { ADC_PC_MCR_1_8,  ADC_SAC_AVG_OFF, 1, 50 }     // TOUCH_PROFILE_LOW_POWER
+};
+
+// Profile currently in use
+static TouchProfile currentProfile = TOUCH_PROFILE_DEFAULT;
+
 // Private Functions
 // - Initializes the ADC to use a specficed channel on SS3
 static void ADC_Init(void);
@@ -55,6 +80,12 @@ static unsigned long ADC_Read(void);
 // - Configures the ADC to use a specific channel
 static void ADC_SetChannel(unsigned char channelNum);
 
+// - Writes the sample rate and averaging of the current profile
+static void ADC_ApplyProfile(void);
+
+// - Discards the settle conversions and returns the next one
+static unsigned long ADC_ReadSettled(void);
+
 // **************  Touch_Init ******************************
 // - Initializes the GPIO used for the touchpad
 // - Port D for ADC, port Q and M for digital output
@@ -95,24 +126,22 @@ void Touch_Init(void){
 static void ADC_Init(void){
     long wait = 0;
     
+    // Note: The ADC is clocked from ALTCLK, which must select PIOSC
+    // (SYSCTL_ALTCLKCFG_R = 0x0, its reset value). The system clock
+    // and ALTCLK belong to the application, so they are not modified here
+
     #if defined TOUCH_USE_ADC0
     // Set bit 0 in SYSCTL_RCGCADC_R to enable ADC0
     SYSCTL_RCGCADC_R |= 0x01;
     wait++;
     wait++;
-    // Power up the PLL
-    SYSCTL_PLLFREQ0_R |= SYSCTL_PLLFREQ0_PLLPWR;
-    while (SYSCTL_PLLSTAT_R != 0x1); // wait for PLL to lock
     // Enable PIOSC in the CS bit field in the ADCCC registeR
     ADC0_CC_R = 0x1;
-    // ALTCLK field should be programmed to 0x0
-    SYSCTL_ALTCLKCFG_R = 0x0;
-    // Set ADC sample to 125KS/s
-    ADC0_PC_R = 0x01;
-    // ADC sample averaging control
-    ADC0_SAC_R = 0x3;
-    // Disable all sequencers for configuration
-    ADC0_ACTSS_R &= ~0x000F;
+    // Disable sample sequencer 3 for configuration. The other
+    // sequencers may belong to the application (e.g. sampler.h)
+    ADC0_ACTSS_R &= ~0x0008;
+    // Set sample rate and averaging from the current profile
+    ADC_ApplyProfile();
     // Set ADC0 SS3 to highest priority
     ADC0_SSPRI_R = 0x0123;    
     // Set bits 12-15 to 0x00 to enable software trigger on SS3
@@ -132,19 +161,13 @@ static void ADC_Init(void){
     SYSCTL_RCGCADC_R |= (0x1<<1);
     wait++;
     wait++;
-    // Power up the PLL
-    SYSCTL_PLLFREQ0_R |= SYSCTL_PLLFREQ0_PLLPWR;
-    while (SYSCTL_PLLSTAT_R != 0x1); // wait for PLL to lock
     // Enable PIOSC in the CS bit field in the ADCCC registeR
     ADC1_CC_R = 0x1;
-    // ALTCLK field should be programmed to 0x0
-    SYSCTL_ALTCLKCFG_R = 0x0;
-    // Set ADC sample to 125KS/s
-    ADC1_PC_R = 0x01;
-    // ADC sample averaging control
-    ADC1_SAC_R = 0x3;
-    // Disable all sequencers for configuration
-    ADC1_ACTSS_R &= ~0x000F;
+    // Disable sample sequencer 3 for configuration. The other
+    // sequencers may belong to the application (e.g. sampler.h)
+    ADC1_ACTSS_R &= ~0x0008;
+    // Set sample rate and averaging from the current profile
+    ADC_ApplyProfile();
     // Set ADC0 SS3 to highest priority
     ADC1_SSPRI_R = 0x0123;    
     // Set bits 12-15 to 0x00 to enable software trigger on SS3
@@ -206,8 +229,8 @@ unsigned long ADC_Read(void){
 void ADC_SetChannel(unsigned char channelNum){
     #if defined TOUCH_USE_ADC0
     
-    // Disable all sequencers for configuration
-    ADC0_ACTSS_R &= ~0xF;
+    // Disable sample sequencer 3 for configuration
+    ADC0_ACTSS_R &= ~0x8;
     // Set sample channel for sequencer 3
     ADC0_SSMUX3_R &= ~0xF;
     ADC0_SSMUX3_R += channelNum;
@@ -216,8 +239,8 @@ void ADC_SetChannel(unsigned char channelNum){
 
     #elif defined TOUCH_USE_ADC1
 
-    // Disable all sequencers for configuration
-    ADC1_ACTSS_R &= ~0xF;
+    // Disable sample sequencer 3 for configuration
+    ADC1_ACTSS_R &= ~0x8;
     // Set sample channel for sequencer 3
     ADC1_SSMUX3_R &= ~0xF;
     ADC1_SSMUX3_R += channelNum;
@@ -227,6 +250,84 @@ void ADC_SetChannel(unsigned char channelNum){
     #endif
 }
 
+// ************** ADC_ApplyProfile *************************
+// - Writes the sample rate and averaging of the current
+//   profile. ADCPC and ADCSAC are shared by every sequencer
+//   of the module, so the write waits until no conversion
+//   is in progress (BUSY, bit 16 of ADCACTSS), and the
+//   settings also apply to the other users of the ADC.
+//   SS3 must be disabled by the caller
+// *********************************************************
+// Input: none
+// Output: none
+// *********************************************************
+static void ADC_ApplyProfile(void){
+    #if defined TOUCH_USE_ADC0
+    while (ADC0_ACTSS_R & 0x10000);
+    ADC0_PC_R = Profiles[currentProfile].pc;
+    ADC0_SAC_R = Profiles[currentProfile].sac;
+    #elif defined TOUCH_USE_ADC1
+    while (ADC1_ACTSS_R & 0x10000);
+    ADC1_PC_R = Profiles[currentProfile].pc;
+    ADC1_SAC_R = Profiles[currentProfile].sac;
+    #endif
+}
+
+// ************** ADC_ReadSettled **************************
+// - Discards the conversions taken while the panel settles
+//   and returns the next one
+// *********************************************************
+// Input: none
+// Output: sampled value from the ADC
+// *********************************************************
+static unsigned long ADC_ReadSettled(void){
+    unsigned char i;
+
+    // Discard
+    for (i = 0; i < Profiles[currentProfile].settle; i++) {
+        ADC_Read();
+    }
+
+    // Keep
+    return ADC_Read();
+}
+
+// ************** Touch_SetProfile *************************
+// - Selects the sampling profile
+// *********************************************************
+// Input: profile
+// Output: none
+// *********************************************************
+void Touch_SetProfile(TouchProfile profile){
+    if (profile > TOUCH_PROFILE_LOW_POWER) return;
+    currentProfile = profile;
+
+    // If the ADC is already running, reconfigure it now
+    #if defined TOUCH_USE_ADC0
+    if (SYSCTL_RCGCADC_R & 0x01) {
+        ADC0_ACTSS_R &= ~0x8;
+        ADC_ApplyProfile();
+        ADC0_ACTSS_R |= 0x8;
+    }
+    #elif defined TOUCH_USE_ADC1
+    if (SYSCTL_RCGCADC_R & (0x1<<1)) {
+        ADC1_ACTSS_R &= ~0x8;
+        ADC_ApplyProfile();
+        ADC1_ACTSS_R |= 0x8;
+    }
+    #endif
+}
+
+// ************** Touch_GetScanPeriod **********************
+// - Period (ms) at which the panel should be polled
+// *********************************************************
+// Input: none
+// Output: period in ms
+// *********************************************************
+unsigned long Touch_GetScanPeriod(void){
+    return Profiles[currentProfile].scanPeriod;
+}
+
 // ************** ADC_ReadY ********************************
 // - 
 // *********************************************************
@@ -264,11 +365,8 @@ unsigned long Touch_ReadY(void){
     // Configure ADC to read from AIN6 (Y+/Top/PD5)
     ADC_SetChannel(6);
     
-    // Discard
-    ADC_Read();
-
-    // Keep
-    unsigned long result = ADC_Read();
+    // Discard while the panel settles and keep the next conversion
+    unsigned long result = ADC_ReadSettled();
 
     return result;
 }
@@ -310,11 +408,56 @@ unsigned long Touch_ReadX(void){
     // Configure ADC to read from AIN7 (X+/Left/PD4)
     ADC_SetChannel(7);
     
-    // Discard
-    ADC_Read();
-
-    // Keep
-    unsigned long result = ADC_Read();
+    // Discard while the panel settles and keep the next conversion
+    unsigned long result = ADC_ReadSettled();
     
     return result;
 }
+
+// ************** Touch_Measure ****************************
+// - Takes n samples of each axis and reports the noise
+//   (min, max, mean, variance) and the CPU cycles per read
+// *********************************************************
+// Input: n (number of samples), stats for x and y
+// Output: none
+// *********************************************************
+void Touch_Measure(unsigned short n, TouchStats *x, TouchStats *y){
+    unsigned short i;
+    unsigned long start, sample;
+    unsigned long long cyclesX = 0, cyclesY = 0;
+    unsigned long long sumX = 0, sumY = 0, sqX = 0, sqY = 0;
+
+    if (n == 0) return;
+
+    // Start the cycle counter
+    DEMCR_R |= DEMCR_TRCENA;
+    DWT_CTRL_R |= DWT_CTRL_CYCEN;
+
+    x->min = y->min = 0xFFF;
+    x->max = y->max = 0;
+
+    for (i = 0; i < n; i++) {
+        start = DWT_CYCCNT_R;
+        sample = Touch_ReadX();
+        cyclesX += DWT_CYCCNT_R - start;
+        sumX += sample;
+        sqX += (unsigned long long) sample * sample;
+        if (sample < x->min) x->min = sample;
+        if (sample > x->max) x->max = sample;
+
+        start = DWT_CYCCNT_R;
+        sample = Touch_ReadY();
+        cyclesY += DWT_CYCCNT_R - start;
+        sumY += sample;
+        sqY += (unsigned long long) sample * sample;
+        if (sample < y->min) y->min = sample;
+        if (sample > y->max) y->max = sample;
+    }
+
+    x->mean = sumX / n;
+    y->mean = sumY / n;
+    x->variance = (sqX - sumX * sumX / n) / n;
+    y->variance = (sqY - sumY * sumY / n) / n;
+    x->cycles = cyclesX / n;
+    y->cycles = cyclesY / n;
+}
@@ -0,0 +1,251 @@
+/*
+ * Host test of utils/fft.c.
+ *
+ *   gcc -O2 -I../utils/inc fft_test.c ../utils/src/fft.c -lm -o fft_test && ./fft_test
+ *
+ * On a host the dual 16-bit instructions are replaced by C with the same semantics (see
+ * fft.h), so the outputs are the ones of the target. They are checked in three ways:
+ *  - Golden vectors: the outputs of two small transforms, computed outside of this file
+ *    with the arithmetic of the butterflies below and written here as numbers, must
+ *    match exactly.
+ *  - Reference model: an integer model of the radix-2 butterflies, written independently
+ *    of fft.c (recursive, separate real and imaginary parts, twiddles computed with libm),
+ *    must match exactly for every size and every test signal.
+ *  - DFT: the model itself must stay within FFT_TEST_TOLERANCE LSB per stage of a DFT in
+ *    double precision divided by the number of points, so both are checked against the
+ *    mathematics and not only against each other.
+ * Prints the result of each size and returns 1 if anything fails.
+ */
+
+#include "fft.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define FFT_TEST_TOLERANCE              1.5
+#define FFT_TEST_SIGNALS                6U
+
+#ifndef M_PI
+#define M_PI                            3.14159265358979323846
+#endif
+
+static FftComplex_t Data[FFT_MAX_POINTS];
+static int16_t ModelRe[FFT_MAX_POINTS];
+static int16_t ModelIm[FFT_MAX_POINTS];
+
+/*
+ * Golden vectors. An 8-point ramp 0, 4096, ..., 28672 with imaginary parts 0, and a
+ * 4-point input with both parts set. Each stage of the model computes
+ * t = (b * w) >> 15 per part, then (a + t) >> 1 and (a - t) >> 1 with arithmetic shifts.
+ */
+static const int16_t Golden8In[8][2] = {
+    {0, 0}, {4096, 0}, {8192, 0}, {12288, 0}, {16384, 0}, {20480, 0}, {24576, 0}, {28672, 0}
+};
+static const int16_t Golden8Out[8][2] = {
+    {14333, 0}, {-2049, 4943}, {-2048, 2047}, {-2048, 848},
+    {-2048, 0}, {-2048, -848}, {-2048, -2048}, {-2048, -4944}
+};
+static const int16_t Golden4In[4][2] = {
+    {1000, -2000}, {-32768, 32767}, {12345, 321}, {-7, 7}
+};
+static const int16_t Golden4Out[4][2] = {
+    {-4858, 7772}, {5353, 7610}, {11530, -8613}, {-11026, -8770}
+};
+
+// Q15 twiddle W^k = cos(2 pi k / FFT_MAX_POINTS) - j sin(2 pi k / FFT_MAX_POINTS)
+static int16_t FftTest_TwiddleRe(uint32_t k) {
+    return (int16_t) lround(32767.0 * cos(2.0 * M_PI * k / FFT_MAX_POINTS));
+}
+
+static int16_t FftTest_TwiddleIm(uint32_t k) {
+    return (int16_t) -lround(32767.0 * sin(2.0 * M_PI * k / FFT_MAX_POINTS));
+}
+
+/*
+ * Reference model: DFT of points values spaced by stride, divided by points, by
+ * decimation in time. The even and odd halves are transformed first, then each pair of
+ * outputs is one butterfly with the arithmetic of the target instructions:
+ * SMUSD/SMUADX keep 32 bits, >> 15 is arithmetic and the result is truncated to 16 bits
+ * by the packing, SHADD16/SHSUB16 add or subtract in 17 bits and shift right by one.
+ */
+static void FftTest_Model(const int16_t *in_re, const int16_t *in_im, uint16_t stride, uint16_t points,
+                          int16_t *out_re, int16_t *out_im) {
+    if (points == 1U) {
+        out_re[0] = in_re[0];
+        out_im[0] = in_im[0];
+        return;
+    }
+
+    uint16_t half = points / 2U;
+    FftTest_Model(in_re, in_im, 2U * stride, half, out_re, out_im);
+    FftTest_Model(in_re + stride, in_im + stride, 2U * stride, half, out_re + half, out_im + half);
+
+    for (uint16_t k = 0; k < half; k++) {
+        uint32_t index = (uint32_t) k * (FFT_MAX_POINTS / points);
+        int32_t w_re = FftTest_TwiddleRe(index);
+        int32_t w_im = FftTest_TwiddleIm(index);
+        int32_t a_re = out_re[k];
+        int32_t a_im = out_im[k];
+        int32_t b_re = out_re[k + half];
+        int32_t b_im = out_im[k + half];
+
+        int16_t t_re = (int16_t) ((b_re * w_re - b_im * w_im) >> 15);
+        int16_t t_im = (int16_t) ((b_re * w_im + b_im * w_re) >> 15);
+
+        out_re[k] = (int16_t) ((a_re + t_re) >> 1);
+        out_im[k] = (int16_t) ((a_im + t_im) >> 1);
+        out_re[k + half] = (int16_t) ((a_re - t_re) >> 1);
+        out_im[k + half] = (int16_t) ((a_im - t_im) >> 1);
+    }
+}
+
+// Runs the model on Data, which is not modified
+static void FftTest_RunModel(uint16_t points) {
+    static int16_t re[FFT_MAX_POINTS];
+    static int16_t im[FFT_MAX_POINTS];
+
+    for (uint16_t n = 0; n < points; n++) {
+        re[n] = FFT_RE(Data[n]);
+        im[n] = FFT_IM(Data[n]);
+    }
+    FftTest_Model(re, im, 1U, points, ModelRe, ModelIm);
+}
+
+// Fills the input with one of the test signals, full scale where possible
+static void FftTest_Signal(uint8_t signal, uint16_t points) {
+    for (uint16_t i = 0; i < points; i++) {
+        int32_t re = 0;
+        int32_t im = 0;
+
+        switch (signal) {
+            case 0:
+                // Impulse
+                re = i == 0 ? 32767 : 0;
+                break;
+            case 1:
+                // DC
+                re = 32767;
+                break;
+            case 2:
+                // Tone on a bin, and one between two bins
+                re = (int32_t) lround(16383.0 * cos(2.0 * M_PI * 3.0 * i / points));
+                im = (int32_t) lround(16383.0 * sin(2.0 * M_PI * 1.5 * i / points));
+                break;
+            case 3:
+                // Alternating full scale (Nyquist bin)
+                re = (i & 1U) ? -32768 : 32767;
+                break;
+            case 4:
+                // Noise
+                re = (rand() & 0xFFFF) - 32768;
+                im = (rand() & 0xFFFF) - 32768;
+                break;
+            default:
+                // Windowed ramp of ADC codes, the path of the spectrum task
+                break;
+        }
+        Data[i] = FFT_PACK(re, im);
+    }
+
+    if (signal >= 5U) {
+        static uint16_t codes[FFT_MAX_POINTS];
+        FftPlan_t plan;
+
+        for (uint16_t i = 0; i < points; i++) {
+            codes[i] = (uint16_t) (i * 4095U / (points - 1U));
+        }
+        Fft_Init(&plan, points);
+        Fft_Window(&plan, codes, 1U, Data);
+    }
+}
+
+// Largest distance of the model from the DFT of Data divided by the number of points
+static double FftTest_DftError(uint16_t points) {
+    double worst = 0.0;
+
+    for (uint16_t k = 0; k < points; k++) {
+        double re = 0.0;
+        double im = 0.0;
+
+        for (uint16_t n = 0; n < points; n++) {
+            double angle = -2.0 * M_PI * (double) ((uint32_t) k * n % points) / points;
+            re += FFT_RE(Data[n]) * cos(angle) - FFT_IM(Data[n]) * sin(angle);
+            im += FFT_RE(Data[n]) * sin(angle) + FFT_IM(Data[n]) * cos(angle);
+        }
+        worst = fmax(worst, fmax(fabs(ModelRe[k] - re / points), fabs(ModelIm[k] - im / points)));
+    }
+
+    return worst;
+}
+
+// Transforms a golden input and compares it with the golden output
+static int FftTest_Golden(const int16_t (*in)[2], const int16_t (*out)[2], uint16_t points) {
+    FftPlan_t plan;
+    int failed = 0;
+
+    Fft_Init(&plan, points);
+    for (uint16_t n = 0; n < points; n++) {
+        Data[n] = FFT_PACK(in[n][0], in[n][1]);
+    }
+    FftTest_RunModel(points);
+    Fft_Transform(&plan, Data);
+
+    for (uint16_t k = 0; k < points; k++) {
+        if (FFT_RE(Data[k]) != out[k][0] || FFT_IM(Data[k]) != out[k][1] ||
+            ModelRe[k] != out[k][0] || ModelIm[k] != out[k][1]) {
+            printf("%5u points: golden bin %u is (%d, %d), model (%d, %d), expected (%d, %d)\n",
+                   points, k, FFT_RE(Data[k]), FFT_IM(Data[k]), ModelRe[k], ModelIm[k],
+                   out[k][0], out[k][1]);
+            failed = 1;
+        }
+    }
+    printf("%5u points: golden vector %s\n", points, failed ? "FAILED" : "OK");
+
+    return failed;
+}
+
+int main(void) {
+    int failed = 0;
+
+    failed |= FftTest_Golden(Golden4In, Golden4Out, 4U);
+    failed |= FftTest_Golden(Golden8In, Golden8Out, 8U);
+
+    srand(1);
+    for (uint16_t points = FFT_MIN_POINTS; points <= FFT_MAX_POINTS; points <<= 1) {
+        FftPlan_t plan;
+        double worst = 0.0;
+        uint32_t mismatches = 0;
+
+        if (Fft_Init(&plan, points) != 1) {
+            printf("%5u points: Fft_Init() failed\n", points);
+            failed = 1;
+            continue;
+        }
+
+        double limit = FFT_TEST_TOLERANCE * plan.Log2;
+        for (uint8_t signal = 0; signal < FFT_TEST_SIGNALS; signal++) {
+            FftTest_Signal(signal, points);
+            FftTest_RunModel(points);
+            worst = fmax(worst, FftTest_DftError(points));
+            Fft_Transform(&plan, Data);
+
+            for (uint16_t k = 0; k < points; k++) {
+                if (FFT_RE(Data[k]) != ModelRe[k] || FFT_IM(Data[k]) != ModelIm[k]) {
+                    if (mismatches++ == 0) {
+                        printf("%5u points: signal %u, bin %u is (%d, %d) instead of (%d, %d)\n",
+                               points, signal, k, FFT_RE(Data[k]), FFT_IM(Data[k]), ModelRe[k], ModelIm[k]);
+                    }
+                }
+            }
+        }
+        if (mismatches || worst > limit) {
+            failed = 1;
+        }
+        printf("%5u points: %lu bins differ from the model, model within %.2f LSB of the DFT (limit %.1f)\n",
+               points, (unsigned long) mismatches, worst, limit);
+    }
+
+    printf(failed ? "FAILED\n" : "OK\n");
+    return failed;
+}
@@ -0,0 +1,197 @@
+#!/usr/bin/env python3
+"""Prints the deferred log of utils/log.c as text.
+
+The records only hold the address of their format string, so the decoder needs the ELF
+file the firmware was built into (e.g. the .out file of the IAR project):
+
+    python3 log_decode.py firmware.out capture.bin -c 16000000
+    python3 log_decode.py firmware.out /dev/ttyACM0 -b 115200 -c 16000000
+
+A serial port is decoded live (this needs pyserial). Each record becomes one line: time
+(in seconds with -c, in CPU cycles otherwise) and message. Damaged frames, sequence gaps
+and the records the device dropped are reported on stderr as they are found.
+"""
+
+import argparse
+import binascii
+import os
+import re
+import struct
+import sys
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+from telemetry_decode import cobs_decode  # noqa: E402
+
+HEADER_LEN = 3
+CRC_LEN = 2
+
+SHT_PROGBITS = 1
+SHF_ALLOC = 2
+
+# printf conversions with flags, width, precision and an ignored length modifier
+CONVERSION = re.compile(r'%([-+ 0#]*)(\d*)(?:\.(\d+))?(?:hh|h|ll|l|z|j|t)?([diuxXocps%])')
+
+
+class Image:
+    """Contents of the allocated sections of an ELF file, by address."""
+
+    def __init__(self, path):
+        with open(path, 'rb') as elf:
+            data = elf.read()
+        if data[:4] != b'\x7fELF' or data[4] not in (1, 2) or data[5] != 1:
+            raise ValueError('%s is not a little-endian ELF file' % path)
+        # 32-bit (the target) or 64-bit (a host build) layout
+        if data[4] == 1:
+            shoff, = struct.unpack_from('<I', data, 0x20)
+            shentsize, shnum = struct.unpack_from('<HH', data, 0x2E)
+            section = '<IIIIII'
+        else:
+            shoff, = struct.unpack_from('<Q', data, 0x28)
+            shentsize, shnum = struct.unpack_from('<HH', data, 0x3A)
+            section = '<IIQQQQ'
+        self.sections = []
+        for i in range(shnum):
+            _, kind, flags, addr, offset, size = struct.unpack_from(section, data,
+                                                                     shoff + i * shentsize)
+            if kind == SHT_PROGBITS and flags & SHF_ALLOC and size:
+                self.sections.append((addr, data[offset:offset + size]))
+        self.cache = {}
+
+    def string(self, address):
+        """Returns the NUL-terminated string at an address, or None if it is not in flash."""
+        if address not in self.cache:
+            self.cache[address] = None
+            for start, content in self.sections:
+                if start <= address < start + len(content):
+                    end = content.find(b'\x00', address - start)
+                    text = content[address - start:end if end >= 0 else len(content)]
+                    self.cache[address] = text.decode('latin-1')
+                    break
+        return self.cache[address]
+
+
+def format_record(image, fmt, args):
+    """Expands a format string with the 32-bit words of a record."""
+    args = list(args)
+
+    def expand(match):
+        flags, width, precision, conversion = match.groups()
+        if conversion == '%':
+            return '%'
+        if not args:
+            return '<missing>'
+        word = args.pop(0)
+        spec = '%' + flags + width + ('.' + precision if precision else '')
+        if conversion in 'di':
+            return (spec + 'd') % (word - (1 << 32) if word & 0x80000000 else word)
+        if conversion == 'c':
+            return (spec + 'c') % chr(word & 0xFF)
+        if conversion == 's':
+            text = image.string(word)
+            return (spec + 's') % (text if text is not None else '<0x%08x>' % word)
+        if conversion == 'p':
+            return (spec + 's') % ('0x%08x' % word)
+        return (spec + conversion) % word
+
+    return CONVERSION.sub(expand, fmt)
+
+
+class Decoder:
+    """Decodes the stream as it arrives and prints the records."""
+
+    def __init__(self, image, clock, out):
+        self.image = image
+        self.clock = clock
+        self.out = out
+        self.pending = bytearray()
+        self.expected = None
+        self.last = None
+        self.time = 0
+        self.good = self.bad = self.lost_frames = self.dropped = 0
+
+    def feed(self, data):
+        self.pending += data
+        *complete, rest = self.pending.split(b'\x00')
+        self.pending = bytearray(rest)
+        for raw in complete:
+            if raw:
+                self.frame(cobs_decode(bytes(raw)))
+
+    def frame(self, frame):
+        if (frame is None or len(frame) < HEADER_LEN + CRC_LEN or (len(frame) - HEADER_LEN - CRC_LEN) % 4 or
+                binascii.crc_hqx(frame[:-CRC_LEN], 0xFFFF) != int.from_bytes(frame[-CRC_LEN:], 'big')):
+            self.bad += 1
+            sys.stderr.write('damaged frame\n')
+            return
+        self.good += 1
+
+        sequence = frame[0]
+        if self.expected is not None and sequence != self.expected:
+            gap = (sequence - self.expected) & 0xFF
+            self.lost_frames += gap
+            sys.stderr.write('%d frames lost\n' % gap)
+        self.expected = (sequence + 1) & 0xFF
+
+        dropped = int.from_bytes(frame[1:3], 'little')
+        if dropped:
+            self.dropped += dropped
+            sys.stderr.write('%d records dropped by the device\n' % dropped)
+
+        words = struct.unpack_from('<%dI' % ((len(frame) - HEADER_LEN - CRC_LEN) // 4), frame, HEADER_LEN)
+        pos = 0
+        while pos + 2 <= len(words):
+            header, cycles = words[pos], words[pos + 1]
+            nargs = header >> 28
+            args = words[pos + 2:pos + 2 + nargs]
+            pos += 2 + nargs
+            self.record(header & 0x0FFFFFFF, cycles, args)
+
+    def record(self, address, cycles, args):
+        # The cycle counter wraps around (every 268 s at 16 MHz): follow it with signed steps,
+        # since records of interrupts may be stored slightly out of order
+        if self.last is not None:
+            step = (cycles - self.last) & 0xFFFFFFFF
+            self.time += step - (1 << 32) if step & 0x80000000 else step
+        self.last = cycles
+
+        fmt = self.image.string(address)
+        if fmt is None:
+            text = '<unknown format 0x%08x> %s' % (address, ' '.join('0x%08x' % a for a in args))
+        else:
+            text = format_record(self.image, fmt, args)
+
+        stamp = '%12.6f' % (self.time / self.clock) if self.clock else '%12d' % self.time
+        self.out.write('%s  %s\n' % (stamp, text.rstrip('\r\n')))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('elf', help='ELF file of the firmware')
+    parser.add_argument('input', help="capture of the stream, '-' for stdin, or a serial port")
+    parser.add_argument('-b', '--baud', type=int, default=115200, help='baud rate of a serial port')
+    parser.add_argument('-c', '--clock', type=float, default=0,
+                        help='CPU clock in Hz, to print the time in seconds')
+    args = parser.parse_args()
+
+    decoder = Decoder(Image(args.elf), args.clock, sys.stdout)
+
+    if args.input.startswith('/dev/') or args.input.upper().startswith('COM'):
+        import serial
+        port = serial.Serial(args.input, args.baud, timeout=0.1)
+        try:
+            while True:
+                decoder.feed(port.read(4096))
+                sys.stdout.flush()
+        except KeyboardInterrupt:
+            pass
+    else:
+        source = sys.stdin.buffer if args.input == '-' else open(args.input, 'rb')
+        decoder.feed(source.read())
+
+    sys.stderr.write('%d frames, %d damaged, %d lost, %d records dropped\n' %
+                     (decoder.good, decoder.bad, decoder.lost_frames, decoder.dropped))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,158 @@
+#!/usr/bin/env python3
+"""Decodes the binary telemetry stream of utils/telemetry.c into CSV.
+
+The input is a capture of the raw bytes (a file, or '-' for stdin), for example:
+
+    python3 telemetry_decode.py capture.bin -c 0:temperature_c:2 > temperature.csv
+
+Each record becomes one row: time, channel, value. Frames that fail the CRC are
+dropped, and a summary of the dropped frames and of the sequence gaps goes to stderr.
+"""
+
+import argparse
+import binascii
+import csv
+import sys
+
+TYPE_INT = 0
+TYPE_UINT = 1
+TYPE_TIME = 2
+
+HEADER_LEN = 5
+CRC_LEN = 2
+
+
+def cobs_decode(data):
+    """Returns the decoded frame, or None if the encoding is invalid."""
+    out = bytearray()
+    pos = 0
+    while pos < len(data):
+        code = data[pos]
+        if code == 0 or pos + code > len(data):
+            return None
+        out += data[pos + 1:pos + code]
+        pos += code
+        if code < 0xFF and pos < len(data):
+            out.append(0)
+    return bytes(out)
+
+
+def varint(frame, pos):
+    """Reads a LEB128 varint, returns (value, next position)."""
+    value = 0
+    shift = 0
+    while True:
+        if pos >= len(frame) or shift > 28:
+            raise ValueError('truncated varint')
+        byte = frame[pos]
+        pos += 1
+        value |= (byte & 0x7F) << shift
+        shift += 7
+        if not byte & 0x80:
+            return value, pos
+
+
+def parse_frame(frame):
+    """Yields (time, channel, value) for each record of a checked frame."""
+    time = int.from_bytes(frame[1:HEADER_LEN], 'little')
+    pos = HEADER_LEN
+    end = len(frame) - CRC_LEN
+    while pos < end:
+        tag, pos = varint(frame, pos)
+        value, pos = varint(frame, pos)
+        channel, kind = tag >> 2, tag & 3
+        if kind == TYPE_TIME:
+            time = (time + value) & 0xFFFFFFFF
+        elif kind == TYPE_INT:
+            yield time, channel, (value >> 1) ^ -(value & 1)
+        elif kind == TYPE_UINT:
+            yield time, channel, value
+        else:
+            raise ValueError('unknown record type %d' % kind)
+
+
+def check_frame(raw):
+    """Returns the frame of the bytes between two delimiters, or None if it is damaged."""
+    frame = cobs_decode(raw)
+    if (frame is None or len(frame) < HEADER_LEN + CRC_LEN or
+            binascii.crc_hqx(frame[:-CRC_LEN], 0xFFFF) != int.from_bytes(frame[-CRC_LEN:], 'big')):
+        return None
+    return frame
+
+
+def frames(stream):
+    """Yields the raw bytes between delimiters."""
+    pending = bytearray()
+    while True:
+        chunk = stream.read(4096)
+        if not chunk:
+            break
+        pending += chunk
+        *complete, rest = pending.split(b'\x00')
+        pending = bytearray(rest)
+        for raw in complete:
+            if raw:
+                yield bytes(raw)
+
+
+def fixed(value, decimals):
+    """Formats a value scaled by 10^decimals, e.g. 2305 with 2 decimals is 23.05."""
+    if not decimals:
+        return str(value)
+    whole, fraction = divmod(abs(value), 10 ** decimals)
+    return '%s%d.%0*d' % ('-' if value < 0 else '', whole, decimals, fraction)
+
+
+def parse_channels(specs):
+    """Parses 'id:name[:decimals]' options."""
+    channels = {}
+    for spec in specs:
+        parts = spec.split(':')
+        decimals = int(parts[2]) if len(parts) > 2 else 0
+        channels[int(parts[0])] = (parts[1], decimals)
+    return channels
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('input', help="capture of the stream, '-' for stdin")
+    parser.add_argument('-c', '--channel', action='append', default=[],
+                        help='id:name[:decimals], e.g. 0:temperature_c:2 for centi-degrees')
+    parser.add_argument('-o', '--output', help='CSV file (default: stdout)')
+    args = parser.parse_args()
+
+    channels = parse_channels(args.channel)
+    source = sys.stdin.buffer if args.input == '-' else open(args.input, 'rb')
+    sink = open(args.output, 'w', newline='') if args.output else sys.stdout
+    writer = csv.writer(sink)
+    writer.writerow(['time', 'channel', 'value'])
+
+    good = bad = lost = 0
+    expected = None
+    for raw in frames(source):
+        frame = check_frame(raw)
+        if frame is None:
+            bad += 1
+            continue
+        try:
+            records = list(parse_frame(frame))
+        except ValueError:
+            bad += 1
+            continue
+
+        if expected is not None:
+            lost += (frame[0] - expected) & 0xFF
+        expected = (frame[0] + 1) & 0xFF
+        good += 1
+
+        for time, channel, value in records:
+            name, decimals = channels.get(channel, (str(channel), 0))
+            text = fixed(value, decimals)
+            writer.writerow([time, name, text])
+
+    sys.stderr.write('%d frames, %d damaged, %d lost\n' % (good, bad, lost))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,194 @@
+/*
+ * Host test of utils/telemetry.c.
+ *
+ *   gcc -O2 -I../utils/inc telemetry_test.c ../utils/src/telemetry.c -o telemetry_test && ./telemetry_test
+ *
+ * The CRC engine is replaced by the same CRC in software (crc.h). Frames are filled with
+ * records of the longest kind: channel TELEMETRY_MAX_CHANNEL (3-byte tag), a value that
+ * takes 5 bytes and a time step that takes 5 bytes before each of them. Each run starts a
+ * frame with a different number of bytes of short records, so the long ones end at every
+ * offset near the end of the frame. Every frame that comes out must fit in TELEMETRY_MAX_ENCODED
+ * bytes, decode to at most TELEMETRY_MAX_FRAME bytes, carry a valid CRC and give back the
+ * records that were put in it.
+ * Prints the result of each frame and returns 1 if anything fails.
+ */
+
+#include "crc.h"
+#include "telemetry.h"
+
+#include <stdio.h>
+
+#define TELEMETRY_TEST_PADDING          28U     // Offsets tried at the start of a frame
+#define TELEMETRY_TEST_LONG_RECORDS     12U     // Long records per run, more than a frame holds
+#define TELEMETRY_TEST_MAX_RECORDS      1024U
+#define TELEMETRY_TEST_TIME_STEP        0x10000000UL    // Smallest step with a 5-byte varint
+
+typedef struct {
+    uint16_t Channel;
+    uint32_t Value;
+    uint32_t Time;
+} TelemetryTestRecord_t;
+
+static Telemetry_t Telemetry;
+static uint8_t Decoded[TELEMETRY_MAX_ENCODED];
+static TelemetryTestRecord_t Sent[TELEMETRY_TEST_MAX_RECORDS];
+static uint32_t SentCount = 0;
+static uint32_t Records = 0;
+static uint32_t Frames = 0;
+static int Failed = 0;
+
+void Crc_Init(void) {
+}
+
+uint16_t Crc_Ccitt(const uint8_t *data, uint16_t len) {
+    uint16_t crc = CRC_CCITT_INIT;
+
+    while (len--) {
+        crc ^= (uint16_t) (*data++ << 8);
+        for (uint8_t bit = 0; bit < 8U; bit++) {
+            crc = (crc & 0x8000U) ? (uint16_t) ((crc << 1) ^ 0x1021U) : (uint16_t) (crc << 1);
+        }
+    }
+
+    return crc;
+}
+
+// Puts an unsigned record and keeps it for the comparison
+static void TelemetryTest_Put(uint16_t channel, uint32_t value, uint32_t time) {
+    if (Telemetry_PutUInt(&Telemetry, channel, value, time) != 1) {
+        printf("record %lu: Telemetry_PutUInt() failed\n", (unsigned long) SentCount);
+        Failed = 1;
+        return;
+    }
+
+    Sent[SentCount].Channel = channel;
+    Sent[SentCount].Value = value;
+    Sent[SentCount].Time = time;
+    SentCount++;
+}
+
+// Reads a varint, or returns 0 if it runs past the end
+static int TelemetryTest_Varint(const uint8_t *data, uint16_t len, uint16_t *pos, uint32_t *value) {
+    *value = 0;
+    for (uint8_t shift = 0; *pos < len && shift < 35U; shift += 7U) {
+        uint8_t byte = data[(*pos)++];
+        *value |= (uint32_t) (byte & 0x7FU) << shift;
+        if (!(byte & 0x80U)) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+// Undoes Telemetry_Cobs(), delimiter excluded
+static uint16_t TelemetryTest_Uncobs(const uint8_t *in, uint16_t len, uint8_t *out) {
+    uint16_t pos = 0;
+    uint16_t i = 0;
+
+    while (i < len) {
+        uint8_t code = in[i++];
+        for (uint8_t n = 1; n < code && i < len; n++) {
+            out[pos++] = in[i++];
+        }
+        if (code != 0xFFU && i < len) {
+            out[pos++] = 0;
+        }
+    }
+
+    return pos;
+}
+
+// Checks a frame and the records in it
+static void TelemetryTest_Write(const uint8_t *data, uint16_t len, void *arg) {
+    (void) arg;
+    uint32_t frame = Frames++;
+    int failed = 0;
+
+    if (len > TELEMETRY_MAX_ENCODED || data[len - 1U] != 0) {
+        printf("frame %lu: %u bytes encoded, limit %u\n", (unsigned long) frame, len,
+               TELEMETRY_MAX_ENCODED);
+        Failed = 1;
+        return;
+    }
+    for (uint16_t i = 0; i + 1U < len; i++) {
+        failed |= data[i] == 0;
+    }
+
+    uint16_t frame_len = TelemetryTest_Uncobs(data, len - 1U, Decoded);
+    if (frame_len > TELEMETRY_MAX_FRAME || frame_len < 7U ||
+        Crc_Ccitt(Decoded, frame_len - 2U) != (uint16_t) (Decoded[frame_len - 2U] << 8 | Decoded[frame_len - 1U])) {
+        printf("frame %lu: %u bytes decoded (limit %u) or bad CRC\n", (unsigned long) frame, frame_len,
+               TELEMETRY_MAX_FRAME);
+        Failed = 1;
+        return;
+    }
+
+    uint32_t time = (uint32_t) Decoded[1] | (uint32_t) Decoded[2] << 8 |
+                    (uint32_t) Decoded[3] << 16 | (uint32_t) Decoded[4] << 24;
+    uint16_t pos = 5U;
+    uint32_t count = 0;
+    failed |= Decoded[0] != (uint8_t) frame;
+
+    while (pos < frame_len - 2U) {
+        uint32_t tag;
+        uint32_t value;
+
+        if (!TelemetryTest_Varint(Decoded, frame_len - 2U, &pos, &tag) ||
+            !TelemetryTest_Varint(Decoded, frame_len - 2U, &pos, &value)) {
+            failed = 1;
+            break;
+        }
+        if (tag == TELEMETRY_TYPE_TIME) {
+            time += value;
+            continue;
+        }
+        if (Records >= SentCount) {
+            failed = 1;
+            break;
+        }
+        failed |= tag != ((uint32_t) Sent[Records].Channel << 2 | TELEMETRY_TYPE_UINT);
+        failed |= value != Sent[Records].Value || time != Sent[Records].Time;
+        Records++;
+        count++;
+    }
+
+    printf("frame %lu: %u bytes, %u encoded, %lu records %s\n", (unsigned long) frame, frame_len, len,
+           (unsigned long) count, failed ? "FAILED" : "OK");
+    Failed |= failed;
+}
+
+int main(void) {
+    uint32_t time = 0;
+
+    Telemetry_Init(&Telemetry, TelemetryTest_Write, NULL);
+
+    for (uint8_t padding = 0; padding < TELEMETRY_TEST_PADDING; padding++) {
+        // Short records at the start time: 2 bytes each, and one of 3 bytes if padding is odd
+        for (uint8_t i = 0; i < padding / 2U; i++) {
+            TelemetryTest_Put(0, i, time);
+        }
+        if (padding & 1U) {
+            TelemetryTest_Put(0, 0x80U, time);
+        }
+
+        // The time wraps like a tick counter, the steps stay the same
+        for (uint8_t i = 0; i < TELEMETRY_TEST_LONG_RECORDS; i++) {
+            time += TELEMETRY_TEST_TIME_STEP;
+            TelemetryTest_Put(TELEMETRY_MAX_CHANNEL, 0xFFFFFFFFUL - i, time);
+        }
+        Telemetry_Flush(&Telemetry);
+    }
+
+    if (Telemetry_PutUInt(&Telemetry, TELEMETRY_MAX_CHANNEL + 1U, 0, 0) != -1) {
+        printf("channel %u was accepted\n", TELEMETRY_MAX_CHANNEL + 1U);
+        Failed = 1;
+    }
+    if (Records != SentCount) {
+        printf("%lu records received instead of %lu\n", (unsigned long) Records, (unsigned long) SentCount);
+        Failed = 1;
+    }
+
+    printf(Failed ? "FAILED\n" : "OK\n");
+    return Failed;
+}
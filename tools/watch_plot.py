@@ -0,0 +1,154 @@
+#!/usr/bin/env python3
+"""Plots the variables sampled by utils/watch.c from the telemetry stream.
+
+The names of the channels are read from the WATCH_VAR() table of the firmware source,
+in order, starting at the first channel of the watch:
+
+    python3 watch_plot.py capture.bin -s ../labs/lab4/lab4_FreeRTOS/src/main.c
+    python3 watch_plot.py /dev/ttyACM0 -b 115200 -s ../labs/lab4/lab4_FreeRTOS/src/main.c
+
+A serial port is plotted live (this needs pyserial). Each variable is drawn as a step
+plot, since it keeps its value between samples. With --csv, or without matplotlib, the
+samples are written as CSV instead: time, name, value.
+"""
+
+import argparse
+import csv
+import os
+import re
+import sys
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import telemetry_decode  # noqa: E402
+
+
+def load_symbols(path, first_channel):
+    """Maps the channels to the names of the WATCH_VAR() entries of a source file."""
+    with open(path) as source:
+        names = re.findall(r'WATCH_VAR\(\s*(\w+)', source.read())
+    return {first_channel + i: name for i, name in enumerate(names)}
+
+
+class Samples:
+    """Decodes the stream as it arrives and keeps the samples of each channel."""
+
+    def __init__(self):
+        self.pending = bytearray()
+        self.series = {}
+        self.good = 0
+        self.bad = 0
+
+    def feed(self, data):
+        self.pending += data
+        *complete, rest = self.pending.split(b'\x00')
+        self.pending = bytearray(rest)
+        for raw in complete:
+            if not raw:
+                continue
+            frame = telemetry_decode.check_frame(bytes(raw))
+            try:
+                records = list(telemetry_decode.parse_frame(frame)) if frame else None
+            except ValueError:
+                records = None
+            if records is None:
+                self.bad += 1
+                continue
+            self.good += 1
+            for time, channel, value in records:
+                times, values = self.series.setdefault(channel, ([], []))
+                times.append(time)
+                values.append(value)
+
+    def last_time(self):
+        return max((times[-1] for times, _ in self.series.values()), default=0)
+
+
+def write_csv(samples, names, path):
+    sink = open(path, 'w', newline='') if path and path != '-' else sys.stdout
+    writer = csv.writer(sink)
+    writer.writerow(['time', 'name', 'value'])
+    rows = [(time, channel, value) for channel, (times, values) in samples.series.items()
+            for time, value in zip(times, values)]
+    for time, channel, value in sorted(rows):
+        writer.writerow([time, names.get(channel, str(channel)), value])
+
+
+def draw(figure, samples, names, tick):
+    """Draws one step plot per channel, held up to the latest sample of the stream."""
+    figure.clear()
+    channels = sorted(set(names) | set(samples.series))
+    end = samples.last_time() * tick
+    for row, channel in enumerate(channels):
+        axis = figure.add_subplot(len(channels), 1, row + 1)
+        times, values = samples.series.get(channel, ([], []))
+        if times:
+            axis.step([t * tick for t in times] + [end], values + values[-1:], where='post')
+        axis.set_ylabel(names.get(channel, str(channel)), rotation=0, ha='right')
+    if channels:
+        axis.set_xlabel('time (s)' if tick != 1 else 'time (ticks)')
+    figure.suptitle('%d frames, %d damaged' % (samples.good, samples.bad))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('input', help="capture of the stream, '-' for stdin, or a serial port")
+    parser.add_argument('-s', '--symbols', help='source file with the WATCH_VAR() table')
+    parser.add_argument('-f', '--first-channel', type=int, default=0,
+                        help='telemetry channel of the first variable (default: 0)')
+    parser.add_argument('-b', '--baud', type=int, default=115200, help='baud rate of a serial port')
+    parser.add_argument('-t', '--tick', type=float, default=0.001,
+                        help='seconds per time unit of the watch (default: 0.001, 1 ms ticks)')
+    parser.add_argument('--csv', nargs='?', const='-', help='write CSV (to a file or stdout)')
+    args = parser.parse_args()
+
+    names = load_symbols(args.symbols, args.first_channel) if args.symbols else {}
+    samples = Samples()
+    live = args.input.startswith('/dev/') or args.input.upper().startswith('COM')
+
+    try:
+        import matplotlib.pyplot as pyplot
+    except ImportError:
+        pyplot = None
+        if args.csv is None:
+            sys.stderr.write('matplotlib is not installed, writing CSV\n')
+
+    if live:
+        import serial
+        plot = args.csv is None and pyplot is not None
+
+        # The plot polls the port between redraws, the CSV waits on it
+        port = serial.Serial(args.input, args.baud, timeout=0 if plot else 0.1)
+        if not plot:
+            # Until interrupted
+            try:
+                while True:
+                    samples.feed(port.read(4096))
+            except KeyboardInterrupt:
+                write_csv(samples, names, args.csv)
+            return
+
+        from matplotlib.animation import FuncAnimation
+        figure = pyplot.figure()
+
+        def update(_):
+            samples.feed(port.read(4096))
+            draw(figure, samples, names, args.tick)
+
+        animation = FuncAnimation(figure, update, interval=200, cache_frame_data=False)  # noqa: F841
+        pyplot.show()
+        return
+
+    source = sys.stdin.buffer if args.input == '-' else open(args.input, 'rb')
+    samples.feed(source.read())
+    sys.stderr.write('%d frames, %d damaged\n' % (samples.good, samples.bad))
+
+    if args.csv is not None or pyplot is None:
+        write_csv(samples, names, args.csv)
+    else:
+        draw(pyplot.figure(), samples, names, args.tick)
+        pyplot.show()
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <stdint.h>
+
+/*
+ * Threshold classification of an analog input with the ADC digital comparators.
+ *
+ * The input range is split into buckets by a list of ascending edges (ADC codes). Sequencer 2
+ * of ADC0 sends every sample of the input to two digital comparators instead of the FIFO:
+ * comparator 0 fires when the sample falls below the window of the current bucket and
+ * comparator 1 when it reaches the top of it. The window is the bucket widened by the
+ * hysteresis on both sides, and it is moved after every crossing, so the CPU is only
+ * interrupted when the bucket changes and a signal hovering at an edge does not chatter.
+ *
+ * Sequencer 2 is triggered by a timer: the application sets up a timer that triggers the
+ * ADC (as in ADC_Init()/Timer0_Init() of the labs), which sets the sampling rate.
+ */
+
+// Most edges supported (buckets = edges + 1)
+#define ADC_BUCKET_MAX_EDGES            8U
+
+// Input number that selects the internal temperature sensor
+#define ADC_BUCKET_TEMP                 0xFFU
+
+// IRQ of ADC0 sequencer 2, which also carries the comparator interrupts
+#define ADC_BUCKET_IRQ                  16U
+#define ADC_BUCKET_PRIO                 5U
+
+/**
+  * @brief  Called when the input moves to another bucket
+  * @param  bucket: New bucket, 0 is below the first edge
+  * @param  arg: Arg of the configuration
+  */
+typedef void (*AdcBucketCallback_t)(uint8_t bucket, void *arg);
+
+typedef struct {
+    uint8_t Input;                              // Analog input (0 to 19) or ADC_BUCKET_TEMP
+    uint16_t Edges[ADC_BUCKET_MAX_EDGES];       // Ascending ADC codes between the buckets
+    uint8_t NumEdges;                           // 1 to ADC_BUCKET_MAX_EDGES
+    uint16_t Hysteresis;                        // ADC codes past an edge needed to cross it
+    AdcBucketCallback_t Callback;
+    void *Arg;
+} AdcBucketConfig_t;
+
+/**
+  * @brief  Takes one sample to find the initial bucket, then hands the input over to the
+  *         digital comparators and enables their interrupt. ADC0 must already be clocked
+  * @param  config: Configuration (copied)
+  * @retval Initial bucket, or -1 if the configuration is invalid
+  */
+int AdcBucket_Init(const AdcBucketConfig_t *config);
+
+/**
+  * @brief  Returns the current bucket
+  * @retval Bucket, 0 is below the first edge
+  */
+uint8_t AdcBucket_Get(void);
+
+/**
+  * @brief  Moves to the neighbouring bucket that the comparators detected, and
+  *         reprograms them around it
+  * @retval None
+  */
+void ADC0Sequence2_Handler(void);
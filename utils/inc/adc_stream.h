@@ -0,0 +1,85 @@
+#pragma once
+
+#include <stdint.h>
+
+/*
+ * High-rate ADC acquisition with uDMA ping-pong buffers.
+ *
+ * A timer (ADC_STREAM_TIMER, clocked from PIOSC) triggers sequencer 0 of ADC0 at a fixed
+ * rate. Each trigger samples every configured channel once, and the uDMA moves the results
+ * from the FIFO straight into one of two buffers in SRAM. When a buffer is full the uDMA
+ * switches to the other one and the completion callback runs once for the whole buffer,
+ * so the CPU is not involved in the individual samples at all.
+ *
+ * The callback runs in the ADC0 sequencer 0 interrupt and must be done with its buffer
+ * before the uDMA fills the other one (Length / NumChannels / RateHz seconds).
+ */
+
+// Sequencer 0 has 8 steps, one per channel
+#define ADC_STREAM_MAX_CHANNELS         8U
+
+// Channel number that selects the internal temperature sensor
+#define ADC_STREAM_TEMP                 0xFFU
+
+// Trigger timer (TIMER5 is not used by the labs) and the clock it counts
+#define ADC_STREAM_TIMER_CLOCK_FREQ     16000000UL
+
+// IRQ of ADC0 sequencer 0, which also signals the uDMA completions
+#define ADC_STREAM_IRQ                  14U
+#define ADC_STREAM_PRIO                 5U
+
+// uDMA channel 14, encoding 0, is served by ADC0 sequencer 0
+#define ADC_STREAM_UDMA_CHANNEL         14U
+#define ADC_STREAM_UDMA_ENCODING        0U
+
+/**
+  * @brief  Called each time a buffer is full
+  * @param  samples: The buffer, interleaved as ch0, ch1, ..., ch0, ch1, ...
+  * @param  count: Number of samples in the buffer
+  * @param  arg: Arg of the configuration
+  */
+typedef void (*AdcStreamCallback_t)(const uint16_t *samples, uint16_t count, void *arg);
+
+typedef struct {
+    uint8_t Channels[ADC_STREAM_MAX_CHANNELS];  // Analog inputs (0 to 19) or ADC_STREAM_TEMP
+    uint8_t NumChannels;                        // 1 to ADC_STREAM_MAX_CHANNELS
+    uint32_t RateHz;                            // Triggers per second (rate of each channel)
+    uint16_t *Buffers[2];                       // Ping-pong buffers
+    uint16_t Length;                            // Samples per buffer: a multiple of NumChannels
+                                                // and at most UDMA_MAX_TRANSFER
+    AdcStreamCallback_t Callback;
+    void *Arg;
+} AdcStreamConfig_t;
+
+/**
+  * @brief  Configures ADC0 sequencer 0, the trigger timer and the uDMA channel.
+  *         The acquisition does not start until AdcStream_Start()
+  * @param  config: Configuration (copied). The buffers must stay valid while streaming
+  * @retval 1 on success, -1 if the configuration is invalid
+  */
+int AdcStream_Init(const AdcStreamConfig_t *config);
+
+/**
+  * @brief  Starts triggering conversions
+  * @retval None
+  */
+void AdcStream_Start(void);
+
+/**
+  * @brief  Stops triggering conversions. A partially filled buffer is not delivered
+  * @retval None
+  */
+void AdcStream_Stop(void);
+
+/**
+  * @brief  Returns the number of times samples were lost: the FIFO of the sequencer
+  *         overflowed, or both buffers were full because a callback took too long
+  * @retval Number of overflows
+  */
+uint32_t AdcStream_GetOverflows(void);
+
+/**
+  * @brief  Re-arms the buffer that the uDMA has just filled and invokes the callback
+  * @retval None
+  */
+void ADC0Sequence0_Handler(void);
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <stdint.h>
+
+/*
+ * Scrolling history chart for the SSD2119 display.
+ *
+ * Samples are decimated (averaged by groups of Ratio) into a fixed-size ring, and every
+ * decimated sample is plotted as one column of the chart. The chart sweeps from left to
+ * right and wraps around: each update only rewrites the column of the newest sample
+ * (background above and below, and the trace joining it to the previous sample), so the
+ * cost of an update is one column of pixels no matter how wide the chart is. The gap in
+ * the trace where the newest column meets the oldest one marks the current position.
+ *
+ * The vertical scroll of the SSD2119 moves the whole panel along its 240 gate lines, which
+ * are the rows of this landscape orientation, so it cannot scroll a time axis within a
+ * window of the screen; the sweep gives the same trend view without moving any pixels.
+ */
+
+// A ring of decimated samples
+typedef struct {
+    int32_t *Samples;
+    uint16_t Size;
+    uint16_t Head;          // Where the next decimated sample goes
+    uint16_t Count;         // Decimated samples stored (at most Size)
+    uint16_t Ratio;         // Inputs averaged into each decimated sample
+    uint16_t Pending;       // Inputs accumulated in Sum so far
+    int32_t Sum;
+} ChartHistory_t;
+
+// Placement and appearance of a chart
+typedef struct {
+    uint16_t X;             // Left column of the plot area
+    uint16_t Y;             // Top row of the plot area
+    uint16_t Width;         // Columns, one per decimated sample
+    uint16_t Height;        // Rows
+    int32_t Min;            // Value drawn on the bottom row
+    int32_t Max;            // Value drawn on the top row (> Min)
+    uint16_t Background;    // Colors (see convertColor() and Color4[])
+    uint16_t Trace;
+    uint16_t Frame;
+} ChartConfig_t;
+
+typedef struct {
+    ChartConfig_t Config;
+    uint16_t Column;        // Column of the next sample
+    uint16_t LastRow;       // Row of the previous sample
+    uint8_t HasLast;
+} Chart_t;
+
+/**
+  * @brief  Initializes an empty history
+  * @param  history: History
+  * @param  samples: Storage for the ring
+  * @param  size: Entries of samples (use at least the width of the chart for Chart_Redraw())
+  * @param  ratio: Number of inputs averaged into each decimated sample (1 keeps all)
+  * @retval None
+  */
+void Chart_HistoryInit(ChartHistory_t *history, int32_t *samples, uint16_t size, uint16_t ratio);
+
+/**
+  * @brief  Adds an input to a history
+  * @param  history: History
+  * @param  value: Input
+  * @param  decimated: Filled with the new decimated sample, if one was completed
+  * @retval 1 if a decimated sample was completed, 0 otherwise
+  */
+uint8_t Chart_HistoryAdd(ChartHistory_t *history, int32_t value, int32_t *decimated);
+
+/**
+  * @brief  Returns a decimated sample of a history
+  * @param  history: History
+  * @param  age: 0 for the newest sample, up to Count - 1 for the oldest
+  * @retval Decimated sample
+  */
+int32_t Chart_HistoryGet(const ChartHistory_t *history, uint16_t age);
+
+/**
+  * @brief  Initializes a chart and draws its frame and empty plot area
+  * @param  chart: Chart
+  * @param  config: Placement and appearance (copied). The frame goes one pixel around the
+  *         plot area, so the area must not touch the edges of the screen
+  * @retval None
+  */
+void Chart_Init(Chart_t *chart, const ChartConfig_t *config);
+
+/**
+  * @brief  Clears the plot area and restarts the sweep at the left edge
+  * @retval None
+  */
+void Chart_Clear(Chart_t *chart);
+
+/**
+  * @brief  Plots a new sample, redrawing one column only
+  * @param  chart: Chart
+  * @param  value: Sample, clamped to [Min, Max]
+  * @retval None
+  */
+void Chart_Push(Chart_t *chart, int32_t value);
+
+/**
+  * @brief  Clears the plot area and plots the newest samples of a history, e.g. after
+  *         the screen was overwritten
+  * @param  chart: Chart
+  * @param  history: History to plot (up to Width samples)
+  * @retval None
+  */
+void Chart_Redraw(Chart_t *chart, const ChartHistory_t *history);
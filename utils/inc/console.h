@@ -0,0 +1,54 @@
+#pragma once
+
+#include <stdint.h>
+
+/*
+ * Polled text output over UART0 (PA0/PA1, routed to the ICDI virtual COM port).
+ *
+ * UART0 is clocked from PIOSC, so the baud rate does not depend on the system clock and
+ * the console works the same in the bare-metal and FreeRTOS projects. Writes wait for
+ * room in the hardware FIFO, so keep them out of interrupt handlers and timing-critical code.
+ *
+ * Console_RingInit() hands the port to uart_ring.h instead, for the modules that stream
+ * through it (shell, deferred log, live watch), with the same pins, clock and baud rate.
+ * From then on Console_Putc() and Console_Puts() queue the text with UART_Write() and
+ * never wait: what does not fit in the transmit ring is dropped, so check UART_TxSpace()
+ * before writing text that must arrive whole. Bulk text (e.g. a report) can go out with
+ * UART_WriteDma() instead, one buffer at a time (CONSOLE_DMA_TASKS), straight from the
+ * buffer of the application.
+ */
+
+#define CONSOLE_CLOCK_FREQ              16000000UL
+#define CONSOLE_BAUDRATE                115200UL
+
+// Longest chain UART_WriteDma() accepts on UART0 after Console_RingInit()
+#define CONSOLE_DMA_TASKS               1U
+
+/**
+  * @brief  Initializes UART0 and pins PA0/PA1 for 8-N-1 at CONSOLE_BAUDRATE
+  * @retval None
+  */
+void Console_Init(void);
+
+/**
+  * @brief  Moves UART0 to interrupt-driven ring buffers (UART_RingInit()) at
+  *         CONSOLE_BAUDRATE from PIOSC, after Console_Init() has routed the pins
+  * @param  tx: Storage of the transmit ring
+  * @param  tx_size: Bytes of tx, a power of two
+  * @param  rx: Storage of the receive ring
+  * @param  rx_size: Bytes of rx, a power of two
+  * @retval 1 on success, -1 if the configuration is invalid
+  */
+int Console_RingInit(uint8_t *tx, uint16_t tx_size, uint8_t *rx, uint16_t rx_size);
+
+/**
+  * @brief  Sends one character (queues it after Console_RingInit())
+  * @retval None
+  */
+void Console_Putc(char c);
+
+/**
+  * @brief  Sends a null-terminated string
+  * @retval None
+  */
+void Console_Puts(const char *s);
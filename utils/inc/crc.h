@@ -0,0 +1,30 @@
+#pragma once
+
+#include <stdint.h>
+
+/*
+ * CRC-16/CCITT computed by the CRC engine of the CCM0 module.
+ *
+ * Polynomial 0x1021, initial value 0xFFFF, no reflection and no final XOR (the variant
+ * known as CRC-16/CCITT-FALSE, e.g. binascii.crc_hqx(data, 0xFFFF) in Python). The engine
+ * takes one byte per register write instead of eight shift-and-XOR steps in software.
+ *
+ * There is a single engine, so the functions must not be called from interrupt handlers
+ * while the main loop may be using them.
+ */
+
+#define CRC_CCITT_INIT                  0xFFFFU
+
+/**
+  * @brief  Enables the clock of the CCM0 module. Calling it again has no effect
+  * @retval None
+  */
+void Crc_Init(void);
+
+/**
+  * @brief  Computes the CRC-16/CCITT of a buffer
+  * @param  data: Bytes
+  * @param  len: Number of bytes
+  * @retval CRC
+  */
+uint16_t Crc_Ccitt(const uint8_t *data, uint16_t len);
@@ -0,0 +1,153 @@
+#pragma once
+
+#include <stdint.h>
+
+/*
+ * Fixed-point filters and streaming statistics for sensor data.
+ *
+ * Noise is removed in software from many cheap conversions instead of by the hardware
+ * averager, which keeps the sequencer busy for every averaged sample. Typically a stream
+ * from adc_stream.h or sampler.h runs at a few kHz, a CIC decimator brings it down to the
+ * rate the application needs (each output averages Ratio^Order inputs with a better
+ * stop-band than a plain boxcar), and a FIR or IIR low-pass smooths what is left.
+ *
+ * Everything is integer arithmetic:
+ *  - CIC: 32-bit integrators and combs, wrap-around is harmless as long as the output fits
+ *  - FIR: Q15 taps on 16-bit samples, two taps per SMLAD on the Cortex-M4
+ *  - IIR: one-pole low-pass y += (x - y) / 2^Shift, with DSP_FRAC_BITS of extra precision
+ *  - Statistics: min, max, mean and variance with Welford's update, mean in Q8
+ */
+
+// Fractional bits of the IIR state and of the mean and variance of the statistics
+#define DSP_FRAC_BITS                   8U
+
+// Highest CIC order, and highest Order * log2(Ratio) for 12-bit inputs (32-bit integrators)
+#define DSP_CIC_MAX_ORDER               3U
+#define DSP_CIC_MAX_GAIN_BITS           20U
+
+// CIC decimator (Order 1 is a boxcar average of Ratio samples)
+typedef struct {
+    uint8_t Order;
+    uint8_t Shift;                          // log2 of the gain Ratio^Order
+    uint16_t Ratio;
+    uint16_t Count;
+    uint32_t Integrators[DSP_CIC_MAX_ORDER];
+    uint32_t Combs[DSP_CIC_MAX_ORDER];
+} DspCic_t;
+
+// FIR filter on a circular history. The history holds every sample twice (2 * NumTaps
+// entries), so the last NumTaps samples are always contiguous
+typedef struct {
+    const int16_t *Taps;                    // Q15 taps, Taps[0] applies to the newest sample
+    int16_t *History;
+    uint16_t NumTaps;                       // Even
+    uint16_t Pos;
+} DspFir_t;
+
+// One-pole IIR low-pass. The time constant is about 2^Shift samples
+typedef struct {
+    int32_t State;                          // Output with DSP_FRAC_BITS fractional bits
+    uint8_t Shift;
+    uint8_t Primed;
+} DspIir_t;
+
+// Running statistics of a signal (samples within +/-2^15)
+typedef struct {
+    uint32_t Count;
+    int32_t Min;
+    int32_t Max;
+    int32_t Mean;                           // Q8
+    uint64_t M2;                            // Sum of squared deviations, Q8
+} DspStats_t;
+
+/**
+  * @brief  Initializes a CIC decimator
+  * @param  cic: Decimator
+  * @param  order: Number of integrator/comb stages, 1 to DSP_CIC_MAX_ORDER
+  * @param  ratio: Decimation ratio, a power of two
+  * @retval 1 on success, -1 if the gain does not fit DSP_CIC_MAX_GAIN_BITS
+  */
+int Dsp_CicInit(DspCic_t *cic, uint8_t order, uint16_t ratio);
+
+/**
+  * @brief  Feeds one sample to a CIC decimator
+  * @param  cic: Decimator
+  * @param  in: Sample (12-bit ADC code)
+  * @param  out: Filled with the average of the last Ratio^Order inputs (weighted by the
+  *         CIC response), in the units of the input, when an output is ready
+  * @retval 1 if an output was produced, 0 otherwise
+  */
+uint8_t Dsp_CicProcess(DspCic_t *cic, uint16_t in, uint16_t *out);
+
+/**
+  * @brief  Decimates a block of samples, e.g. a buffer delivered by adc_stream.h
+  * @param  cic: Decimator
+  * @param  in: Samples
+  * @param  count: Number of samples
+  * @param  stride: Distance between two samples of the signal (NumChannels for an
+  *         interleaved buffer)
+  * @param  out: Outputs, room for count / stride / Ratio + 1 values
+  * @retval Number of outputs written
+  */
+uint16_t Dsp_CicDecimate(DspCic_t *cic, const uint16_t *in, uint16_t count, uint8_t stride, uint16_t *out);
+
+/**
+  * @brief  Initializes a FIR filter and clears its history
+  * @param  fir: Filter
+  * @param  taps: Q15 taps (not copied). A low-pass with unity gain has taps summing to 32767
+  * @param  num_taps: Number of taps, even (pad with a zero tap)
+  * @param  history: Storage for 2 * num_taps samples
+  * @retval 1 on success, -1 if num_taps is 0 or odd
+  */
+int Dsp_FirInit(DspFir_t *fir, const int16_t *taps, uint16_t num_taps, int16_t *history);
+
+/**
+  * @brief  Feeds one sample to a FIR filter
+  * @param  fir: Filter
+  * @param  in: Sample
+  * @retval Filtered sample, saturated to 16 bits
+  */
+int16_t Dsp_FirProcess(DspFir_t *fir, int16_t in);
+
+/**
+  * @brief  Initializes a one-pole IIR low-pass. The first sample sets the output
+  * @param  iir: Filter
+  * @param  shift: log2 of the time constant in samples, 0 to 15
+  * @retval None
+  */
+void Dsp_IirInit(DspIir_t *iir, uint8_t shift);
+
+/**
+  * @brief  Feeds one sample to a one-pole IIR low-pass
+  * @param  iir: Filter
+  * @param  in: Sample (within +/-2^15)
+  * @retval Filtered sample, rounded to the nearest
+  */
+int32_t Dsp_IirProcess(DspIir_t *iir, int32_t in);
+
+/**
+  * @brief  Clears running statistics
+  * @retval None
+  */
+void Dsp_StatsReset(DspStats_t *stats);
+
+/**
+  * @brief  Adds a sample to running statistics
+  * @param  stats: Statistics
+  * @param  in: Sample (within +/-2^15)
+  * @retval None
+  */
+void Dsp_StatsAdd(DspStats_t *stats, int32_t in);
+
+/**
+  * @brief  Returns the mean of the samples added so far
+  * @retval Mean with DSP_FRAC_BITS fractional bits
+  */
+int32_t Dsp_StatsMean(const DspStats_t *stats);
+
+/**
+  * @brief  Returns the sample variance of the samples added so far
+  * @retval Variance with DSP_FRAC_BITS fractional bits (0 with less than two samples),
+  *         saturated to 32 bits
+  */
+uint32_t Dsp_StatsVariance(const DspStats_t *stats);
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <stdint.h>
+
+/*
+ * Fixed-point FFT (Q15) for spectra of sampled signals.
+ *
+ * A complex value is packed in 32 bits, real part in the low half-word and imaginary part
+ * in the high half-word, which is the operand layout of the Cortex-M4 dual 16-bit
+ * instructions: a twiddle multiplication is one SMUSD and one SMUADX, and both outputs of
+ * a butterfly are one SHADD16 and one SHSUB16. Every stage halves its outputs so nothing
+ * can overflow, which makes the result the DFT divided by the number of points.
+ *
+ * The same operations are written in C when the DSP instructions are not available, with
+ * the exact semantics of the instructions, so the results are identical bit for bit on the
+ * target and on a host.
+ *
+ * Typical use on a buffer from adc_stream.h: Fft_Window(), Fft_Transform(), Fft_Magnitude().
+ */
+
+// Largest transform, and size of the shared twiddle table (FFT_MAX_POINTS / 2 entries)
+#define FFT_MAX_POINTS                  1024U
+#define FFT_MIN_POINTS                  4U
+
+// A packed complex value
+typedef uint32_t FftComplex_t;
+
+#define FFT_PACK(RE, IM)                ((uint32_t) (uint16_t) (RE) | ((uint32_t) (uint16_t) (IM) << 16))
+#define FFT_RE(Z)                       ((int16_t) (uint16_t) (Z))
+#define FFT_IM(Z)                       ((int16_t) (uint16_t) ((Z) >> 16))
+
+// Size of a transform and the step through the shared twiddle table
+typedef struct {
+    uint16_t Points;
+    uint8_t Log2;
+    uint16_t Stride;
+} FftPlan_t;
+
+/**
+  * @brief  Prepares a transform. The twiddle table is built the first time
+  * @param  plan: Plan
+  * @param  points: Number of points, a power of two from FFT_MIN_POINTS to FFT_MAX_POINTS
+  * @retval 1 on success, -1 if the number of points is invalid
+  */
+int Fft_Init(FftPlan_t *plan, uint16_t points);
+
+/**
+  * @brief  Converts a block of 12-bit ADC codes to Q15, removes their mean and applies a
+  *         Hann window
+  * @param  plan: Plan
+  * @param  samples: Points samples, spaced by stride
+  * @param  stride: Distance between two samples (NumChannels for an interleaved buffer)
+  * @param  data: Filled with Points complex values (imaginary parts 0)
+  * @retval None
+  */
+void Fft_Window(const FftPlan_t *plan, const uint16_t *samples, uint8_t stride, FftComplex_t *data);
+
+/**
+  * @brief  Computes the FFT in place (radix 2, decimation in time)
+  * @param  plan: Plan
+  * @param  data: Points complex values, replaced by the DFT divided by Points
+  * @retval None
+  */
+void Fft_Transform(const FftPlan_t *plan, FftComplex_t *data);
+
+/**
+  * @brief  Computes the magnitude of the first half of a spectrum (bins 0 to Points/2 - 1,
+  *         the other half mirrors it for a real input)
+  * @param  plan: Plan
+  * @param  data: Output of Fft_Transform()
+  * @param  magnitude: Filled with Points / 2 magnitudes, in Q15
+  * @retval None
+  */
+void Fft_Magnitude(const FftPlan_t *plan, const FftComplex_t *data, uint16_t *magnitude);
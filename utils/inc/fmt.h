@@ -0,0 +1,102 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "uart_ring.h"
+
+/*
+ * Small text formatter without printf.
+ *
+ * Each value is written by a call of its own type (Fmt_Int(), Fmt_Fixed(), ...), so there
+ * is no format string to parse and no varargs that could disagree with it, and no floating
+ * point: fixed-point values (e.g. centi-degrees) are printed as decimals with Fmt_Fixed().
+ * Numbers are converted two digits per step from a table of "00" to "99", which halves the
+ * divisions compared to one digit at a time (and the compiler turns each one into a
+ * multiplication).
+ *
+ * The text goes to a sink: a RAM buffer, a UART ring buffer (uart_ring.h) or the text
+ * cursor of the SSD2119 display (fmt_lcd.h, kept apart so that only the projects with a
+ * display link its driver). Nothing is allocated: the sink lives on the caller's stack.
+ */
+
+// Longest number written by Fmt_Int() or Fmt_Fixed(), e.g. "-21474836.48"
+#define FMT_NUMBER_LEN                  12U
+
+typedef struct FmtSink FmtSink_t;
+
+// Writes characters to the output of a sink
+typedef void (*FmtWrite_t)(FmtSink_t *sink, const char *data, uint16_t len);
+
+struct FmtSink {
+    FmtWrite_t Write;
+    char *Data;             // Buffer sink: storage, kept null-terminated
+    uint16_t Size;          // Buffer sink: size of Data, including the terminator
+    uint16_t Len;           // Characters written so far (stored ones for a buffer sink)
+    UartPort_e Port;        // UART sink: port
+};
+
+/**
+  * @brief  Sets up a sink that writes to a RAM buffer. Text that does not fit is dropped
+  * @param  sink: Sink
+  * @param  data: Buffer, always null-terminated
+  * @param  size: Size of the buffer, at least 1
+  * @retval None
+  */
+void Fmt_BufferSink(FmtSink_t *sink, char *data, uint16_t size);
+
+/**
+  * @brief  Sets up a sink that queues the text with UART_Write(). Text that does not fit
+  *         in the transmit ring is dropped
+  * @param  sink: Sink
+  * @param  port: UART configured by UART_RingInit()
+  * @retval None
+  */
+void Fmt_UartSink(FmtSink_t *sink, UartPort_e port);
+
+/**
+  * @brief  Writes one character
+  * @retval None
+  */
+void Fmt_Char(FmtSink_t *sink, char c);
+
+/**
+  * @brief  Writes a null-terminated string
+  * @retval None
+  */
+void Fmt_Str(FmtSink_t *sink, const char *s);
+
+/**
+  * @brief  Writes an unsigned number in decimal
+  * @retval None
+  */
+void Fmt_UInt(FmtSink_t *sink, uint32_t value);
+
+/**
+  * @brief  Writes a signed number in decimal
+  * @retval None
+  */
+void Fmt_Int(FmtSink_t *sink, int32_t value);
+
+/**
+  * @brief  Writes a fixed-point number in decimal, e.g. 2305 with 2 decimals is "23.05"
+  * @param  sink: Sink
+  * @param  value: Number scaled by 10^decimals
+  * @param  decimals: Digits after the point (0 to 9)
+  * @retval None
+  */
+void Fmt_Fixed(FmtSink_t *sink, int32_t value, uint8_t decimals);
+
+/**
+  * @brief  Writes an unsigned number in hexadecimal (upper case, no prefix)
+  * @param  sink: Sink
+  * @param  value: Number
+  * @param  digits: Minimum number of digits, padded with zeros (0 to 8)
+  * @retval None
+  */
+void Fmt_Hex(FmtSink_t *sink, uint32_t value, uint8_t digits);
+
+/**
+  * @brief  Writes a character several times, e.g. spaces that erase the end of a line
+  * @retval None
+  */
+void Fmt_Repeat(FmtSink_t *sink, char c, uint8_t count);
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "fmt.h"
+
+/*
+ * Sink of fmt.h that prints on the SSD2119 display, at its text cursor (LCD_SetCursor(),
+ * LCD_SetTextColor()).
+ */
+
+/**
+  * @brief  Sets up a sink that prints at the text cursor of the display (LCD_PrintChar())
+  * @param  sink: Sink
+  * @retval None
+  */
+void Fmt_LcdSink(FmtSink_t *sink);
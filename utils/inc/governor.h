@@ -0,0 +1,78 @@
+#pragma once
+
+#include <stdint.h>
+
+/*
+ * Clock governor driven by the die temperature and the measured CPU load.
+ *
+ * The application lists its clock levels from the slowest to the fastest and reports, on
+ * every update (e.g. once per temperature reading), the junction temperature. The load is
+ * measured in between: the main loop brackets its waiting with Governor_IdleEnter() and
+ * Governor_IdleExit(), and the load is the share of the period that was not spent waiting,
+ * timed with the DWT cycle counter (started by Latency_Init()).
+ *
+ * On every update:
+ *  - Above ThrottleCentiC the ceiling drops by one level, below ReleaseCentiC it rises by
+ *    one level, so a hot enclosure settles at the fastest level it can sustain
+ *  - Above HighLoadPct (a backlog) the level rises by one, up to the ceiling
+ *  - The level drops by one when the load, scaled to the slower clock, would stay below
+ *    TargetLoadPct, so the governor does not bounce between two levels
+ * The caller applies the level that Governor_Update() returns (e.g. with PLL_Init()).
+ */
+
+#define GOVERNOR_MAX_LEVELS             8U
+
+typedef struct {
+    uint8_t NumLevels;
+    uint16_t LevelsMHz[GOVERNOR_MAX_LEVELS];    // CPU clock of each level, slowest first
+    int32_t ThrottleCentiC;                     // Lower the ceiling above this temperature
+    int32_t ReleaseCentiC;                      // Raise the ceiling below this temperature
+    uint8_t HighLoadPct;                        // Speed up above this load
+    uint8_t TargetLoadPct;                      // Slow down if the load stays below this
+} GovernorConfig_t;
+
+typedef struct {
+    GovernorConfig_t Config;
+    uint8_t Level;
+    uint8_t Ceiling;
+    uint8_t LoadPct;                            // Load of the last period
+    uint8_t Idle;                               // Between Governor_IdleEnter() and Exit()
+    uint32_t PeriodStart;
+    uint32_t IdleStart;
+    uint32_t IdleCycles;
+} Governor_t;
+
+/**
+  * @brief  Initializes a governor and starts the first load period
+  * @param  governor: Governor
+  * @param  config: Levels and thresholds (copied)
+  * @param  level: Level the clock is currently at
+  * @retval 1 on success, -1 if the configuration is invalid
+  */
+int Governor_Init(Governor_t *governor, const GovernorConfig_t *config, uint8_t level);
+
+/**
+  * @brief  Marks the start of a wait of the main loop (time that does not count as load)
+  * @retval None
+  */
+void Governor_IdleEnter(Governor_t *governor);
+
+/**
+  * @brief  Marks the end of a wait of the main loop
+  * @retval None
+  */
+void Governor_IdleExit(Governor_t *governor);
+
+/**
+  * @brief  Ends the current load period and decides the level for the next one
+  * @param  governor: Governor
+  * @param  centi_c: Junction temperature in centi-degrees Celsius
+  * @retval Level to run at (apply it if it differs from the previous one)
+  */
+uint8_t Governor_Update(Governor_t *governor, int32_t centi_c);
+
+/**
+  * @brief  Returns the load measured over the last period
+  * @retval Load in percent
+  */
+uint8_t Governor_GetLoad(const Governor_t *governor);
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <stdint.h>
+
+/*
+ * Touch-to-photon latency instrumentation.
+ *
+ * A trace follows one input through the application: the touch sample that produced it,
+ * the delivery of the event to the application, the FSM step that consumes it, and the
+ * end of the LCD burst that shows the result. Each stage is timestamped with the DWT
+ * cycle counter (free-running at the CPU clock, no peripheral needed) and the latency
+ * from the touch sample to that stage is added to a per-stage histogram kept in RAM.
+ *
+ * Stages must be marked in order. LATENCY_STAGE_TOUCH may be marked on every poll: it only
+ * remembers the time of the sample, and a trace is opened by the LATENCY_STAGE_DISPATCH
+ * mark that follows it. Marks that are out of order are ignored, so the hooks can sit in
+ * code that also runs without any input (e.g. the drawing after a timed transition).
+ */
+
+// Stages of a trace
+typedef enum {
+    LATENCY_STAGE_TOUCH,        // Touch sample read from the panel
+    LATENCY_STAGE_DISPATCH,     // Event delivered to the application
+    LATENCY_STAGE_FSM,          // FSM step that consumed the input
+    LATENCY_STAGE_PHOTON,       // LCD burst that shows the result has finished
+    LATENCY_NUM_STAGES
+} LatencyStage_e;
+
+// Bucket <i> counts latencies in [2^i, 2^(i+1)) us, bucket 0 also counts 0 us, and the last
+// bucket counts everything above. 24 buckets cover up to ~8 s
+#define LATENCY_NUM_BUCKETS             24U
+
+// Histogram of the latency from the touch sample to one stage
+typedef struct {
+    uint32_t Count;
+    uint32_t MinUs;
+    uint32_t MaxUs;
+    uint32_t SumUs;
+    uint32_t Buckets[LATENCY_NUM_BUCKETS];
+} LatencyHist_t;
+
+// Writes one character to the output used by Latency_Dump()
+typedef void (*LatencyPutc_t)(char c);
+
+/**
+  * @brief  Starts the DWT cycle counter and clears the histograms
+  * @param  cpu_hz: Frequency of the CPU clock, used to convert cycles to us
+  * @retval None
+  */
+void Latency_Init(uint32_t cpu_hz);
+
+/**
+  * @brief  Returns the DWT cycle counter started by Latency_Init(), e.g. to time a
+  *         piece of code outside of a trace
+  * @retval CPU cycles (wraps around)
+  */
+uint32_t Latency_Cycles(void);
+
+/**
+  * @brief  Clears the histograms and drops the trace in progress
+  * @retval None
+  */
+void Latency_Reset(void);
+
+/**
+  * @brief  Timestamps a stage of the current trace
+  * @param  stage: Stage that has just been reached
+  * @retval 1 if this mark completed a trace (LATENCY_STAGE_PHOTON), 0 otherwise
+  */
+uint8_t Latency_Mark(LatencyStage_e stage);
+
+/**
+  * @brief  Drops the trace in progress, e.g. when an input is discarded
+  * @retval None
+  */
+void Latency_Abort(void);
+
+/**
+  * @brief  Returns the histogram of a stage (the one of LATENCY_STAGE_TOUCH stays empty)
+  * @retval Pointer to the histogram (read-only)
+  */
+const LatencyHist_t *Latency_GetHist(LatencyStage_e stage);
+
+/**
+  * @brief  Prints every histogram as text, one line per non-empty bucket
+  * @param  put: Function that outputs one character (e.g. to a UART)
+  * @retval None
+  */
+void Latency_Dump(LatencyPutc_t put);
+
+/**
+  * @brief  Prints what Latency_Dump() prints into a buffer, e.g. to queue the report on a
+  *         UART in one piece once its length is known
+  * @param  buf: Destination (not null-terminated)
+  * @param  size: Bytes of buf
+  * @retval Number of characters, 0 if the report does not fit in size
+  */
+uint16_t Latency_Format(char *buf, uint16_t size);
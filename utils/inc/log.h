@@ -0,0 +1,128 @@
+#pragma once
+
+#include <stdint.h>
+
+/*
+ * Deferred logging: a log statement stores a compact record in RAM, and the text is only
+ * produced on the host.
+ *
+ *   LOG("fsm %u -> %u", present_state, next_state);
+ *
+ * The format string is never read on the device. It is placed in the LOG_STRINGS section
+ * and its address serves as its ID, so a record is a few words:
+ *   header (address of the format | number of arguments << 28) | cycle counter | arguments
+ * Arguments are integers, up to LOG_MAX_ARGS, stored as 32-bit words. The host formats
+ * them with %d %i %u %x %X %o %c %p, with flags and widths; %s takes the address of a
+ * string that lives in flash (a const string). There is no %f: pass fixed-point values
+ * as integers, e.g. LOG("%d centi-C", celsius).
+ *
+ * A log statement costs a few tens of cycles: it reserves room in a ring of words with a
+ * compare-and-swap (LDREX/STREX), stores the words and writes the header last, which
+ * marks the record as complete. It never blocks and never disables interrupts, so it can
+ * be called from tasks and interrupt handlers alike; a record that does not fit is
+ * dropped and counted. The reader only takes complete records, so a record that an
+ * interrupted context is still writing holds back the ones behind it until it is done.
+ *
+ * Log_Drain() runs in a low-priority context (the main loop, an idle task). It moves the
+ * oldest records into a frame in the telemetry format (crc.h, COBS, 0x00 delimiter):
+ *   sequence (1 byte) | records lost since the last frame (2 bytes, little endian) |
+ *   records (words, little endian) | CRC (2 bytes, big endian)
+ * tools/log_decode.py reads the format strings from the ELF file of the firmware and
+ * prints the records as text.
+ */
+
+// Words of the record ring, a power of two
+#define LOG_RING_WORDS                  256U
+
+// Most arguments of a log statement
+#define LOG_MAX_ARGS                    4U
+
+// Largest frame before encoding (header, records and CRC)
+#define LOG_MAX_FRAME                   128U
+
+// COBS adds one byte per 254 bytes (and one at the start), plus the delimiter
+#define LOG_MAX_ENCODED                 (LOG_MAX_FRAME + LOG_MAX_FRAME / 254U + 2U)
+
+// Places a format string in the LOG_STRINGS section, where the host looks it up
+#if defined(__ICCARM__)
+#define LOG_STRING(NAME, FMT)           _Pragma("location=\"LOG_STRINGS\"") \
+                                        static const char NAME[] = FMT
+#elif defined(__GNUC__)
+#define LOG_STRING(NAME, FMT)           static const char NAME[] \
+                                        __attribute__((section("LOG_STRINGS"), used)) = FMT
+#else
+#define LOG_STRING(NAME, FMT)           static const char NAME[] = FMT
+#endif
+
+// Header of a record: the address of the format string (in flash, below 0x10000000)
+// and the number of arguments
+#define LOG_HEADER(FMT, NARGS)          ((uint32_t) (uintptr_t) (FMT) | ((uint32_t) (NARGS) << 28))
+
+// LOG(format, arguments...): picks the variant for the number of arguments
+#define LOG(...)                        LOG_PICK(__VA_ARGS__, LOG_4, LOG_3, LOG_2, LOG_1, LOG_0, _)(__VA_ARGS__)
+#define LOG_PICK(_0, _1, _2, _3, _4, NAME, ...) NAME
+
+#define LOG_0(FMT)                      do { LOG_STRING(log_fmt_, FMT); \
+                                             Log_Write0(LOG_HEADER(log_fmt_, 0)); } while (0)
+#define LOG_1(FMT, A)                   do { LOG_STRING(log_fmt_, FMT); \
+                                             Log_Write1(LOG_HEADER(log_fmt_, 1), (uint32_t) (A)); } while (0)
+#define LOG_2(FMT, A, B)                do { LOG_STRING(log_fmt_, FMT); \
+                                             Log_Write2(LOG_HEADER(log_fmt_, 2), (uint32_t) (A), \
+                                                        (uint32_t) (B)); } while (0)
+#define LOG_3(FMT, A, B, C)             do { LOG_STRING(log_fmt_, FMT); \
+                                             Log_Write3(LOG_HEADER(log_fmt_, 3), (uint32_t) (A), \
+                                                        (uint32_t) (B), (uint32_t) (C)); } while (0)
+#define LOG_4(FMT, A, B, C, D)          do { LOG_STRING(log_fmt_, FMT); \
+                                             Log_Write4(LOG_HEADER(log_fmt_, 4), (uint32_t) (A), \
+                                                        (uint32_t) (B), (uint32_t) (C), \
+                                                        (uint32_t) (D)); } while (0)
+
+/**
+  * @brief  Receives each encoded frame, delimiter included
+  * @param  data: Frame
+  * @param  len: Number of bytes
+  * @param  arg: Arg given to Log_Init()
+  */
+typedef void (*LogWrite_t)(const uint8_t *data, uint16_t len, void *arg);
+
+/**
+  * @brief  Empties the ring and initializes the CRC engine. The records are timestamped
+  *         with Latency_Cycles(), so Latency_Init() must have started the cycle counter
+  * @param  write: Where the encoded frames go (e.g. a UART)
+  * @param  arg: Passed to write
+  * @retval None
+  */
+void Log_Init(LogWrite_t write, void *arg);
+
+/**
+  * @brief  Stores a record, use the LOG() macro instead. Safe from interrupt handlers
+  * @param  header: LOG_HEADER() of the record
+  * @retval None
+  */
+void Log_Write0(uint32_t header);
+void Log_Write1(uint32_t header, uint32_t a);
+void Log_Write2(uint32_t header, uint32_t a, uint32_t b);
+void Log_Write3(uint32_t header, uint32_t a, uint32_t b, uint32_t c);
+void Log_Write4(uint32_t header, uint32_t a, uint32_t b, uint32_t c, uint32_t d);
+
+/**
+  * @brief  Sends the oldest complete records in one frame. Call it from a single
+  *         low-priority context, the one that uses the CRC engine
+  * @param  room: Bytes the output can take now (e.g. UART_TxSpace()). The frame is made
+  *         to fit, and the records that do not fit stay in the ring
+  * @retval Number of records sent, 0 if there were none or room is too small
+  */
+uint8_t Log_Drain(uint16_t room);
+
+/**
+  * @brief  Checks if complete records are waiting, e.g. to leave a wait of the main loop
+  * @retval 1 if Log_Drain() has records to send, 0 otherwise
+  */
+uint8_t Log_Pending(void);
+
+/**
+  * @brief  Returns the number of records dropped because the ring was full, since
+  *         Log_Init(). The frames report the same losses as they happen
+  * @retval Number of records
+  */
+uint32_t Log_GetDropped(void);
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <stdint.h>
+
+/*
+ * Multi-channel sampling scheduler on ADC0 and ADC1.
+ *
+ * Channels are described by a table (input, rate, ring buffer). A timer ticks at
+ * SAMPLER_TICK_HZ and, on every tick, the channels that are due are packed into the steps
+ * of ADC0 sequencer 1 (4 steps) and ADC1 sequencer 0 (8 steps), which convert in parallel.
+ * When a sequence ends, its samples are pushed to the ring buffer of each channel together
+ * with the tick they were taken on. Adding a sensor is one more line in the table: the
+ * number of sequencers and ISRs stays the same.
+ *
+ * Channels of the same rate are spread over different ticks, so the steps are not all
+ * needed on the same tick. Each ring buffer has a single producer (the sequencer ISR) and
+ * a single consumer (Sampler_Read()), so no locking is needed between them.
+ *
+ * ADC0 sequencers 0, 2 and 3 and ADC1 sequencer 3 are left to the other users of the ADCs
+ * (adc_stream.h, adc_bucket.h, the labs and the touch driver). The sample rate and the
+ * hardware averaging of a module are shared by its sequencers and are not changed here:
+ * on ADC1 they follow the profile of the touch driver (Touch_SetProfile()).
+ */
+
+// Base rate: every channel rate must divide it
+#define SAMPLER_TICK_HZ                 1000UL
+
+// Clock of the tick timer (TIMER4, clocked from PIOSC)
+#define SAMPLER_CLOCK_FREQ              16000000UL
+
+// 4 steps of ADC0 sequencer 1 and 8 steps of ADC1 sequencer 0
+#define SAMPLER_MAX_CHANNELS            12U
+
+// Input number that selects the internal temperature sensor
+#define SAMPLER_TEMP                    0xFFU
+
+// Priority of the tick timer and of both sequencer interrupts
+#define SAMPLER_PRIO                    5U
+
+// A timestamped sample
+typedef struct {
+    uint32_t Tick;          // Tick of the sample (SAMPLER_TICK_HZ ticks per second)
+    uint16_t Value;         // 12-bit ADC code
+} SamplerSample_t;
+
+// A channel of the table given to Sampler_Init()
+typedef struct {
+    uint8_t Input;              // Analog input (0 to 19) or SAMPLER_TEMP
+    uint32_t RateHz;            // Samples per second, must divide SAMPLER_TICK_HZ
+    SamplerSample_t *Buffer;    // Storage of the ring buffer
+    uint16_t Size;              // Entries of Buffer, a power of two (holds Size - 1 samples)
+} SamplerChannel_t;
+
+/**
+  * @brief  Configures the timer and the sequencers for a table of channels. Sampling
+  *         does not start until Sampler_Start()
+  * @param  channels: Table of channels (copied). Channel ids are the indexes in the table
+  * @param  count: Number of channels, at most SAMPLER_MAX_CHANNELS
+  * @retval 1 on success, -1 if the table is invalid
+  */
+int Sampler_Init(const SamplerChannel_t *channels, uint8_t count);
+
+/**
+  * @brief  Starts the tick timer
+  * @retval None
+  */
+void Sampler_Start(void);
+
+/**
+  * @brief  Stops the tick timer. Samples already taken stay in the ring buffers
+  * @retval None
+  */
+void Sampler_Stop(void);
+
+/**
+  * @brief  Takes the oldest sample of a channel out of its ring buffer
+  * @param  channel: Id of the channel
+  * @param  sample: Filled with the sample
+  * @retval 1 if a sample was read, 0 if the ring buffer is empty
+  */
+uint8_t Sampler_Read(uint8_t channel, SamplerSample_t *sample);
+
+/**
+  * @brief  Returns the number of samples waiting in the ring buffer of a channel
+  * @retval Number of samples
+  */
+uint16_t Sampler_Available(uint8_t channel);
+
+/**
+  * @brief  Returns the number of samples of a channel that were lost, either because
+  *         its ring buffer was full or because a sequencer was still busy on a tick
+  * @retval Number of samples lost
+  */
+uint32_t Sampler_GetDropped(uint8_t channel);
+
+/**
+  * @brief  Returns the current tick
+  * @retval Ticks since Sampler_Start() was first called
+  */
+uint32_t Sampler_GetTick(void);
+
+/**
+  * @brief  Packs the channels due on this tick into the sequencers and triggers them
+  * @retval None
+  */
+void Timer4A_Handler(void);
+
+/**
+  * @brief  Delivers the samples of ADC0 sequencer 1 to the ring buffers
+  * @retval None
+  */
+void ADC0Sequence1_Handler(void);
+
+/**
+  * @brief  Delivers the samples of ADC1 sequencer 0 to the ring buffers
+  * @retval None
+  */
+void ADC1Sequence0_Handler(void);
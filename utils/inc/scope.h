@@ -0,0 +1,127 @@
+#pragma once
+
+#include <stdint.h>
+
+/*
+ * Single-channel oscilloscope on ADC0 and the SSD2119 display.
+ *
+ * The input is captured continuously by adc_stream.h (timer-triggered ADC0 sequencer 0 and
+ * uDMA ping-pong buffers). In the completion callback, a trigger kernel looks for a level
+ * crossing in the selected direction, with hysteresis so that noise around the level does
+ * not re-trigger. The SCOPE_WIDTH samples that follow the trigger are copied into the frame
+ * buffer, possibly across several DMA buffers, and the capture stops until the frame has
+ * been drawn. In auto mode a frame is taken anyway when no trigger is found for
+ * SCOPE_AUTO_BUFFERS buffers, so a flat or slow signal still shows up.
+ *
+ * Scope_Render() draws one sample per column as a vertical segment joining it to the
+ * previous sample. For every column, only the pixels of the previous trace that the new
+ * trace does not cover are erased, so a steady signal costs almost nothing to redraw.
+ *
+ * The frame buffer is handed from the interrupt to the main loop through a state variable:
+ * the callback only writes it while capturing, Scope_Render() only reads it once it is ready.
+ */
+
+// Samples per frame, one per column of the display
+#define SCOPE_WIDTH                     300U
+
+// Samples per DMA buffer: the callback runs RateHz / SCOPE_BUFFER_LEN times per second
+#define SCOPE_BUFFER_LEN                256U
+
+// Buffers searched without finding a trigger before auto mode takes a frame anyway
+#define SCOPE_AUTO_BUFFERS              8U
+
+// Highest value of a sample
+#define SCOPE_FULL_SCALE                4095U
+
+// Direction of the trigger crossing
+typedef enum {
+    SCOPE_EDGE_RISING,
+    SCOPE_EDGE_FALLING
+} ScopeEdge_e;
+
+// Trigger settings and the state kept between buffers
+typedef struct {
+    uint16_t Level;         // ADC code of the crossing
+    uint16_t Hysteresis;    // How far past the level the signal must go to re-arm
+    ScopeEdge_e Edge;
+    uint8_t Primed;         // The signal has been on the far side of the level
+} ScopeTrigger_t;
+
+typedef struct {
+    uint8_t Input;          // Analog input (0 to 19). Its pin is configured as analog
+    uint32_t RateHz;        // Samples per second
+    ScopeTrigger_t Trigger;
+    uint8_t Auto;           // Free-running frames when there is no trigger
+    uint16_t X;             // Left column of the trace area
+    uint16_t Y;             // Top row of the trace area
+    uint16_t Height;        // Rows of the trace area, at most 256
+    uint16_t Background;    // Colors (see convertColor() and Color4[])
+    uint16_t Trace;
+} ScopeConfig_t;
+
+/**
+  * @brief  Looks for a trigger crossing in a block of samples. The state of the trigger
+  *         carries over to the next block, so a crossing may span two blocks
+  * @param  trigger: Trigger settings and state
+  * @param  samples: Samples
+  * @param  count: Number of samples
+  * @retval Index of the first sample past the crossing, or -1 if there is none
+  */
+int32_t Scope_FindTrigger(ScopeTrigger_t *trigger, const uint16_t *samples, uint16_t count);
+
+/**
+  * @brief  Configures the input pin and the acquisition, and clears the trace area.
+  *         The acquisition does not start until Scope_Start()
+  * @param  config: Configuration (copied)
+  * @retval 1 on success, -1 if the configuration is invalid
+  */
+int Scope_Init(const ScopeConfig_t *config);
+
+/**
+  * @brief  Starts the acquisition
+  * @retval None
+  */
+void Scope_Start(void);
+
+/**
+  * @brief  Stops the acquisition
+  * @retval None
+  */
+void Scope_Stop(void);
+
+/**
+  * @brief  Changes the sampling rate. The acquisition is restarted if it was running
+  * @param  rate_hz: Samples per second
+  * @retval 1 on success, -1 if the rate is invalid
+  */
+int Scope_SetRate(uint32_t rate_hz);
+
+/**
+  * @brief  Returns the sampling rate
+  * @retval Samples per second
+  */
+uint32_t Scope_GetRate(void);
+
+/**
+  * @brief  Changes the trigger level and direction. Takes effect on the next frame
+  * @retval None
+  */
+void Scope_SetTrigger(uint16_t level, ScopeEdge_e edge);
+
+/**
+  * @brief  Draws the captured frame, if one is ready, and arms the next capture
+  * @retval 1 if a frame was drawn, 0 otherwise
+  */
+uint8_t Scope_Render(void);
+
+/**
+  * @brief  Returns the number of frames drawn since Scope_Init()
+  * @retval Number of frames
+  */
+uint32_t Scope_GetFrames(void);
+
+/**
+  * @brief  Returns the number of samples captured since Scope_Init()
+  * @retval Number of samples
+  */
+uint32_t Scope_GetSamples(void);
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "uart_ring.h"
+#include "fmt.h"
+
+/*
+ * Command shell on a UART configured by UART_RingInit(), to inspect and tune an
+ * application while it runs.
+ *
+ * Shell_Poll() takes the received characters out of the receive ring and edits a line
+ * with them (echo, backspace), at most SHELL_POLL_BYTES per call, and runs the line when
+ * it ends. Replies are queued with UART_Write() and never waited on: a reply that does
+ * not fit in the transmit ring is cut short. Listings (help, get) are written a line at
+ * a time, only while the transmit ring has SHELL_REPLY_ROOM bytes free, so a long one
+ * takes several polls but no line is cut. Nothing blocks, so Shell_Poll() can be called
+ * from the main loop at any rate; the receive ring holds what arrives in between.
+ *
+ * Built-in commands:
+ *   help                   lists the commands
+ *   get                    lists the variables and their values
+ *   get <name>             prints a variable
+ *   set <name> <value>     changes a variable, within its range
+ * The application adds its own commands, and its variables: a name with a getter and,
+ * unless it is a read-only counter, a setter that applies the new value (e.g. reloads a
+ * timer). Both tables are const, so they stay in flash.
+ */
+
+// Longest command line, terminator included
+#define SHELL_LINE_LEN                  48U
+
+// Most words on a command line, the command included
+#define SHELL_MAX_ARGS                  4U
+
+// Characters handled per Shell_Poll()
+#define SHELL_POLL_BYTES                16U
+
+// Room a line of a listing needs in the transmit ring
+#define SHELL_REPLY_ROOM                80U
+
+typedef struct Shell Shell_t;
+
+/**
+  * @brief  Runs a command of the application. Replies go to shell->Out (fmt.h)
+  * @param  shell: Shell
+  * @param  argc: Number of words, the command included
+  * @param  argv: Words, argv[0] is the command
+  * @retval 1 on success, -1 to print "error"
+  */
+typedef int (*ShellHandler_t)(Shell_t *shell, uint8_t argc, char *argv[]);
+
+typedef struct {
+    const char *Name;
+    const char *Help;           // One line, shown by help
+    ShellHandler_t Handler;
+} ShellCommand_t;
+
+typedef struct {
+    const char *Name;
+    const char *Help;           // One line, shown by get
+    int32_t (*Get)(void);
+    int (*Set)(int32_t value);  // Returns 1, or -1 to refuse the value. NULL if read-only
+    int32_t Min;                // Range accepted by set
+    int32_t Max;
+    uint8_t Decimals;           // The value is scaled by 10^Decimals, e.g. 2 for centi-degrees
+} ShellVar_t;
+
+typedef struct {
+    UartPort_e Port;
+    const ShellCommand_t *Commands;
+    uint8_t NumCommands;
+    const ShellVar_t *Vars;
+    uint8_t NumVars;
+} ShellConfig_t;
+
+struct Shell {
+    ShellConfig_t Config;
+    FmtSink_t Out;              // Replies, queued on the UART
+    char Line[SHELL_LINE_LEN];
+    uint8_t Len;
+    uint8_t Overflow;           // The line was longer than SHELL_LINE_LEN
+    uint8_t LastCr;             // The last character was a CR, so a LF after it is skipped
+    uint8_t Listing;            // Listing in progress, written over several polls
+    uint8_t ListIndex;
+};
+
+/**
+  * @brief  Initializes a shell and prints its prompt
+  * @param  shell: Shell
+  * @param  config: Port and tables (copied). The tables must stay valid
+  * @retval None
+  */
+void Shell_Init(Shell_t *shell, const ShellConfig_t *config);
+
+/**
+  * @brief  Handles the characters received since the last call, and continues a listing
+  * @retval None
+  */
+void Shell_Poll(Shell_t *shell);
+
+/**
+  * @brief  Checks if Shell_Poll() has work to do, e.g. to leave a wait of the main loop
+  * @retval 1 if characters are waiting, or if a listing is in progress and the transmit
+  *         ring has room for its next line. 0 otherwise, also while a listing waits for
+  *         room (characters received meanwhile wait for the listing)
+  */
+uint8_t Shell_Busy(const Shell_t *shell);
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <stdint.h>
+
+/*
+ * Lock-free handoff of the latest sample from an ISR to the main loop.
+ *
+ * The snapshot is a sequence lock with a single writer: the ISR makes the sequence odd,
+ * writes the sample and makes it even again. The main loop copies the sample between two
+ * reads of the sequence and retries if the sequence was odd or changed in between, which
+ * can only happen if the ISR ran during the copy. Neither side ever masks interrupts, so
+ * formatting and printing the sample no longer delay any interrupt.
+ *
+ * The writer must not be interrupted by another writer of the same snapshot. On the
+ * single-core Cortex-M4 the accesses of an ISR and of the code it interrupts are seen in
+ * program order, so the volatile accesses are enough and no memory barrier is needed.
+ */
+
+// A sample and the time it was taken (in any unit chosen by the writer)
+typedef struct {
+    int32_t Value;
+    uint32_t Timestamp;
+} SnapshotSample_t;
+
+typedef struct {
+    volatile uint32_t Sequence;     // Odd while a sample is being written
+    volatile int32_t Value;
+    volatile uint32_t Timestamp;
+} Snapshot_t;
+
+/**
+  * @brief  Empties a snapshot (a zero-initialized snapshot is empty too)
+  * @retval None
+  */
+void Snapshot_Init(Snapshot_t *snapshot);
+
+/**
+  * @brief  Publishes a new sample. Only call from the single writer (e.g. one ISR)
+  * @param  snapshot: Snapshot
+  * @param  value: Sample
+  * @param  timestamp: Time of the sample
+  * @retval None
+  */
+void Snapshot_Publish(Snapshot_t *snapshot, int32_t value, uint32_t timestamp);
+
+/**
+  * @brief  Checks if a sample was published since the last one read
+  * @param  snapshot: Snapshot
+  * @param  seen: Sequence returned by the last Snapshot_Read() (0 initially)
+  * @retval 1 if there is a new sample, 0 otherwise
+  */
+uint8_t Snapshot_IsNew(const Snapshot_t *snapshot, uint32_t seen);
+
+/**
+  * @brief  Copies the latest sample, consistently, without masking interrupts
+  * @param  snapshot: Snapshot
+  * @param  sample: Filled with the latest sample
+  * @param  seen: Sequence of the last sample read (0 initially), updated to this one
+  * @retval 1 if the sample is new since *seen, 0 if it was already read or there is none
+  */
+uint8_t Snapshot_Read(const Snapshot_t *snapshot, SnapshotSample_t *sample, uint32_t *seen);
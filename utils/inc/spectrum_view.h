@@ -0,0 +1,48 @@
+#pragma once
+
+#include <stdint.h>
+
+/*
+ * Bar-graph view of a magnitude spectrum on the SSD2119 display.
+ *
+ * The bins are grouped into bars (the largest bin of a group sets the height of its bar)
+ * and heights follow log2 of the magnitude, so weak components stay visible next to strong
+ * ones. The view remembers the height of every bar and only draws the difference: a bar
+ * that grew gets the new part painted, a bar that shrank gets the old top erased, and a
+ * bar that did not change is not touched at all.
+ */
+
+#define SPECTRUM_VIEW_MAX_BARS          64U
+
+typedef struct {
+    uint16_t X;             // Left column of the first bar
+    uint16_t Y;             // Top row of the view
+    uint16_t Height;        // Rows
+    uint8_t NumBars;        // 1 to SPECTRUM_VIEW_MAX_BARS
+    uint8_t BarWidth;       // Columns of a bar
+    uint8_t Gap;            // Columns between two bars
+    uint16_t Background;    // Colors (see convertColor() and Color4[])
+    uint16_t Bar;
+} SpectrumViewConfig_t;
+
+typedef struct {
+    SpectrumViewConfig_t Config;
+    uint16_t Heights[SPECTRUM_VIEW_MAX_BARS];
+} SpectrumView_t;
+
+/**
+  * @brief  Initializes a view and clears its area
+  * @param  view: View
+  * @param  config: Placement and appearance (copied)
+  * @retval 1 on success, -1 if the configuration is invalid
+  */
+int SpectrumView_Init(SpectrumView_t *view, const SpectrumViewConfig_t *config);
+
+/**
+  * @brief  Shows a new spectrum, drawing only what changed
+  * @param  view: View
+  * @param  magnitude: Magnitudes (e.g. from Fft_Magnitude()), bin 0 (DC) is skipped
+  * @param  bins: Number of magnitudes
+  * @retval Number of bars that were redrawn
+  */
+uint8_t SpectrumView_Update(SpectrumView_t *view, const uint16_t *magnitude, uint16_t bins);
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <stdint.h>
+
+/*
+ * Compact binary telemetry: tagged, timestamped integer records in COBS frames.
+ *
+ * Records are appended to a frame in RAM. Each record is a tag followed by a value, both
+ * as LEB128 varints (7 bits per byte, low bits first):
+ *  - tag = channel << 2 | type, so channels 0 to 31 take a single byte
+ *  - TELEMETRY_TYPE_INT values are zigzag-encoded (-1 -> 1, 1 -> 2, ...), so small
+ *    negative numbers stay short
+ *  - A TELEMETRY_TYPE_TIME record (channel 0) advances the time of the records that
+ *    follow it by its value. It is only emitted when the time changes, so the channels
+ *    sampled on the same tick share it
+ * A temperature in centi-degrees then takes 3 bytes, against about 32 as a text line.
+ *
+ * A frame is:
+ *   sequence (1 byte) | start time (4 bytes, little endian) | records | CRC (2 bytes, big endian)
+ * The CRC is the CRC-16/CCITT of everything before it, computed by the hardware engine
+ * (crc.h). The frame is then COBS-encoded, which removes every 0x00 byte, and followed
+ * by a single 0x00 delimiter. A receiver that loses bytes resynchronizes at the next
+ * delimiter, and drops the damaged frame because its CRC does not match. A gap in the
+ * sequence numbers tells how many frames were lost.
+ *
+ * tools/telemetry_decode.py turns a captured stream back into CSV.
+ */
+
+// Largest frame before encoding (sequence, start time, records and CRC)
+#define TELEMETRY_MAX_FRAME             128U
+
+// COBS adds one byte per 254 bytes (and one at the start), plus the delimiter
+#define TELEMETRY_MAX_ENCODED           (TELEMETRY_MAX_FRAME + TELEMETRY_MAX_FRAME / 254U + 2U)
+
+// Largest channel number
+#define TELEMETRY_MAX_CHANNEL           0x3FFFU
+
+// Types of record (low 2 bits of the tag)
+#define TELEMETRY_TYPE_INT              0U      // Signed value, zigzag-encoded
+#define TELEMETRY_TYPE_UINT             1U      // Unsigned value
+#define TELEMETRY_TYPE_TIME             2U      // Time step since the previous record
+
+/**
+  * @brief  Receives each encoded frame, delimiter included
+  * @param  data: Frame
+  * @param  len: Number of bytes
+  * @param  arg: Arg given to Telemetry_Init()
+  */
+typedef void (*TelemetryWrite_t)(const uint8_t *data, uint16_t len, void *arg);
+
+typedef struct {
+    TelemetryWrite_t Write;
+    void *Arg;
+    uint8_t Frame[TELEMETRY_MAX_FRAME];
+    uint8_t Encoded[TELEMETRY_MAX_ENCODED];
+    uint16_t Len;                   // Bytes in Frame, 0 if no frame is open
+    uint8_t Sequence;
+    uint32_t Time;                  // Time of the last record of the open frame
+} Telemetry_t;
+
+/**
+  * @brief  Initializes a telemetry stream and the CRC engine
+  * @param  telemetry: Stream
+  * @param  write: Where the encoded frames go (e.g. a UART)
+  * @param  arg: Passed to write
+  * @retval None
+  */
+void Telemetry_Init(Telemetry_t *telemetry, TelemetryWrite_t write, void *arg);
+
+/**
+  * @brief  Adds a signed record. A full frame is sent first
+  * @param  telemetry: Stream
+  * @param  channel: Channel (0 to TELEMETRY_MAX_CHANNEL)
+  * @param  value: Value
+  * @param  time: Time of the value, in ticks chosen by the application (must not decrease)
+  * @retval 1 on success, -1 if the channel is invalid
+  */
+int Telemetry_PutInt(Telemetry_t *telemetry, uint16_t channel, int32_t value, uint32_t time);
+
+/**
+  * @brief  Adds an unsigned record. A full frame is sent first
+  * @retval 1 on success, -1 if the channel is invalid
+  */
+int Telemetry_PutUInt(Telemetry_t *telemetry, uint16_t channel, uint32_t value, uint32_t time);
+
+/**
+  * @brief  Closes the open frame, if any, and sends it
+  * @retval None
+  */
+void Telemetry_Flush(Telemetry_t *telemetry);
+
+/**
+  * @brief  COBS-encodes a buffer and appends the 0x00 delimiter
+  * @param  in: Bytes to encode
+  * @param  len: Number of bytes
+  * @param  out: Destination, at least len + len / 254 + 2 bytes
+  * @retval Number of bytes written, delimiter included
+  */
+uint16_t Telemetry_Cobs(const uint8_t *in, uint16_t len, uint8_t *out);
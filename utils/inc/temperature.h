@@ -0,0 +1,63 @@
+#pragma once
+
+#include <stdint.h>
+
+/*
+ * Fixed-point conversion of the on-chip temperature sensor.
+ *
+ * The datasheet formula TEMP = 147.5 - (247.5 * ADCCODE) / 4096 is evaluated in integer
+ * arithmetic, in hundredths of a degree (centi-degrees). Nothing here touches the FPU or
+ * the software double-precision library, so the conversion is safe and cheap in ISRs.
+ */
+
+// Converts whole degrees to centi-degrees, e.g. for thresholds: TEMP_CENTI(20) is 20.00 C
+#define TEMP_CENTI(DEGREES)             ((int32_t) (DEGREES) * 100L)
+
+// Sensor formula in centi-degrees: 147.50 C - 247.50 C * code / 2^12
+#define TEMP_OFFSET_CENTI_C             14750L
+#define TEMP_SLOPE_CENTI_C              24750L
+#define TEMP_ADC_BITS                   12U
+
+// Inverse of the sensor formula, usable in constant expressions (e.g. for thresholds):
+// ADC code of a temperature in centi-degrees Celsius (-100.00 C to 147.50 C), rounded
+#define TEMP_CENTI_TO_ADC(CENTI_C)      ((uint16_t) (((TEMP_OFFSET_CENTI_C - (CENTI_C)) * 4096L + \
+                                                      TEMP_SLOPE_CENTI_C / 2) / TEMP_SLOPE_CENTI_C))
+
+// Number of ADC codes spanned by a temperature difference in centi-degrees
+#define TEMP_DELTA_TO_ADC(CENTI_C)      ((uint16_t) (((CENTI_C) * 4096L + TEMP_SLOPE_CENTI_C / 2) / \
+                                                     TEMP_SLOPE_CENTI_C))
+
+// Sample-and-hold time of an ADC step that reads the sensor (TSHn field of ADCSSTSHn):
+// 16 ADC clocks, the minimum the sensor needs. Other inputs can keep the default of 4
+#define TEMP_ADC_TSH                    0x4UL
+
+// Longest string written by Temp_Format(), including the terminator ("-21474836.48")
+#define TEMP_STR_LEN                    13U
+
+/**
+  * @brief  Converts a 12-bit code of the temperature sensor to Celsius
+  * @param  code: ADC code (0 to 4095)
+  * @retval Temperature in centi-degrees Celsius, rounded to the nearest
+  */
+static inline int32_t Temp_AdcToCentiC(uint32_t code) {
+    return TEMP_OFFSET_CENTI_C -
+           (int32_t) ((code * TEMP_SLOPE_CENTI_C + (1UL << (TEMP_ADC_BITS - 1U))) >> TEMP_ADC_BITS);
+}
+
+/**
+  * @brief  Converts Celsius to Fahrenheit (F = C * 9 / 5 + 32)
+  * @param  centi_c: Temperature in centi-degrees Celsius
+  * @retval Temperature in centi-degrees Fahrenheit, rounded to the nearest
+  */
+static inline int32_t Temp_CentiCToCentiF(int32_t centi_c) {
+    int32_t scaled = centi_c * 9L;
+    return (scaled >= 0 ? scaled + 2L : scaled - 2L) / 5L + 3200L;
+}
+
+/**
+  * @brief  Writes a temperature as text with two decimals, e.g. "23.05" or "-4.10"
+  * @param  buffer: Destination, at least TEMP_STR_LEN characters
+  * @param  centi: Temperature in centi-degrees
+  * @retval Number of characters written, not counting the terminator
+  */
+uint8_t Temp_Format(char *buffer, int32_t centi);
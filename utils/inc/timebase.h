@@ -0,0 +1,33 @@
+#pragma once
+
+#include <stdint.h>
+
+/*
+ * Millisecond timebase for bare-metal applications, driven by SysTick.
+ *
+ * SysTick is clocked from PIOSC / 4 (4 MHz) rather than from the system clock, so the
+ * time keeps running at the same rate when PLL_Init() changes the system clock.
+ * Do not use with FreeRTOS, which owns SysTick (use xTaskGetTickCount() instead).
+ */
+
+#define TIMEBASE_CLOCK_FREQ             4000000UL
+#define TIMEBASE_TICK_HZ                1000UL
+#define TIMEBASE_PRIO                   5U
+
+/**
+  * @brief  Starts SysTick as a 1 ms periodic interrupt
+  * @retval None
+  */
+void Timebase_Init(void);
+
+/**
+  * @brief  Returns the number of milliseconds since Timebase_Init()
+  * @retval Time in ms (wraps around after ~49 days)
+  */
+uint32_t Timebase_Millis(void);
+
+/**
+  * @brief  Counts the elapsed milliseconds
+  * @retval None
+  */
+void SysTick_Handler(void);
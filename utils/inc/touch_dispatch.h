@@ -0,0 +1,125 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "touch_gesture.h"
+
+/*
+ * Touch event dispatcher for the SSD2119 resistive touch panel.
+ *
+ * Regions (buttons) are registered once together with a callback. Each region is
+ * indexed in a coarse grid laid over the raw touch coordinates, so finding the region
+ * under a touch only inspects the regions that overlap a single grid cell instead of
+ * walking every button on every poll.
+ *
+ * Samples go through the gesture recognizer (touch_gesture.h) first, so regions receive
+ * debounced and filtered events, and the timing of long-presses comes from the timestamp
+ * of each sample rather than from a hardware timer per button.
+ *
+ * Coordinates are the raw 12-bit values returned by Touch_ReadX()/Touch_ReadY(), the
+ * same units used by the *_LIMIT macros of the labs.
+ */
+
+// Maximum number of regions that can be registered (one bit per region in each cell)
+#define TOUCH_MAX_REGIONS               32U
+
+// Grid geometry: the 12-bit coordinate space is split into cells of 2^TOUCH_GRID_SHIFT counts
+#define TOUCH_RAW_BITS                  12U
+#define TOUCH_GRID_SHIFT                9U
+#define TOUCH_GRID_SIZE                 (1U << (TOUCH_RAW_BITS - TOUCH_GRID_SHIFT))
+
+// Returned when a coordinate does not hit any region, or when registration fails
+#define TOUCH_NO_REGION                 (-1)
+
+// Events generated by the dispatcher
+typedef enum {
+    TOUCH_EVENT_PRESS,
+    TOUCH_EVENT_RELEASE,
+    TOUCH_EVENT_LONG_PRESS,
+    TOUCH_EVENT_DRAG,
+    TOUCH_EVENT_TAP,        // Sent to the region where the tap happened, before the release
+    TOUCH_EVENT_SWIPE,      // Sent to the region where the swipe started
+    TOUCH_EVENT_REPEAT      // Long-press still held (TouchDispatch_SetRepeat())
+} TouchEvent_e;
+
+// Describes a single event delivered to a region's callback
+typedef struct {
+    TouchEvent_e Type;
+    uint16_t X;
+    uint16_t Y;
+    int16_t DX;             // Drag: displacement since the last drag event
+    int16_t DY;             // Swipe: displacement since the press
+    uint32_t Timestamp;     // Time (ms) passed to TouchDispatch_Process()
+} TouchEvent_t;
+
+// Callback invoked from TouchDispatch_Process() for the region that captured the touch
+typedef void (*TouchCallback_t)(int8_t region, const TouchEvent_t *event, void *arg);
+
+// A rectangular region. The limits are exclusive: Left < x < Right and Bottom < y < Top
+typedef struct {
+    uint16_t Left;
+    uint16_t Right;
+    uint16_t Bottom;
+    uint16_t Top;
+    TouchCallback_t Callback;
+    void *Arg;
+} TouchRegion_t;
+
+/**
+  * @brief  Removes every registered region and resets the dispatcher state
+  * @retval None
+  */
+void TouchDispatch_Reset(void);
+
+/**
+  * @brief  Registers a region and indexes it in the grid. Regions registered first
+  *         win when two regions overlap
+  * @param  region: Region to register (copied)
+  * @retval Id of the region, or TOUCH_NO_REGION if the table is full or the region is invalid
+  */
+int8_t TouchDispatch_Register(const TouchRegion_t *region);
+
+/**
+  * @brief  Sets how long (ms) a region must be held before a long-press event is generated
+  * @param  ms: Hold time in milliseconds
+  * @retval None
+  */
+void TouchDispatch_SetLongPress(uint32_t ms);
+
+/**
+  * @brief  Sets how often (ms) a region held past the long-press gets a repeat event,
+  *         like a held key
+  * @param  ms: Period in milliseconds, 0 for no repeats (the default)
+  * @retval None
+  */
+void TouchDispatch_SetRepeat(uint32_t ms);
+
+/**
+  * @brief  Replaces the configuration of the gesture recognizer used by the dispatcher
+  *         (tap and swipe timing, slop, debouncing)
+  * @retval None
+  */
+void TouchDispatch_SetGestureConfig(const TouchGestureConfig_t *config);
+
+/**
+  * @brief  Finds the region under a raw touch coordinate
+  * @param  x, y: Raw touch coordinates
+  * @retval Id of the region, or TOUCH_NO_REGION
+  */
+int8_t TouchDispatch_HitTest(unsigned long x, unsigned long y);
+
+/**
+  * @brief  Feeds one touch sample to the dispatcher, which generates press, release,
+  *         long-press and drag events and invokes the callback of the region involved
+  * @param  x, y: Raw touch coordinates
+  * @param  now: Current time in milliseconds (any free-running millisecond counter)
+  * @retval None
+  */
+void TouchDispatch_Process(unsigned long x, unsigned long y, uint32_t now);
+
+/**
+  * @brief  Reads the touch panel and feeds the sample to TouchDispatch_Process()
+  * @param  now: Current time in milliseconds
+  * @retval None
+  */
+void TouchDispatch_Poll(uint32_t now);
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <stdint.h>
+
+/*
+ * Touch gesture recognizer.
+ *
+ * Raw samples are first filtered (debounce of finger down/up and a 3-tap median per axis)
+ * and then fed to a small state machine that recognizes taps, long-presses, drags and
+ * swipes. A long-press can repeat, like a held key, every RepeatMs until the finger lifts
+ * or moves. All the state lives in a TouchGesture_t, so the memory used is fixed and known
+ * at compile time, and the only notion of time is the millisecond timestamp passed with
+ * each sample: no hardware timer is needed.
+ *
+ * Coordinates are raw touch coordinates (see touch_dispatch.h). Swipe directions are given
+ * in raw coordinates too: SWIPE_RIGHT means X increased and SWIPE_UP means Y increased.
+ */
+
+// Samples outside of this window mean that no finger is on the panel
+#define GESTURE_RAW_MIN                     200U
+#define GESTURE_RAW_MAX                     3900U
+
+// Default configuration
+#define GESTURE_LONG_PRESS_DEFAULT_MS       2000U
+#define GESTURE_REPEAT_DEFAULT_MS           0U      // No repeat
+#define GESTURE_TAP_MAX_DEFAULT_MS          300U
+#define GESTURE_SWIPE_MAX_DEFAULT_MS        500U
+#define GESTURE_SLOP_DEFAULT                64U
+#define GESTURE_SWIPE_MIN_DEFAULT           400U
+#define GESTURE_DEBOUNCE_DOWN_DEFAULT       2U
+#define GESTURE_DEBOUNCE_UP_DEFAULT         2U
+
+// Length of the median filter
+#define GESTURE_MEDIAN_LEN                  3U
+
+// Gestures reported by TouchGesture_Process()
+typedef enum {
+    GESTURE_DOWN,           // A finger landed on the panel
+    GESTURE_UP,             // The finger lifted after a long-press or a slow drag
+    GESTURE_TAP,            // The finger lifted quickly without moving
+    GESTURE_LONG_PRESS,     // The finger has been held still for LongPressMs
+    GESTURE_DRAG,           // The finger moved by at least SlopCounts
+    GESTURE_SWIPE,          // The finger lifted after a fast and long drag
+    GESTURE_REPEAT          // The finger is still held RepeatMs after the last (long-)press
+} TouchGesture_e;
+
+typedef enum {
+    SWIPE_LEFT,
+    SWIPE_RIGHT,
+    SWIPE_DOWN,
+    SWIPE_UP
+} TouchSwipe_e;
+
+typedef struct {
+    TouchGesture_e Type;
+    TouchSwipe_e Direction;     // Swipe only
+    uint16_t X;                 // Filtered position of the finger
+    uint16_t Y;
+    int16_t DX;                 // Drag: movement since the previous drag event
+    int16_t DY;                 // Swipe: movement since the finger landed
+    uint32_t Duration;          // Time (ms) since the finger landed
+    uint32_t Timestamp;         // Time (ms) of the sample that produced the gesture
+} TouchGestureEvent_t;
+
+typedef struct {
+    uint32_t LongPressMs;       // Hold time of a long-press
+    uint32_t RepeatMs;          // Period of the repeats after a long-press, 0 for none
+    uint32_t TapMaxMs;          // Longest press that is still a tap
+    uint32_t SwipeMaxMs;        // Longest drag that is still a swipe
+    uint16_t SlopCounts;        // Movement tolerated before a press becomes a drag
+    uint16_t SwipeMinCounts;    // Shortest movement that is a swipe
+    uint8_t DebounceDown;       // Consecutive touched samples needed for a finger down
+    uint8_t DebounceUp;         // Consecutive untouched samples needed for a finger up
+} TouchGestureConfig_t;
+
+// State of a recognizer. Treat as opaque, except for reading X, Y and State
+typedef struct {
+    TouchGestureConfig_t Config;
+    uint16_t HistX[GESTURE_MEDIAN_LEN];
+    uint16_t HistY[GESTURE_MEDIAN_LEN];
+    uint8_t HistLen;
+    uint8_t HistPos;
+    uint8_t TouchedCount;
+    uint8_t UntouchedCount;
+    uint8_t State;
+    uint16_t X;
+    uint16_t Y;
+    uint16_t StartX;
+    uint16_t StartY;
+    uint16_t LastX;
+    uint16_t LastY;
+    uint32_t DownTime;
+    uint32_t RepeatTime;        // Time of the last long-press or repeat
+} TouchGesture_t;
+
+/**
+  * @brief  Initializes a recognizer
+  * @param  gesture: Recognizer to initialize
+  * @param  config: Configuration, or NULL to use the defaults
+  * @retval None
+  */
+void TouchGesture_Init(TouchGesture_t *gesture, const TouchGestureConfig_t *config);
+
+/**
+  * @brief  Fills a configuration with the default values
+  * @retval None
+  */
+void TouchGesture_DefaultConfig(TouchGestureConfig_t *config);
+
+/**
+  * @brief  Feeds one raw sample to the recognizer
+  * @param  gesture: Recognizer
+  * @param  x, y: Raw touch coordinates
+  * @param  now: Current time in milliseconds
+  * @param  event: Filled with the recognized gesture, if any
+  * @retval 1 if a gesture was recognized, 0 otherwise
+  */
+uint8_t TouchGesture_Process(TouchGesture_t *gesture, unsigned long x, unsigned long y,
+                             uint32_t now, TouchGestureEvent_t *event);
+
+/**
+  * @brief  Checks whether a finger is currently on the panel (after debouncing)
+  * @retval 1 if the finger is down, 0 otherwise
+  */
+uint8_t TouchGesture_IsDown(const TouchGesture_t *gesture);
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "uart_ring.h"
+
+/*
+ * Full-duplex bridge between two UARTs (e.g. UART0 on the ICDI and UART3 on a Bluetooth
+ * module).
+ *
+ * Both ports are set up with UART_RingInit(), so their interrupts move the bytes between
+ * the FIFOs and the ring buffers on their own. UartBridge_Poll() moves whatever each
+ * receive ring holds to the other port's transmit ring, never more than fits, so the
+ * main loop only copies blocks and nothing is dropped on the way. When one side is faster
+ * than the other the receive ring of the fast side fills up: with flow control its RTS
+ * then pauses the sender, without it the bytes that do not fit are dropped and counted
+ * by UART_GetRxOverruns().
+ */
+
+// Bytes moved per copy in UartBridge_Poll() (taken from the stack)
+#define UART_BRIDGE_CHUNK               32U
+
+typedef struct {
+    UartPort_e PortA;
+    UartPort_e PortB;
+} UartBridge_t;
+
+/**
+  * @brief  Joins two ports configured by UART_RingInit()
+  * @param  bridge: Bridge
+  * @param  a, b: Ports, which must be different
+  * @retval 1 on success, -1 if the ports are the same
+  */
+int UartBridge_Init(UartBridge_t *bridge, UartPort_e a, UartPort_e b);
+
+/**
+  * @brief  Forwards the received bytes in both directions, as many as the transmit rings
+  *         can take. Call it from the main loop, often enough that the receive rings do
+  *         not fill up (a 64-byte ring lasts 5.5 ms at 115200 baud)
+  * @retval Number of bytes forwarded
+  */
+uint16_t UartBridge_Poll(UartBridge_t *bridge);
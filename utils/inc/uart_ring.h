@@ -0,0 +1,245 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "udma.h"
+
+/*
+ * Interrupt-driven UART with software ring buffers.
+ *
+ * Each port gets a transmit and a receive ring buffer supplied by the application, and
+ * runs with its hardware FIFOs enabled. UART_Write() copies the data into the transmit
+ * ring, tops up the hardware FIFO and returns at once; the UART interrupt refills the FIFO
+ * every time it drains to the transmit watermark, so the CPU is interrupted once per
+ * UART_TX_BURST bytes instead of waiting on every byte. Received bytes are moved to the
+ * receive ring when the FIFO reaches the receive watermark, or when the line has been
+ * quiet for 32 bit times with bytes still waiting in the FIFO (receive time-out).
+ *
+ * Each ring has a single producer and a single consumer (the main loop and the UART
+ * interrupt), so the ring indexes need no locking. The interrupt mask of the UART and the
+ * uDMA state are changed by both sides, though: UART_Write(), UART_WriteDma() and
+ * UART_Read() mask the interrupt of the port at the NVIC for the few instructions that
+ * change them. These functions must not be called from interrupt handlers.
+ *
+ * With FlowControl set, the UART drives RTS and obeys CTS. When the receive ring is full
+ * the interrupt stops emptying the FIFO instead of dropping bytes: the FIFO fills up, RTS
+ * tells the sender to pause, and reception resumes once UART_Read() has made room. The
+ * RTS/CTS pins must be routed to the UART by the application as well.
+ *
+ * Framed traffic can bypass the receive ring too. A port given a pool of message buffers
+ * receives into them instead: the interrupt copies the bytes from the FIFO straight into
+ * the current buffer, and hands it over when the line goes idle (receive time-out, i.e.
+ * the end of a burst) or when it is full. UART_ReceiveMessage() returns the buffers in
+ * order by pointer, and UART_ReleaseMessage() gives them back to the pool. Each byte is
+ * copied once, and the CPU is interrupted about once per UART_RX_BATCH bytes. A receive
+ * interrupt leaves at least one byte in the FIFO, so that the time-out still fires at the
+ * end of a burst. Bytes that arrive while no buffer is free are dropped and counted, so
+ * the pool must cover the backlog of the consumer (flow control does not pause here).
+ *
+ * Bulk transfers (e.g. telemetry dumps) can bypass the ring: UART_WriteDma() hands a
+ * chain of buffers to the uDMA, which feeds the FIFO from them in peripheral scatter-gather
+ * mode, and a callback runs once the last byte is in the FIFO. The CPU does not touch the
+ * individual bytes. Ports that should support it are given storage for the uDMA task list
+ * in their configuration. Order is kept with the ring: the chain starts once the bytes
+ * queued before it have gone out, and bytes queued while it runs follow it.
+ *
+ * Each port is clocked from PIOSC (16 MHz), whose baud rate does not depend on the system
+ * clock, or from the system clock, which reaches higher rates: up to clock / 16, or clock / 8
+ * in high-speed mode (HSE, 8 samples per bit instead of 16), e.g. 7.5 Mbit/s at 60 or 120
+ * MHz. The divisor is computed for the clock, rounded to the nearest 1/64. Normal mode is
+ * kept when it is within UART_RING_TARGET_ERROR, since 16 samples per bit tolerate more
+ * noise; HSE is used when normal mode cannot reach the rate or misses it by more, and
+ * does better. UART_GetBaudError() reports the error that results.
+ *
+ * UART_SetSystemClock() must be told about every change of the system clock (PLL_Init()
+ * does it), and recomputes the divisors of the ports that use it. The bytes on the wire
+ * during the change are garbled: wait for UART_TxDone() first if that matters.
+ *
+ * The pins must be routed to the UART by the application.
+ */
+
+#define UART_RING_NUM_PORTS             8U
+
+// Frequency of PIOSC, also the system clock until UART_SetSystemClock() says otherwise
+#define UART_RING_PIOSC_FREQ            16000000UL
+
+// Baud rate errors in ppm: normal mode is kept up to the target, and a rate that misses
+// by more than the maximum is refused (the receiver samples in the wrong bit otherwise)
+#define UART_RING_TARGET_ERROR          1000L
+#define UART_RING_MAX_ERROR             15000L
+
+// Priority of the UART interrupts
+#define UART_RING_PRIO                  6U
+
+// The transmit interrupt fires when the 16-byte FIFO drains to 1/4 (4 bytes left), and
+// the receive interrupt when it fills to 1/2 (8 bytes)
+#define UART_TX_BURST                   12U
+
+// Bytes taken from the FIFO per receive interrupt in message mode, one less than the
+// watermark so that the FIFO is never emptied before the time-out
+#define UART_RX_BATCH                   7U
+
+// Data bytes of a message buffer
+#define UART_MSG_SIZE                   48U
+
+// Most message buffers in the pool of a port
+#define UART_MSG_MAX_COUNT              15U
+
+typedef enum {
+    UART_PORT_0,
+    UART_PORT_1,
+    UART_PORT_2,
+    UART_PORT_3,
+    UART_PORT_4,
+    UART_PORT_5,
+    UART_PORT_6,
+    UART_PORT_7
+} UartPort_e;
+
+typedef enum {
+    UART_CLOCK_PIOSC,
+    UART_CLOCK_SYSTEM
+} UartClock_e;
+
+// A received message. Bursts longer than UART_MSG_SIZE take several buffers
+typedef struct {
+    uint16_t Length;                // Bytes in Data
+    uint8_t EndOfBurst;             // 1 if the line went idle after Data, 0 if the burst goes on
+    uint8_t Data[UART_MSG_SIZE];
+} UartMessage_t;
+
+typedef struct {
+    uint32_t BaudRate;
+    UartClock_e ClockSource;
+    uint8_t *TxBuffer;      // Storage of the transmit ring
+    uint16_t TxSize;        // Bytes of TxBuffer, a power of two (holds TxSize - 1 bytes)
+    uint8_t *RxBuffer;      // Storage of the receive ring, may be NULL with MsgPool
+    uint16_t RxSize;        // Bytes of RxBuffer, a power of two (holds RxSize - 1 bytes)
+    UDMA_Entry_t *DmaTasks; // Storage of the uDMA task list, NULL to disable UART_WriteDma()
+    uint8_t DmaMaxTasks;    // Entries of DmaTasks: the longest chain UART_WriteDma() accepts
+    uint8_t FlowControl;    // 1 to use RTS/CTS hardware flow control
+    UartMessage_t *MsgPool; // Message buffers, NULL to receive into the ring instead
+    uint8_t MsgCount;       // Entries of MsgPool, 1 to UART_MSG_MAX_COUNT
+} UartRingConfig_t;
+
+// A buffer of a chain sent by UART_WriteDma()
+typedef struct {
+    const uint8_t *Data;
+    uint16_t Length;        // 1 to UDMA_MAX_TRANSFER bytes
+} UartSegment_t;
+
+/**
+  * @brief  Called from the UART interrupt when the uDMA has moved the last byte of a
+  *         chain to the FIFO. The buffers can be reused from then on
+  * @param  port: UART that sent the chain
+  * @param  arg: Arg given to UART_WriteDma()
+  */
+typedef void (*UartDmaCallback_t)(UartPort_e port, void *arg);
+
+/**
+  * @brief  Configures a UART for 8-N-1 with FIFOs and interrupts and enables it
+  * @param  port: UART to configure
+  * @param  config: Baud rate and ring buffers (copied). The buffers must stay valid
+  * @retval 1 on success, -1 if the configuration is invalid or the baud rate cannot be
+  *         reached from the clock within UART_RING_MAX_ERROR
+  */
+int UART_RingInit(UartPort_e port, const UartRingConfig_t *config);
+
+/**
+  * @brief  Records a new system clock frequency and recomputes the divisors of the ports
+  *         clocked from it. Call it after every change of the system clock
+  * @param  freq: System clock, in Hz
+  * @retval 1 on success, -1 if a port cannot reach its baud rate at this clock. That port
+  *         keeps its old divisor, so it runs at a wrong rate until the clock changes again
+  */
+int UART_SetSystemClock(uint32_t freq);
+
+/**
+  * @brief  Returns the baud rate a port actually runs at, from its clock and divisor
+  * @retval Baud rate, in bits/s
+  */
+uint32_t UART_GetBaudRate(UartPort_e port);
+
+/**
+  * @brief  Returns the difference between the actual and the configured baud rate
+  * @retval Error, in ppm of the configured rate (negative if slower)
+  */
+int32_t UART_GetBaudError(UartPort_e port);
+
+/**
+  * @brief  Queues bytes for transmission without waiting
+  * @param  port: UART configured by UART_RingInit()
+  * @param  data: Bytes to send
+  * @param  len: Number of bytes
+  * @retval Number of bytes queued, less than len if the transmit ring is full
+  */
+uint16_t UART_Write(UartPort_e port, const uint8_t *data, uint16_t len);
+
+/**
+  * @brief  Sends a chain of buffers with the uDMA, after the bytes already queued
+  * @param  port: UART configured by UART_RingInit() with DmaTasks
+  * @param  segments: Buffers to send in order. The buffers (not the array) must stay
+  *         valid until the callback
+  * @param  count: Number of buffers, 1 to DmaMaxTasks
+  * @param  callback: Called when the chain is done, may be NULL
+  * @param  arg: Passed to the callback
+  * @retval 1 on success, -1 if a chain is already in progress or the request is invalid
+  */
+int UART_WriteDma(UartPort_e port, const UartSegment_t *segments, uint8_t count,
+                  UartDmaCallback_t callback, void *arg);
+
+/**
+  * @brief  Checks if a chain given to UART_WriteDma() is still waiting or in progress
+  * @retval 1 if busy, 0 otherwise
+  */
+uint8_t UART_DmaBusy(UartPort_e port);
+
+/**
+  * @brief  Takes received bytes out of the receive ring without waiting
+  * @param  port: UART configured by UART_RingInit()
+  * @param  data: Where to copy the bytes
+  * @param  len: Maximum number of bytes to copy
+  * @retval Number of bytes copied, 0 if nothing was received
+  */
+uint16_t UART_Read(UartPort_e port, uint8_t *data, uint16_t len);
+
+/**
+  * @brief  Takes the oldest received message, without waiting
+  * @param  port: UART configured by UART_RingInit() with MsgPool
+  * @retval Message, NULL if none is complete. It belongs to the caller until
+  *         UART_ReleaseMessage()
+  */
+UartMessage_t *UART_ReceiveMessage(UartPort_e port);
+
+/**
+  * @brief  Gives a message returned by UART_ReceiveMessage() back to the pool
+  * @retval None
+  */
+void UART_ReleaseMessage(UartPort_e port, UartMessage_t *message);
+
+/**
+  * @brief  Returns the room left in the transmit ring, e.g. to write whole messages only
+  * @retval Number of bytes UART_Write() can take now
+  */
+uint16_t UART_TxSpace(UartPort_e port);
+
+/**
+  * @brief  Returns the number of bytes waiting in the receive ring
+  * @retval Number of bytes UART_Read() can return now
+  */
+uint16_t UART_RxCount(UartPort_e port);
+
+/**
+  * @brief  Checks if everything queued has left the wire
+  * @retval 1 if the transmit ring, any uDMA chain and the FIFO are done and the UART is
+  *         idle, 0 otherwise
+  */
+uint8_t UART_TxDone(UartPort_e port);
+
+/**
+  * @brief  Returns the number of received bytes that were lost, because the receive ring
+  *         or the hardware FIFO was full, or no message buffer was free. With flow control
+  *         and a receive ring only the FIFO can overflow, when the sender ignores RTS
+  * @retval Number of lost bytes (overruns of the FIFO count as one)
+  */
+uint32_t UART_GetRxOverruns(UartPort_e port);
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <stdint.h>
+
+/*
+ * Shared uDMA controller setup.
+ *
+ * The control table (a primary and an alternate entry per channel) must be aligned to
+ * 1024 bytes and exist only once, so every module that uses uDMA goes through this one.
+ * Each module then owns the channels it assigns with UDMA_AssignChannel().
+ */
+
+#define UDMA_NUM_CHANNELS               32U
+
+// Largest number of items in a single transfer
+#define UDMA_MAX_TRANSFER               1024U
+
+// IRQ number of the uDMA error interrupt
+#define UDMA_ERROR_IRQ                  45U
+#define UDMA_ERROR_PRIO                 5U
+
+// Control table entry: the end pointers are inclusive (address of the last item)
+typedef struct {
+    volatile const void *SrcEnd;
+    volatile void *DstEnd;
+    volatile uint32_t Control;
+    uint32_t Unused;
+} UDMA_Entry_t;
+
+/**
+  * @brief  Enables the uDMA controller and points it to the control table.
+  *         Calling it again has no effect
+  * @retval None
+  */
+void UDMA_Init(void);
+
+/**
+  * @brief  Selects which peripheral drives a channel, and resets the attributes of the
+  *         channel (default priority, single and burst requests, primary entry first)
+  * @param  channel: uDMA channel (0 to 31)
+  * @param  encoding: Peripheral encoding of the channel (see the channel assignment table)
+  * @retval None
+  */
+void UDMA_AssignChannel(uint8_t channel, uint8_t encoding);
+
+/**
+  * @brief  Returns the primary entry of a channel
+  * @retval Pointer to the entry
+  */
+UDMA_Entry_t *UDMA_Primary(uint8_t channel);
+
+/**
+  * @brief  Returns the alternate entry of a channel (used by ping-pong transfers)
+  * @retval Pointer to the entry
+  */
+UDMA_Entry_t *UDMA_Alternate(uint8_t channel);
+
+/**
+  * @brief  Enables a channel so it starts serving the requests of its peripheral
+  * @retval None
+  */
+void UDMA_EnableChannel(uint8_t channel);
+
+/**
+  * @brief  Disables a channel
+  * @retval None
+  */
+void UDMA_DisableChannel(uint8_t channel);
+
+/**
+  * @brief  Checks whether a channel is enabled. The hardware disables a channel when
+  *         its transfer completes, or when a ping-pong transfer reaches a stopped entry
+  * @retval 1 if enabled, 0 otherwise
+  */
+uint8_t UDMA_IsChannelEnabled(uint8_t channel);
+
+/**
+  * @brief  Returns the number of bus errors reported by the controller
+  * @retval Number of errors since UDMA_Init()
+  */
+uint32_t UDMA_GetErrorCount(void);
+
+/**
+  * @brief  Counts and clears a bus error. The channel involved is disabled by the hardware
+  * @retval None
+  */
+void DMA0_Error_Handler(void);
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "telemetry.h"
+
+/*
+ * Live watch: samples variables of the running program into the telemetry stream, so
+ * they can be followed on a host without a debugger.
+ *
+ * The variables are listed in a const table of WATCH_VAR() entries, so the compiler and
+ * the linker fill in the names, sizes and addresses at build time and the table stays in
+ * flash. Variable i of the table goes to telemetry channel FirstChannel + i, and
+ * tools/watch_plot.py maps the channels back to names by reading the same table from the
+ * source file.
+ *
+ * A round samples every variable once per Period. With OnChange, a variable is only sent
+ * when its value differs from the last round, plus every Keyframe rounds so that a host
+ * that starts late still gets all of them. Each Watch_Poll() reads at most MaxPerPoll
+ * variables, so a round can spread over several calls and the time of a call is bounded
+ * (a few cycles per variable, plus one frame to encode and queue at the end of a round).
+ *
+ * The variables are read as they are, without locking: a 1, 2 or 4-byte aligned variable
+ * is read in a single access, so each value is consistent on its own.
+ */
+
+// Most variables in a table
+#define WATCH_MAX_VARS                  32U
+
+// Signedness of a watched variable
+#define WATCH_UNSIGNED                  0U
+#define WATCH_SIGNED                    1U
+
+// Builds a table entry from a variable, e.g. WATCH_VAR(present_state, WATCH_SIGNED)
+#define WATCH_VAR(VAR, SIGNED)          { #VAR, &(VAR), (uint8_t) sizeof(VAR), (SIGNED) }
+
+typedef struct {
+    const char *Name;
+    const volatile void *Address;
+    uint8_t Size;                   // 1, 2 or 4 bytes
+    uint8_t Signed;                 // WATCH_SIGNED or WATCH_UNSIGNED
+} WatchVar_t;
+
+typedef struct {
+    Telemetry_t *Telemetry;         // Stream that carries the samples
+    const WatchVar_t *Vars;
+    uint8_t NumVars;                // 1 to WATCH_MAX_VARS
+    uint16_t FirstChannel;          // Telemetry channel of Vars[0], the others follow
+    uint32_t Period;                // Time between two rounds, in the unit of Watch_Poll()
+    uint8_t OnChange;               // 1 to only send the variables that changed
+    uint8_t Keyframe;               // With OnChange: rounds between two full ones, 0 for never
+    uint8_t MaxPerPoll;             // Most variables read by a Watch_Poll(), at least 1
+} WatchConfig_t;
+
+typedef struct {
+    WatchConfig_t Config;
+    uint32_t Last[WATCH_MAX_VARS];  // Values of the last round
+    uint32_t NextRound;             // Time the next round starts
+    uint8_t Cursor;                 // Next variable of the round, NumVars between rounds
+    uint8_t Full;                   // The round sends every variable
+    uint8_t Rounds;                 // Rounds since the last full one
+} Watch_t;
+
+/**
+  * @brief  Initializes a live watch. The first round, a full one, starts at the first poll
+  * @param  watch: Watch
+  * @param  config: Configuration (copied). The table and the stream must stay valid
+  * @param  now: Current time
+  * @retval 1 on success, -1 if the configuration is invalid
+  */
+int Watch_Init(Watch_t *watch, const WatchConfig_t *config, uint32_t now);
+
+/**
+  * @brief  Samples the next variables of the round in progress, or starts a round when
+  *         it is due. The frame of a round is sent when the round ends
+  * @param  watch: Watch
+  * @param  now: Current time, in the unit of Period (e.g. RTOS ticks)
+  * @retval Number of variables read, at most MaxPerPoll
+  */
+uint8_t Watch_Poll(Watch_t *watch, uint32_t now);
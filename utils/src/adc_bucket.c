@@ -0,0 +1,140 @@
+#include "adc_bucket.h"
+#include "temperature.h"
+#include "official_tm4c1294ncpdt.h"
+
+#include <stddef.h>
+
+#define ADC_BUCKET_MAX_CODE         0xFFFU
+
+// Comparator setup: interrupt on every sample that lies in the band
+#define ADC_BUCKET_BELOW            (ADC_DCCTL0_CIE | ADC_DCCTL0_CIC_LOW | ADC_DCCTL0_CIM_ALWAYS)
+#define ADC_BUCKET_ABOVE            (ADC_DCCTL0_CIE | ADC_DCCTL0_CIC_HIGH | ADC_DCCTL0_CIM_ALWAYS)
+
+static AdcBucketConfig_t Config;
+static volatile uint8_t Bucket = 0;
+
+// Programs both comparators with the window of the current bucket
+static void AdcBucket_SetWindow(void) {
+    uint32_t low = 0;
+    uint32_t high = ADC_BUCKET_MAX_CODE;
+
+    if (Bucket > 0) {
+        uint16_t edge = Config.Edges[Bucket - 1U];
+        low = edge > Config.Hysteresis ? edge - Config.Hysteresis : 0;
+    }
+    if (Bucket < Config.NumEdges) {
+        high = Config.Edges[Bucket] + (uint32_t) Config.Hysteresis;
+        high = high > ADC_BUCKET_MAX_CODE ? ADC_BUCKET_MAX_CODE : high;
+    }
+
+    // Comparator 0: low band is below the window. Comparator 1: high band is above it.
+    // There is nothing below the first bucket nor above the last one
+    ADC0_DCCTL0_R = 0;
+    ADC0_DCCTL1_R = 0;
+    ADC0_DCCMP0_R = (low << ADC_DCCMP0_COMP1_S) | (low << ADC_DCCMP0_COMP0_S);
+    ADC0_DCCMP1_R = (high << ADC_DCCMP0_COMP1_S) | (high << ADC_DCCMP0_COMP0_S);
+    ADC0_DCRIC_R = ADC_DCRIC_DCINT0 | ADC_DCRIC_DCINT1;
+    ADC0_DCCTL0_R = Bucket > 0 ? ADC_BUCKET_BELOW : 0;
+    ADC0_DCCTL1_R = Bucket < Config.NumEdges ? ADC_BUCKET_ABOVE : 0;
+}
+
+// Finds the bucket of a code, without hysteresis
+static uint8_t AdcBucket_Classify(uint32_t code) {
+    uint8_t bucket = 0;
+
+    while (bucket < Config.NumEdges && code >= Config.Edges[bucket]) {
+        bucket++;
+    }
+
+    return bucket;
+}
+
+int AdcBucket_Init(const AdcBucketConfig_t *config) {
+    if (config->NumEdges == 0 || config->NumEdges > ADC_BUCKET_MAX_EDGES) {
+        return -1;
+    }
+    for (uint8_t i = 1; i < config->NumEdges; i++) {
+        if (config->Edges[i] <= config->Edges[i - 1U]) {
+            return -1;
+        }
+    }
+
+    Config = *config;
+
+    uint32_t mux = 0;
+    uint32_t emux = 0;
+    uint32_t temp = 0;
+    uint32_t tsh = 0;
+    if (Config.Input == ADC_BUCKET_TEMP) {
+        temp = ADC_SSCTL2_TS0;
+        tsh = TEMP_ADC_TSH;
+    } else {
+        mux = Config.Input & 0xFU;
+        emux = Config.Input >> 4;
+    }
+
+    // One sample to the FIFO, triggered by software, to find where the input starts
+    ADC0_ACTSS_R &= ~ADC_ACTSS_ASEN2;
+    ADC0_IM_R &= ~(ADC_IM_MASK2 | ADC_IM_DCONSS2);
+    ADC0_EMUX_R = (ADC0_EMUX_R & ~ADC_EMUX_EM2_M) | ADC_EMUX_EM2_PROCESSOR;
+    ADC0_SSMUX2_R = mux;
+    ADC0_SSEMUX2_R = emux;
+    ADC0_SSOP2_R = 0;
+    ADC0_SSCTL2_R = temp | ADC_SSCTL2_IE0 | ADC_SSCTL2_END0;
+    ADC0_SSTSH2_R = tsh;
+    ADC0_ACTSS_R |= ADC_ACTSS_ASEN2;
+
+    ADC0_ISC_R = ADC_ISC_IN2;
+    ADC0_PSSI_R = ADC_PSSI_SS2;
+    while (!(ADC0_RIS_R & ADC_RIS_INR2));
+    Bucket = AdcBucket_Classify(ADC0_SSFIFO2_R & ADC_BUCKET_MAX_CODE);
+    ADC0_ISC_R = ADC_ISC_IN2;
+
+    // From now on, two samples per trigger: step 0 to comparator 0 and step 1 to comparator 1
+    ADC0_ACTSS_R &= ~ADC_ACTSS_ASEN2;
+    AdcBucket_SetWindow();
+    ADC0_SSMUX2_R = mux | (mux << 4);
+    ADC0_SSEMUX2_R = emux | (emux << 4);
+    ADC0_SSOP2_R = ADC_SSOP2_S0DCOP | ADC_SSOP2_S1DCOP;
+    ADC0_SSDC2_R = (0UL << ADC_SSDC2_S0DCSEL_S) | (1UL << ADC_SSDC2_S1DCSEL_S);
+    ADC0_SSCTL2_R = temp | (temp << 4) | ADC_SSCTL2_END1;
+    ADC0_SSTSH2_R = tsh | (tsh << 4);
+    ADC0_EMUX_R = (ADC0_EMUX_R & ~ADC_EMUX_EM2_M) | ADC_EMUX_EM2_TIMER;
+
+    // The comparators interrupt through sequencer 2
+    ADC0_DCISC_R = ADC_DCISC_DCINT0 | ADC_DCISC_DCINT1;
+    ADC0_ISC_R = ADC_ISC_DCINSS2;
+    ADC0_IM_R |= ADC_IM_DCONSS2;
+    ADC0_ACTSS_R |= ADC_ACTSS_ASEN2;
+
+    // Enable the interrupt at the NVIC (IRQ 16, priority in bits 7:5 of PRI4)
+    NVIC_PRI4_R = (NVIC_PRI4_R & ~0x000000E0UL) | ((uint32_t) ADC_BUCKET_PRIO << 5);
+    NVIC_EN0_R = 1UL << ADC_BUCKET_IRQ;
+
+    return Bucket;
+}
+
+uint8_t AdcBucket_Get(void) {
+    return Bucket;
+}
+
+void ADC0Sequence2_Handler(void) {
+    uint32_t status = ADC0_DCISC_R;
+    ADC0_DCISC_R = status;
+    ADC0_ISC_R = ADC_ISC_DCINSS2;
+
+    // Only one step at a time: a jump over several buckets is followed by the next samples
+    if ((status & ADC_DCISC_DCINT0) && Bucket > 0) {
+        Bucket--;
+    } else if ((status & ADC_DCISC_DCINT1) && Bucket < Config.NumEdges) {
+        Bucket++;
+    } else {
+        return;
+    }
+
+    AdcBucket_SetWindow();
+
+    if (Config.Callback != NULL) {
+        Config.Callback(Bucket, Config.Arg);
+    }
+}
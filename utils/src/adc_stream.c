@@ -0,0 +1,159 @@
+#include "adc_stream.h"
+#include "udma.h"
+#include "temperature.h"
+#include "official_tm4c1294ncpdt.h"
+
+#include <stddef.h>
+
+// Control word of a buffer: 16-bit reads of the FIFO register into consecutive half-words
+#define ADC_STREAM_CONTROL(LENGTH)  (UDMA_CHCTL_DSTINC_16 | UDMA_CHCTL_DSTSIZE_16 |         \
+                                     UDMA_CHCTL_SRCINC_NONE | UDMA_CHCTL_SRCSIZE_16 |       \
+                                     UDMA_CHCTL_ARBSIZE_1 |                                 \
+                                     (((uint32_t) (LENGTH) - 1U) << UDMA_CHCTL_XFERSIZE_S) | \
+                                     UDMA_CHCTL_XFERMODE_PINGPONG)
+
+static AdcStreamConfig_t Config;
+
+// Buffer that the uDMA fills first (0: primary entry, 1: alternate entry)
+static uint8_t NextHalf = 0;
+
+static volatile uint32_t Overflows = 0;
+
+// Points an entry of the uDMA channel to one of the buffers
+static void AdcStream_Arm(uint8_t half) {
+    UDMA_Entry_t *entry = half ? UDMA_Alternate(ADC_STREAM_UDMA_CHANNEL) : 
+                                 UDMA_Primary(ADC_STREAM_UDMA_CHANNEL);
+
+    entry->SrcEnd = &ADC0_SSFIFO0_R;
+    entry->DstEnd = &Config.Buffers[half][Config.Length - 1U];
+    entry->Control = ADC_STREAM_CONTROL(Config.Length);
+}
+
+int AdcStream_Init(const AdcStreamConfig_t *config) {
+    if (config->NumChannels == 0 || config->NumChannels > ADC_STREAM_MAX_CHANNELS ||
+        config->RateHz == 0 || config->RateHz > ADC_STREAM_TIMER_CLOCK_FREQ ||
+        config->Length == 0 || config->Length > UDMA_MAX_TRANSFER ||
+        config->Length % config->NumChannels != 0 ||
+        config->Buffers[0] == NULL || config->Buffers[1] == NULL) {
+        return -1;
+    }
+
+    Config = *config;
+    NextHalf = 0;
+    Overflows = 0;
+
+    // Enable the clocks of ADC0 and the timer, and wait until they are ready
+    SYSCTL_RCGCADC_R |= SYSCTL_RCGCADC_R0;
+    SYSCTL_RCGCTIMER_R |= SYSCTL_RCGCTIMER_R5;
+    while (!(SYSCTL_PRADC_R & SYSCTL_PRADC_R0));
+    while (!(SYSCTL_PRTIMER_R & SYSCTL_PRTIMER_R5));
+
+    // Timer: periodic 32-bit down counter on PIOSC, whose time-out triggers the ADC
+    TIMER5_CTL_R &= ~TIMER_CTL_TAEN;
+    TIMER5_CFG_R = TIMER_CFG_32_BIT_TIMER;
+    TIMER5_TAMR_R = TIMER_TAMR_TAMR_PERIOD;
+    TIMER5_CC_R = TIMER_CC_ALTCLK;
+    TIMER5_TAILR_R = ADC_STREAM_TIMER_CLOCK_FREQ / Config.RateHz - 1U;
+    TIMER5_ADCEV_R = TIMER_ADCEV_TATOADCEN;
+    TIMER5_CTL_R |= TIMER_CTL_TAOTE;
+
+    // Sequencer 0: one step per channel, triggered by the timer
+    ADC0_ACTSS_R &= ~ADC_ACTSS_ASEN0;
+    ADC0_CC_R = ADC_CC_CS_PIOSC;
+    ADC0_EMUX_R = (ADC0_EMUX_R & ~ADC_EMUX_EM0_M) | ADC_EMUX_EM0_TIMER;
+
+    uint32_t mux = 0;
+    uint32_t emux = 0;
+    uint32_t ctl = 0;
+    uint32_t tsh = 0;
+    for (uint8_t step = 0; step < Config.NumChannels; step++) {
+        uint8_t channel = Config.Channels[step];
+        if (channel == ADC_STREAM_TEMP) {
+            ctl |= ADC_SSCTL0_TS0 << (step * 4U);
+            tsh |= TEMP_ADC_TSH << (step * 4U);
+        } else {
+            mux |= (uint32_t) (channel & 0xFU) << (step * 4U);
+            emux |= (uint32_t) (channel >> 4) << (step * 4U);
+        }
+    }
+
+    // The last step ends the sequence and raises the request that the uDMA serves
+    ctl |= (ADC_SSCTL0_END0 | ADC_SSCTL0_IE0) << ((Config.NumChannels - 1U) * 4U);
+    ADC0_SSMUX0_R = mux;
+    ADC0_SSEMUX0_R = emux;
+    ADC0_SSCTL0_R = ctl;
+    ADC0_SSTSH0_R = tsh;
+
+    // Only the uDMA completions interrupt the CPU, never the individual sequences
+    ADC0_IM_R = (ADC0_IM_R & ~ADC_IM_MASK0) | ADC_IM_DMAMASK0;
+    ADC0_ISC_R = ADC_ISC_DMAIN0 | ADC_ISC_IN0;
+    ADC0_OSTAT_R = ADC_OSTAT_OV0;
+
+    // uDMA: both halves armed, the primary entry is filled first
+    UDMA_Init();
+    UDMA_AssignChannel(ADC_STREAM_UDMA_CHANNEL, ADC_STREAM_UDMA_ENCODING);
+    AdcStream_Arm(0);
+    AdcStream_Arm(1);
+    UDMA_EnableChannel(ADC_STREAM_UDMA_CHANNEL);
+
+    ADC0_ACTSS_R |= ADC_ACTSS_ASEN0;
+
+    // Enable the interrupt at the NVIC (IRQ 14, priority in bits 23:21 of PRI3)
+    NVIC_PRI3_R = (NVIC_PRI3_R & ~0x00E00000UL) | ((uint32_t) ADC_STREAM_PRIO << 21);
+    NVIC_EN0_R = 1UL << ADC_STREAM_IRQ;
+
+    return 1;
+}
+
+void AdcStream_Start(void) {
+    TIMER5_CTL_R |= TIMER_CTL_TAEN;
+}
+
+void AdcStream_Stop(void) {
+    TIMER5_CTL_R &= ~TIMER_CTL_TAEN;
+}
+
+uint32_t AdcStream_GetOverflows(void) {
+    return Overflows;
+}
+
+void ADC0Sequence0_Handler(void) {
+    ADC0_ISC_R = ADC_ISC_DMAIN0;
+
+    if (ADC0_OSTAT_R & ADC_OSTAT_OV0) {
+        ADC0_OSTAT_R = ADC_OSTAT_OV0;
+        Overflows++;
+    }
+
+    // A finished entry goes back to the stop mode. Deliver the buffers in the order they
+    // were filled; both can be done if the interrupt was held off for a whole buffer
+    for (uint8_t i = 0; i < 2U; i++) {
+        UDMA_Entry_t *entry = NextHalf ? UDMA_Alternate(ADC_STREAM_UDMA_CHANNEL) : 
+                                         UDMA_Primary(ADC_STREAM_UDMA_CHANNEL);
+        if ((entry->Control & UDMA_CHCTL_XFERMODE_M) != UDMA_CHCTL_XFERMODE_STOP) {
+            break;
+        }
+
+        uint8_t half = NextHalf;
+        NextHalf ^= 1U;
+
+        if (Config.Callback != NULL) {
+            Config.Callback(Config.Buffers[half], Config.Length, Config.Arg);
+        }
+
+        // Re-arm only after the callback, so the buffer cannot be overwritten while in use
+        AdcStream_Arm(half);
+    }
+
+    // If both buffers filled up before one was re-armed, the uDMA found a stopped entry
+    // and disabled the channel: the samples since then are lost. Both buffers have been
+    // delivered above, so restart from the primary entry
+    if (!UDMA_IsChannelEnabled(ADC_STREAM_UDMA_CHANNEL)) {
+        Overflows++;
+        UDMA_AssignChannel(ADC_STREAM_UDMA_CHANNEL, ADC_STREAM_UDMA_ENCODING);
+        AdcStream_Arm(0);
+        AdcStream_Arm(1);
+        NextHalf = 0;
+        UDMA_EnableChannel(ADC_STREAM_UDMA_CHANNEL);
+    }
+}
@@ -0,0 +1,103 @@
+#include "chart.h"
+#include "SSD2119_Display.h"
+
+// Row of a value, the top row being Max
+static uint16_t Chart_Row(const ChartConfig_t *config, int32_t value) {
+    if (value <= config->Min) {
+        return config->Y + config->Height - 1U;
+    }
+    if (value >= config->Max) {
+        return config->Y;
+    }
+
+    int32_t offset = (value - config->Min) * (int32_t) (config->Height - 1U) / (config->Max - config->Min);
+    return (uint16_t) (config->Y + config->Height - 1U - (uint16_t) offset);
+}
+
+void Chart_HistoryInit(ChartHistory_t *history, int32_t *samples, uint16_t size, uint16_t ratio) {
+    history->Samples = samples;
+    history->Size = size;
+    history->Head = 0;
+    history->Count = 0;
+    history->Ratio = ratio ? ratio : 1U;
+    history->Pending = 0;
+    history->Sum = 0;
+}
+
+uint8_t Chart_HistoryAdd(ChartHistory_t *history, int32_t value, int32_t *decimated) {
+    history->Sum += value;
+    if (++history->Pending < history->Ratio) {
+        return 0;
+    }
+
+    int32_t average = history->Sum / (int32_t) history->Ratio;
+    history->Sum = 0;
+    history->Pending = 0;
+
+    history->Samples[history->Head] = average;
+    history->Head = (history->Head + 1U) % history->Size;
+    if (history->Count < history->Size) {
+        history->Count++;
+    }
+
+    *decimated = average;
+    return 1;
+}
+
+int32_t Chart_HistoryGet(const ChartHistory_t *history, uint16_t age) {
+    uint16_t index = (history->Head + history->Size - 1U - age) % history->Size;
+    return history->Samples[index];
+}
+
+void Chart_Init(Chart_t *chart, const ChartConfig_t *config) {
+    chart->Config = *config;
+    LCD_DrawRect(config->X - 1U, config->Y - 1U, config->Width + 1, config->Height + 1, config->Frame);
+    Chart_Clear(chart);
+}
+
+void Chart_Clear(Chart_t *chart) {
+    const ChartConfig_t *config = &chart->Config;
+
+    LCD_DrawFilledRect(config->X, config->Y, config->Width, config->Height, config->Background);
+    chart->Column = 0;
+    chart->HasLast = 0;
+}
+
+void Chart_Push(Chart_t *chart, int32_t value) {
+    const ChartConfig_t *config = &chart->Config;
+    uint16_t x = config->X + chart->Column;
+    uint16_t row = Chart_Row(config, value);
+    uint16_t top = row;
+    uint16_t bottom = row;
+
+    // Join the previous sample with a vertical segment, except across the wrap-around
+    if (chart->HasLast && chart->Column != 0) {
+        if (chart->LastRow < top) {
+            top = chart->LastRow;
+        } else if (chart->LastRow > bottom) {
+            bottom = chart->LastRow;
+        }
+    }
+
+    // Every pixel of the column is written exactly once
+    if (top > config->Y) {
+        LCD_DrawFilledRect(x, config->Y, 1, top - config->Y, config->Background);
+    }
+    LCD_DrawFilledRect(x, top, 1, bottom - top + 1U, config->Trace);
+    if (bottom < config->Y + config->Height - 1U) {
+        LCD_DrawFilledRect(x, bottom + 1U, 1, config->Y + config->Height - 1U - bottom, config->Background);
+    }
+
+    chart->LastRow = row;
+    chart->HasLast = 1;
+    chart->Column = (chart->Column + 1U) % config->Width;
+}
+
+void Chart_Redraw(Chart_t *chart, const ChartHistory_t *history) {
+    uint16_t count = history->Count < chart->Config.Width ? history->Count : chart->Config.Width;
+
+    Chart_Clear(chart);
+    for (uint16_t age = count; age > 0; age--) {
+        Chart_Push(chart, Chart_HistoryGet(history, age - 1U));
+    }
+}
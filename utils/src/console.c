@@ -0,0 +1,74 @@
+#include "console.h"
+#include "uart_ring.h"
+#include "official_tm4c1294ncpdt.h"
+
+#include <stddef.h>
+
+// Baud rate divisor in 1/64ths: BRD = clock / (16 * baud), rounded to the nearest 1/64
+#define CONSOLE_BRD_64      ((CONSOLE_CLOCK_FREQ * 4UL + CONSOLE_BAUDRATE / 2UL) / CONSOLE_BAUDRATE)
+
+// Set once Console_RingInit() has handed UART0 to the ring buffers
+static uint8_t RingMode = 0;
+
+// uDMA task list of UART_WriteDma() on UART0
+static UDMA_Entry_t DmaTasks[CONSOLE_DMA_TASKS];
+
+void Console_Init(void) {
+    // Enable the clocks of UART0 and port A, and wait until they are ready
+    SYSCTL_RCGCUART_R |= SYSCTL_RCGCUART_R0;
+    SYSCTL_RCGCGPIO_R |= SYSCTL_RCGCGPIO_R0;
+    while (!(SYSCTL_PRUART_R & SYSCTL_PRUART_R0));
+    while (!(SYSCTL_PRGPIO_R & SYSCTL_PRGPIO_R0));
+
+    // PA0 (U0Rx) and PA1 (U0Tx) use alternate function 1
+    GPIO_PORTA_AFSEL_R |= 0x03;
+    GPIO_PORTA_PCTL_R = (GPIO_PORTA_PCTL_R & ~0xFFUL) | 0x11UL;
+    GPIO_PORTA_DEN_R |= 0x03;
+
+    // UART must be disabled while it is configured
+    UART0_CTL_R = 0;
+    UART0_IBRD_R = CONSOLE_BRD_64 >> 6;
+    UART0_FBRD_R = CONSOLE_BRD_64 & 0x3FUL;
+    UART0_LCRH_R = UART_LCRH_WLEN_8 | UART_LCRH_FEN;
+    UART0_CC_R = UART_CC_CS_PIOSC;
+    UART0_CTL_R = UART_CTL_UARTEN | UART_CTL_TXE | UART_CTL_RXE;
+}
+
+int Console_RingInit(uint8_t *tx, uint16_t tx_size, uint8_t *rx, uint16_t rx_size) {
+    UartRingConfig_t uart;
+    uart.BaudRate = CONSOLE_BAUDRATE;
+    uart.ClockSource = UART_CLOCK_PIOSC;
+    uart.TxBuffer = tx;
+    uart.TxSize = tx_size;
+    uart.RxBuffer = rx;
+    uart.RxSize = rx_size;
+    uart.DmaTasks = DmaTasks;
+    uart.DmaMaxTasks = CONSOLE_DMA_TASKS;
+    uart.FlowControl = 0;
+    uart.MsgPool = NULL;
+    uart.MsgCount = 0;
+
+    if (UART_RingInit(UART_PORT_0, &uart) != 1) {
+        return -1;
+    }
+    RingMode = 1;
+    return 1;
+}
+
+void Console_Putc(char c) {
+    // The UART interrupt owns the FIFO now
+    if (RingMode) {
+        UART_Write(UART_PORT_0, (const uint8_t *) &c, 1);
+        return;
+    }
+
+    // Wait for room in the transmit FIFO
+    while (UART0_FR_R & UART_FR_TXFF);
+    UART0_DR_R = (uint8_t) c;
+}
+
+void Console_Puts(const char *s) {
+    while (*s) {
+        Console_Putc(*s++);
+    }
+}
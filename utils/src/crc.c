@@ -0,0 +1,28 @@
+#include "crc.h"
+#include "official_tm4c1294ncpdt.h"
+
+static uint8_t Ready = 0;
+
+void Crc_Init(void) {
+    if (Ready) {
+        return;
+    }
+
+    // Enable the clock and wait until the module is ready
+    SYSCTL_RCGCCCM_R |= SYSCTL_RCGCCCM_R0;
+    while (!(SYSCTL_PRCCM_R & SYSCTL_PRCCM_R0));
+
+    Ready = 1;
+}
+
+uint16_t Crc_Ccitt(const uint8_t *data, uint16_t len) {
+    // One byte per write, starting from the seed
+    CCM0_CRCCTRL_R = CCM_CRCCTRL_TYPE_P1021 | CCM_CRCCTRL_SIZE | CCM_CRCCTRL_INIT_SEED;
+    CCM0_CRCSEED_R = CRC_CCITT_INIT;
+
+    while (len--) {
+        CCM0_CRCDIN_R = *data++;
+    }
+
+    return (uint16_t) CCM0_CRCRSLTPP_R;
+}
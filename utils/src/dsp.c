@@ -0,0 +1,179 @@
+#include "dsp.h"
+
+#include <stddef.h>
+
+// Dual 16-bit multiply-accumulate: ACC + X.lo * Y.lo + X.hi * Y.hi
+#if defined(__ICCARM__) && defined(__ARM_FEATURE_DSP)
+#include <intrinsics.h>
+#define DSP_SMLAD(X, Y, ACC)    ((int32_t) __SMLAD((X), (Y), (uint32_t) (ACC)))
+#elif defined(__GNUC__) && defined(__ARM_FEATURE_DSP)
+static inline int32_t Dsp_Smlad(uint32_t x, uint32_t y, int32_t acc) {
+    __asm volatile("smlad %0, %1, %2, %3" : "=r"(acc) : "r"(x), "r"(y), "r"(acc));
+    return acc;
+}
+#define DSP_SMLAD(X, Y, ACC)    Dsp_Smlad((X), (Y), (ACC))
+#else
+#define DSP_SMLAD(X, Y, ACC)    ((ACC) + (int32_t) (int16_t) (X) * (int16_t) (Y) + \
+                                 (int32_t) (int16_t) ((X) >> 16) * (int16_t) ((Y) >> 16))
+#endif
+
+// Packs two consecutive 16-bit values into the operand of DSP_SMLAD
+#define DSP_PACK(P)             ((uint16_t) (P)[0] | ((uint32_t) (uint16_t) (P)[1] << 16))
+
+int Dsp_CicInit(DspCic_t *cic, uint8_t order, uint16_t ratio) {
+    uint8_t log2 = 0;
+
+    if (order == 0 || order > DSP_CIC_MAX_ORDER || ratio == 0 || (ratio & (ratio - 1U)) != 0) {
+        return -1;
+    }
+    while ((1U << log2) < ratio) {
+        log2++;
+    }
+    if (order * log2 > DSP_CIC_MAX_GAIN_BITS) {
+        return -1;
+    }
+
+    cic->Order = order;
+    cic->Shift = order * log2;
+    cic->Ratio = ratio;
+    cic->Count = 0;
+    for (uint8_t i = 0; i < DSP_CIC_MAX_ORDER; i++) {
+        cic->Integrators[i] = 0;
+        cic->Combs[i] = 0;
+    }
+
+    return 1;
+}
+
+uint8_t Dsp_CicProcess(DspCic_t *cic, uint16_t in, uint16_t *out) {
+    // Integrators run at the input rate
+    cic->Integrators[0] += in;
+    for (uint8_t i = 1; i < cic->Order; i++) {
+        cic->Integrators[i] += cic->Integrators[i - 1U];
+    }
+
+    if (++cic->Count < cic->Ratio) {
+        return 0;
+    }
+    cic->Count = 0;
+
+    // Combs run at the output rate. Unsigned wrap-around cancels out here
+    uint32_t value = cic->Integrators[cic->Order - 1U];
+    for (uint8_t i = 0; i < cic->Order; i++) {
+        uint32_t delayed = cic->Combs[i];
+        cic->Combs[i] = value;
+        value -= delayed;
+    }
+
+    *out = (uint16_t) (value >> cic->Shift);
+    return 1;
+}
+
+uint16_t Dsp_CicDecimate(DspCic_t *cic, const uint16_t *in, uint16_t count, uint8_t stride, uint16_t *out) {
+    uint16_t produced = 0;
+
+    for (uint16_t i = 0; i < count; i += stride) {
+        produced += Dsp_CicProcess(cic, in[i], &out[produced]);
+    }
+
+    return produced;
+}
+
+int Dsp_FirInit(DspFir_t *fir, const int16_t *taps, uint16_t num_taps, int16_t *history) {
+    if (num_taps == 0 || (num_taps & 1U) != 0) {
+        return -1;
+    }
+
+    fir->Taps = taps;
+    fir->History = history;
+    fir->NumTaps = num_taps;
+    fir->Pos = 0;
+    for (uint16_t i = 0; i < 2U * num_taps; i++) {
+        history[i] = 0;
+    }
+
+    return 1;
+}
+
+int16_t Dsp_FirProcess(DspFir_t *fir, int16_t in) {
+    // The newest sample goes in front of the window, in both copies of the history
+    fir->Pos = fir->Pos ? fir->Pos - 1U : fir->NumTaps - 1U;
+    fir->History[fir->Pos] = in;
+    fir->History[fir->Pos + fir->NumTaps] = in;
+
+    const int16_t *window = &fir->History[fir->Pos];
+    const int16_t *taps = fir->Taps;
+    int32_t acc = 1L << 14;
+
+    for (uint16_t i = 0; i < fir->NumTaps; i += 2U) {
+        acc = DSP_SMLAD(DSP_PACK(&window[i]), DSP_PACK(&taps[i]), acc);
+    }
+
+    acc >>= 15;
+    if (acc > INT16_MAX) {
+        return INT16_MAX;
+    }
+    if (acc < INT16_MIN) {
+        return INT16_MIN;
+    }
+    return (int16_t) acc;
+}
+
+void Dsp_IirInit(DspIir_t *iir, uint8_t shift) {
+    iir->State = 0;
+    iir->Shift = shift;
+    iir->Primed = 0;
+}
+
+int32_t Dsp_IirProcess(DspIir_t *iir, int32_t in) {
+    int32_t target = in * (1L << DSP_FRAC_BITS);
+
+    if (!iir->Primed) {
+        iir->State = target;
+        iir->Primed = 1;
+    } else {
+        iir->State += (target - iir->State) / (1L << iir->Shift);
+    }
+
+    return (iir->State + (1L << (DSP_FRAC_BITS - 1U))) >> DSP_FRAC_BITS;
+}
+
+void Dsp_StatsReset(DspStats_t *stats) {
+    stats->Count = 0;
+    stats->Min = 0;
+    stats->Max = 0;
+    stats->Mean = 0;
+    stats->M2 = 0;
+}
+
+void Dsp_StatsAdd(DspStats_t *stats, int32_t in) {
+    int32_t x = in * (1L << DSP_FRAC_BITS);
+
+    if (stats->Count == 0 || in < stats->Min) {
+        stats->Min = in;
+    }
+    if (stats->Count == 0 || in > stats->Max) {
+        stats->Max = in;
+    }
+    stats->Count++;
+
+    // Welford: the deviations before and after updating the mean are both Q8,
+    // so their product is Q16 and goes back to Q8
+    int32_t before = x - stats->Mean;
+    stats->Mean += before / (int32_t) stats->Count;
+    int32_t after = x - stats->Mean;
+    stats->M2 += (uint64_t) (((int64_t) before * after) >> DSP_FRAC_BITS);
+}
+
+int32_t Dsp_StatsMean(const DspStats_t *stats) {
+    return stats->Mean;
+}
+
+uint32_t Dsp_StatsVariance(const DspStats_t *stats) {
+    if (stats->Count < 2U) {
+        return 0;
+    }
+
+    uint64_t variance = stats->M2 / (stats->Count - 1U);
+    return variance > UINT32_MAX ? UINT32_MAX : (uint32_t) variance;
+}
@@ -0,0 +1,195 @@
+#include "fft.h"
+
+// Dual 16-bit operations on packed complex values (see the header)
+#if defined(__ICCARM__) && defined(__ARM_FEATURE_DSP)
+#include <intrinsics.h>
+#define FFT_SMUAD(X, Y)         ((int32_t) __SMUAD((X), (Y)))
+#define FFT_SMUSD(X, Y)         ((int32_t) __SMUSD((X), (Y)))
+#define FFT_SMUADX(X, Y)        ((int32_t) __SMUADX((X), (Y)))
+#define FFT_SHADD16(X, Y)       ((uint32_t) __SHADD16((X), (Y)))
+#define FFT_SHSUB16(X, Y)       ((uint32_t) __SHSUB16((X), (Y)))
+#elif defined(__GNUC__) && defined(__ARM_FEATURE_DSP)
+#define FFT_INSTRUCTION(NAME, INSN)                                             \
+    static inline uint32_t NAME(uint32_t x, uint32_t y) {                       \
+        uint32_t result;                                                        \
+        __asm volatile(INSN " %0, %1, %2" : "=r"(result) : "r"(x), "r"(y));     \
+        return result;                                                          \
+    }
+FFT_INSTRUCTION(Fft_Smuad, "smuad")
+FFT_INSTRUCTION(Fft_Smusd, "smusd")
+FFT_INSTRUCTION(Fft_Smuadx, "smuadx")
+FFT_INSTRUCTION(Fft_Shadd16, "shadd16")
+FFT_INSTRUCTION(Fft_Shsub16, "shsub16")
+#define FFT_SMUAD(X, Y)         ((int32_t) Fft_Smuad((X), (Y)))
+#define FFT_SMUSD(X, Y)         ((int32_t) Fft_Smusd((X), (Y)))
+#define FFT_SMUADX(X, Y)        ((int32_t) Fft_Smuadx((X), (Y)))
+#define FFT_SHADD16(X, Y)       Fft_Shadd16((X), (Y))
+#define FFT_SHSUB16(X, Y)       Fft_Shsub16((X), (Y))
+#else
+#define FFT_SMUAD(X, Y)         ((int32_t) FFT_RE(X) * FFT_RE(Y) + (int32_t) FFT_IM(X) * FFT_IM(Y))
+#define FFT_SMUSD(X, Y)         ((int32_t) FFT_RE(X) * FFT_RE(Y) - (int32_t) FFT_IM(X) * FFT_IM(Y))
+#define FFT_SMUADX(X, Y)        ((int32_t) FFT_RE(X) * FFT_IM(Y) + (int32_t) FFT_IM(X) * FFT_RE(Y))
+#define FFT_SHADD16(X, Y)       FFT_PACK(((int32_t) FFT_RE(X) + FFT_RE(Y)) >> 1, \
+                                         ((int32_t) FFT_IM(X) + FFT_IM(Y)) >> 1)
+#define FFT_SHSUB16(X, Y)       FFT_PACK(((int32_t) FFT_RE(X) - FFT_RE(Y)) >> 1, \
+                                         ((int32_t) FFT_IM(X) - FFT_IM(Y)) >> 1)
+#endif
+
+// sin(pi/2 * i / 256) in Q15, a quarter of a period of FFT_MAX_POINTS steps
+static const int16_t QuarterSine[FFT_MAX_POINTS / 4U + 1U] = {
+        0,   201,   402,   603,   804,  1005,  1206,  1407,  1608,  1809,  2009,  2210,
+     2410,  2611,  2811,  3012,  3212,  3412,  3612,  3811,  4011,  4210,  4410,  4609,
+     4808,  5007,  5205,  5404,  5602,  5800,  5998,  6195,  6393,  6590,  6786,  6983,
+     7179,  7375,  7571,  7767,  7962,  8157,  8351,  8545,  8739,  8933,  9126,  9319,
+     9512,  9704,  9896, 10087, 10278, 10469, 10659, 10849, 11039, 11228, 11417, 11605,
+    11793, 11980, 12167, 12353, 12539, 12725, 12910, 13094, 13279, 13462, 13645, 13828,
+    14010, 14191, 14372, 14553, 14732, 14912, 15090, 15269, 15446, 15623, 15800, 15976,
+    16151, 16325, 16499, 16673, 16846, 17018, 17189, 17360, 17530, 17700, 17869, 18037,
+    18204, 18371, 18537, 18703, 18868, 19032, 19195, 19357, 19519, 19680, 19841, 20000,
+    20159, 20317, 20475, 20631, 20787, 20942, 21096, 21250, 21403, 21554, 21705, 21856,
+    22005, 22154, 22301, 22448, 22594, 22739, 22884, 23027, 23170, 23311, 23452, 23592,
+    23731, 23870, 24007, 24143, 24279, 24413, 24547, 24680, 24811, 24942, 25072, 25201,
+    25329, 25456, 25582, 25708, 25832, 25955, 26077, 26198, 26319, 26438, 26556, 26674,
+    26790, 26905, 27019, 27133, 27245, 27356, 27466, 27575, 27683, 27790, 27896, 28001,
+    28105, 28208, 28310, 28411, 28510, 28609, 28706, 28803, 28898, 28992, 29085, 29177,
+    29268, 29358, 29447, 29534, 29621, 29706, 29791, 29874, 29956, 30037, 30117, 30195,
+    30273, 30349, 30424, 30498, 30571, 30643, 30714, 30783, 30852, 30919, 30985, 31050,
+    31113, 31176, 31237, 31297, 31356, 31414, 31470, 31526, 31580, 31633, 31685, 31736,
+    31785, 31833, 31880, 31926, 31971, 32014, 32057, 32098, 32137, 32176, 32213, 32250,
+    32285, 32318, 32351, 32382, 32412, 32441, 32469, 32495, 32521, 32545, 32567, 32589,
+    32609, 32628, 32646, 32663, 32678, 32692, 32705, 32717, 32728, 32737, 32745, 32752,
+    32757, 32761, 32765, 32766, 32767
+};
+
+// W^k = cos(2 pi k / FFT_MAX_POINTS) - j sin(2 pi k / FFT_MAX_POINTS) for k < FFT_MAX_POINTS / 2
+static FftComplex_t Twiddles[FFT_MAX_POINTS / 2U];
+static uint8_t TwiddlesReady = 0;
+
+// sin(2 pi k / FFT_MAX_POINTS) in Q15, for any k
+static int16_t Fft_Sin(uint16_t k) {
+    k %= FFT_MAX_POINTS;
+    if (k <= FFT_MAX_POINTS / 4U) {
+        return QuarterSine[k];
+    }
+    if (k <= FFT_MAX_POINTS / 2U) {
+        return QuarterSine[FFT_MAX_POINTS / 2U - k];
+    }
+    return (int16_t) -Fft_Sin(k - FFT_MAX_POINTS / 2U);
+}
+
+// cos(2 pi k / FFT_MAX_POINTS) in Q15, for any k
+static int16_t Fft_Cos(uint16_t k) {
+    return Fft_Sin(k + FFT_MAX_POINTS / 4U);
+}
+
+// Integer square root, rounded down
+static uint16_t Fft_Sqrt(uint32_t value) {
+    uint32_t root = 0;
+    uint32_t bit = 1UL << 30;
+
+    while (bit > value) {
+        bit >>= 2;
+    }
+    while (bit) {
+        if (value >= root + bit) {
+            value -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+
+    return (uint16_t) root;
+}
+
+int Fft_Init(FftPlan_t *plan, uint16_t points) {
+    uint8_t log2 = 0;
+
+    if (points < FFT_MIN_POINTS || points > FFT_MAX_POINTS || (points & (points - 1U)) != 0) {
+        return -1;
+    }
+    while ((1U << log2) < points) {
+        log2++;
+    }
+
+    if (!TwiddlesReady) {
+        for (uint16_t k = 0; k < FFT_MAX_POINTS / 2U; k++) {
+            Twiddles[k] = FFT_PACK(Fft_Cos(k), -Fft_Sin(k));
+        }
+        TwiddlesReady = 1;
+    }
+
+    plan->Points = points;
+    plan->Log2 = log2;
+    plan->Stride = FFT_MAX_POINTS / points;
+    return 1;
+}
+
+void Fft_Window(const FftPlan_t *plan, const uint16_t *samples, uint8_t stride, FftComplex_t *data) {
+    uint32_t sum = 0;
+
+    for (uint16_t n = 0; n < plan->Points; n++) {
+        sum += samples[n * stride];
+    }
+    int32_t mean = (int32_t) ((sum + plan->Points / 2U) >> plan->Log2);
+
+    for (uint16_t n = 0; n < plan->Points; n++) {
+        // 12-bit code around the mean to Q15, then Hann: (1 - cos(2 pi n / N)) / 2
+        int32_t x = ((int32_t) samples[n * stride] - mean) * 8;
+        int32_t window = (32768L - Fft_Cos(n * plan->Stride)) >> 1;
+        int32_t y = (x * window) >> 15;
+
+        if (y > INT16_MAX) {
+            y = INT16_MAX;
+        } else if (y < INT16_MIN) {
+            y = INT16_MIN;
+        }
+        data[n] = FFT_PACK(y, 0);
+    }
+}
+
+void Fft_Transform(const FftPlan_t *plan, FftComplex_t *data) {
+    uint16_t points = plan->Points;
+
+    // Bit-reversed order, so that the butterflies can work in place
+    for (uint16_t i = 0, j = 0; i < points; i++) {
+        if (i < j) {
+            FftComplex_t t = data[i];
+            data[i] = data[j];
+            data[j] = t;
+        }
+        uint16_t bit = points >> 1;
+        while (j & bit) {
+            j ^= bit;
+            bit >>= 1;
+        }
+        j |= bit;
+    }
+
+    for (uint16_t half = 1; half < points; half <<= 1) {
+        // Twiddles of this stage are W^(k * FFT_MAX_POINTS / (2 * half))
+        uint16_t step = (uint16_t) (plan->Stride * (points / (2U * half)));
+
+        for (uint16_t start = 0; start < points; start += 2U * half) {
+            for (uint16_t k = 0; k < half; k++) {
+                FftComplex_t w = Twiddles[k * step];
+                FftComplex_t a = data[start + k];
+                FftComplex_t b = data[start + k + half];
+
+                // b * w in Q15, then (a + b * w) / 2 and (a - b * w) / 2
+                FftComplex_t t = FFT_PACK(FFT_SMUSD(b, w) >> 15, FFT_SMUADX(b, w) >> 15);
+                data[start + k] = FFT_SHADD16(a, t);
+                data[start + k + half] = FFT_SHSUB16(a, t);
+            }
+        }
+    }
+}
+
+void Fft_Magnitude(const FftPlan_t *plan, const FftComplex_t *data, uint16_t *magnitude) {
+    for (uint16_t k = 0; k < plan->Points / 2U; k++) {
+        // re^2 + im^2 in one SMUAD. Only -32768 squared twice overflows, so clamp it
+        int32_t power = FFT_SMUAD(data[k], data[k]);
+        magnitude[k] = Fft_Sqrt(power < 0 ? 0x80000000UL : (uint32_t) power);
+    }
+}
@@ -0,0 +1,153 @@
+#include "fmt.h"
+
+#include <stddef.h>
+
+// "00" to "99": two digits per division by 100
+static const char DigitPairs[200] = {
+    '0','0','0','1','0','2','0','3','0','4','0','5','0','6','0','7','0','8','0','9',
+    '1','0','1','1','1','2','1','3','1','4','1','5','1','6','1','7','1','8','1','9',
+    '2','0','2','1','2','2','2','3','2','4','2','5','2','6','2','7','2','8','2','9',
+    '3','0','3','1','3','2','3','3','3','4','3','5','3','6','3','7','3','8','3','9',
+    '4','0','4','1','4','2','4','3','4','4','4','5','4','6','4','7','4','8','4','9',
+    '5','0','5','1','5','2','5','3','5','4','5','5','5','6','5','7','5','8','5','9',
+    '6','0','6','1','6','2','6','3','6','4','6','5','6','6','6','7','6','8','6','9',
+    '7','0','7','1','7','2','7','3','7','4','7','5','7','6','7','7','7','8','7','9',
+    '8','0','8','1','8','2','8','3','8','4','8','5','8','6','8','7','8','8','8','9',
+    '9','0','9','1','9','2','9','3','9','4','9','5','9','6','9','7','9','8','9','9'
+};
+
+static const char HexDigits[16] = {
+    '0','1','2','3','4','5','6','7','8','9','A','B','C','D','E','F'
+};
+
+// Writes the decimal digits of a number backwards from <end>, with at least <min_digits>
+// digits (zero-padded). Returns the first digit
+static char *Fmt_Digits(char *end, uint32_t value, uint8_t min_digits) {
+    char *p = end;
+
+    while (value >= 100U) {
+        uint32_t pair = (value % 100U) * 2U;
+        value /= 100U;
+        p -= 2;
+        p[0] = DigitPairs[pair];
+        p[1] = DigitPairs[pair + 1U];
+    }
+
+    if (value >= 10U) {
+        p -= 2;
+        p[0] = DigitPairs[value * 2U];
+        p[1] = DigitPairs[value * 2U + 1U];
+    } else {
+        *--p = (char) ('0' + value);
+    }
+
+    while (end - p < min_digits) {
+        *--p = '0';
+    }
+    return p;
+}
+
+static void Fmt_WriteBuffer(FmtSink_t *sink, const char *data, uint16_t len) {
+    while (len-- && sink->Len + 1U < sink->Size) {
+        sink->Data[sink->Len++] = *data++;
+    }
+    sink->Data[sink->Len] = '\0';
+}
+
+static void Fmt_WriteUart(FmtSink_t *sink, const char *data, uint16_t len) {
+    sink->Len += UART_Write(sink->Port, (const uint8_t *) data, len);
+}
+
+void Fmt_BufferSink(FmtSink_t *sink, char *data, uint16_t size) {
+    sink->Write = Fmt_WriteBuffer;
+    sink->Data = data;
+    sink->Size = size;
+    sink->Len = 0;
+    data[0] = '\0';
+}
+
+void Fmt_UartSink(FmtSink_t *sink, UartPort_e port) {
+    sink->Write = Fmt_WriteUart;
+    sink->Data = NULL;
+    sink->Size = 0;
+    sink->Len = 0;
+    sink->Port = port;
+}
+
+void Fmt_Char(FmtSink_t *sink, char c) {
+    sink->Write(sink, &c, 1);
+}
+
+void Fmt_Str(FmtSink_t *sink, const char *s) {
+    uint16_t len = 0;
+
+    while (s[len]) {
+        len++;
+    }
+    sink->Write(sink, s, len);
+}
+
+void Fmt_UInt(FmtSink_t *sink, uint32_t value) {
+    char text[FMT_NUMBER_LEN];
+    char *end = text + sizeof(text);
+    char *start = Fmt_Digits(end, value, 1);
+
+    sink->Write(sink, start, (uint16_t) (end - start));
+}
+
+void Fmt_Int(FmtSink_t *sink, int32_t value) {
+    Fmt_Fixed(sink, value, 0);
+}
+
+void Fmt_Fixed(FmtSink_t *sink, int32_t value, uint8_t decimals) {
+    char digits[10];
+    char text[FMT_NUMBER_LEN];
+    char *end = digits + sizeof(digits);
+    char *p = text;
+    uint32_t magnitude = value < 0 ? 0U - (uint32_t) value : (uint32_t) value;
+
+    if (decimals > 9U) {
+        decimals = 9U;
+    }
+
+    // At least one digit before the point, e.g. "0.05"
+    char *digit = Fmt_Digits(end, magnitude, (uint8_t) (decimals + 1U));
+    char *point = end - decimals;
+
+    if (value < 0) {
+        *p++ = '-';
+    }
+    while (digit < point) {
+        *p++ = *digit++;
+    }
+    if (decimals) {
+        *p++ = '.';
+        while (digit < end) {
+            *p++ = *digit++;
+        }
+    }
+
+    sink->Write(sink, text, (uint16_t) (p - text));
+}
+
+void Fmt_Hex(FmtSink_t *sink, uint32_t value, uint8_t digits) {
+    char text[8];
+    char *end = text + sizeof(text);
+    char *p = end;
+
+    do {
+        *--p = HexDigits[value & 0xFU];
+        value >>= 4;
+    } while (value);
+
+    while (end - p < digits && p > text) {
+        *--p = '0';
+    }
+    sink->Write(sink, p, (uint16_t) (end - p));
+}
+
+void Fmt_Repeat(FmtSink_t *sink, char c, uint8_t count) {
+    while (count--) {
+        sink->Write(sink, &c, 1);
+    }
+}
@@ -0,0 +1,18 @@
+#include "fmt_lcd.h"
+#include "SSD2119_Display.h"
+
+#include <stddef.h>
+
+static void Fmt_WriteLcd(FmtSink_t *sink, const char *data, uint16_t len) {
+    sink->Len += len;
+    while (len--) {
+        LCD_PrintChar((unsigned char) *data++);
+    }
+}
+
+void Fmt_LcdSink(FmtSink_t *sink) {
+    sink->Write = Fmt_WriteLcd;
+    sink->Data = NULL;
+    sink->Size = 0;
+    sink->Len = 0;
+}
@@ -0,0 +1,77 @@
+#include "governor.h"
+#include "latency.h"
+
+int Governor_Init(Governor_t *governor, const GovernorConfig_t *config, uint8_t level) {
+    if (config->NumLevels == 0 || config->NumLevels > GOVERNOR_MAX_LEVELS ||
+        level >= config->NumLevels || config->ReleaseCentiC > config->ThrottleCentiC ||
+        config->TargetLoadPct > config->HighLoadPct || config->HighLoadPct > 100U) {
+        return -1;
+    }
+
+    governor->Config = *config;
+    governor->Level = level;
+    governor->Ceiling = config->NumLevels - 1U;
+    governor->LoadPct = 0;
+    governor->Idle = 0;
+    governor->IdleCycles = 0;
+    governor->PeriodStart = Latency_Cycles();
+    return 1;
+}
+
+void Governor_IdleEnter(Governor_t *governor) {
+    governor->IdleStart = Latency_Cycles();
+    governor->Idle = 1;
+}
+
+void Governor_IdleExit(Governor_t *governor) {
+    if (governor->Idle) {
+        governor->IdleCycles += Latency_Cycles() - governor->IdleStart;
+        governor->Idle = 0;
+    }
+}
+
+uint8_t Governor_Update(Governor_t *governor, int32_t centi_c) {
+    const GovernorConfig_t *config = &governor->Config;
+    uint32_t now = Latency_Cycles();
+
+    // Close the period, including the wait in progress if called from within one
+    if (governor->Idle) {
+        governor->IdleCycles += now - governor->IdleStart;
+        governor->IdleStart = now;
+    }
+    uint32_t total = now - governor->PeriodStart;
+    uint32_t busy = total > governor->IdleCycles ? total - governor->IdleCycles : 0;
+    governor->LoadPct = total ? (uint8_t) (((uint64_t) busy * 100U) / total) : 0;
+    governor->PeriodStart = now;
+    governor->IdleCycles = 0;
+
+    // Thermal ceiling, one level per update in either direction
+    if (centi_c >= config->ThrottleCentiC && governor->Ceiling > 0) {
+        governor->Ceiling--;
+    } else if (centi_c <= config->ReleaseCentiC && governor->Ceiling < config->NumLevels - 1U) {
+        governor->Ceiling++;
+    }
+
+    // Workload: speed up on a backlog, slow down if the slower clock would still cope
+    if (governor->LoadPct >= config->HighLoadPct) {
+        if (governor->Level < governor->Ceiling) {
+            governor->Level++;
+        }
+    } else if (governor->Level > 0) {
+        uint32_t scaled = (uint32_t) governor->LoadPct * config->LevelsMHz[governor->Level] /
+                          config->LevelsMHz[governor->Level - 1U];
+        if (scaled < config->TargetLoadPct) {
+            governor->Level--;
+        }
+    }
+
+    if (governor->Level > governor->Ceiling) {
+        governor->Level = governor->Ceiling;
+    }
+
+    return governor->Level;
+}
+
+uint8_t Governor_GetLoad(const Governor_t *governor) {
+    return governor->LoadPct;
+}
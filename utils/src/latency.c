@@ -0,0 +1,190 @@
+#include "latency.h"
+
+#include <stddef.h>
+
+// Cortex-M4 DWT cycle counter (not part of the device header)
+#define DEMCR_R         (*((volatile uint32_t *)0xE000EDFC))
+#define DEMCR_TRCENA    0x01000000
+#define DWT_CTRL_R      (*((volatile uint32_t *)0xE0001000))
+#define DWT_CTRL_CYCEN  0x00000001
+#define DWT_CYCCNT_R    (*((volatile uint32_t *)0xE0001004))
+
+static LatencyHist_t Hist[LATENCY_NUM_STAGES];
+
+// Cycles per microsecond
+static uint32_t CyclesPerUs = 16;
+
+// Time of the last touch sample, start of the open trace and next stage expected.
+// LATENCY_STAGE_DISPATCH is expected while no trace is open
+static uint32_t SampleTime = 0;
+static uint32_t TraceStart = 0;
+static uint8_t NextStage = LATENCY_STAGE_DISPATCH;
+
+static const char *const StageNames[LATENCY_NUM_STAGES] = {
+    "touch", "dispatch", "fsm", "photon"
+};
+
+// Destination of Latency_Format(). FormatLen keeps counting past FormatSize
+static char *FormatBuf = NULL;
+static uint16_t FormatSize = 0;
+static uint16_t FormatLen = 0;
+
+// Adds a latency to a histogram
+static void Latency_Record(LatencyHist_t *hist, uint32_t us) {
+    uint8_t bucket = 0;
+    uint32_t v = us >> 1;
+
+    while (v && bucket < LATENCY_NUM_BUCKETS - 1U) {
+        v >>= 1;
+        bucket++;
+    }
+
+    if (hist->Count == 0 || us < hist->MinUs) {
+        hist->MinUs = us;
+    }
+    if (us > hist->MaxUs) {
+        hist->MaxUs = us;
+    }
+    hist->Count++;
+    hist->SumUs += us;
+    hist->Buckets[bucket]++;
+}
+
+// Prints a string
+static void Latency_PutString(LatencyPutc_t put, const char *s) {
+    while (*s) {
+        put(*s++);
+    }
+}
+
+// Prints an unsigned number in decimal
+static void Latency_PutNumber(LatencyPutc_t put, uint32_t n) {
+    char digits[10];
+    uint8_t len = 0;
+
+    do {
+        digits[len++] = (char) ('0' + n % 10U);
+        n /= 10U;
+    } while (n);
+
+    while (len) {
+        put(digits[--len]);
+    }
+}
+
+void Latency_Init(uint32_t cpu_hz) {
+    CyclesPerUs = cpu_hz / 1000000UL;
+    if (CyclesPerUs == 0) {
+        CyclesPerUs = 1;
+    }
+
+    DEMCR_R |= DEMCR_TRCENA;
+    DWT_CYCCNT_R = 0;
+    DWT_CTRL_R |= DWT_CTRL_CYCEN;
+
+    Latency_Reset();
+}
+
+uint32_t Latency_Cycles(void) {
+    return DWT_CYCCNT_R;
+}
+
+void Latency_Reset(void) {
+    for (uint8_t stage = 0; stage < LATENCY_NUM_STAGES; stage++) {
+        Hist[stage].Count = 0;
+        Hist[stage].MinUs = 0;
+        Hist[stage].MaxUs = 0;
+        Hist[stage].SumUs = 0;
+        for (uint8_t i = 0; i < LATENCY_NUM_BUCKETS; i++) {
+            Hist[stage].Buckets[i] = 0;
+        }
+    }
+
+    Latency_Abort();
+}
+
+uint8_t Latency_Mark(LatencyStage_e stage) {
+    uint32_t now = DWT_CYCCNT_R;
+
+    // A new sample only matters while no trace is open
+    if (stage == LATENCY_STAGE_TOUCH) {
+        if (NextStage == LATENCY_STAGE_DISPATCH) {
+            SampleTime = now;
+        }
+        return 0;
+    }
+
+    if (stage != NextStage) {
+        return 0;
+    }
+
+    if (stage == LATENCY_STAGE_DISPATCH) {
+        // Open the trace at the sample that produced the event
+        TraceStart = SampleTime;
+    }
+
+    // Unsigned subtraction handles the counter wrapping around
+    Latency_Record(&Hist[stage], (now - TraceStart) / CyclesPerUs);
+
+    if (stage == LATENCY_STAGE_PHOTON) {
+        NextStage = LATENCY_STAGE_DISPATCH;
+        return 1;
+    }
+
+    NextStage = stage + 1U;
+    return 0;
+}
+
+void Latency_Abort(void) {
+    NextStage = LATENCY_STAGE_DISPATCH;
+}
+
+const LatencyHist_t *Latency_GetHist(LatencyStage_e stage) {
+    return &Hist[stage];
+}
+
+// Output of Latency_Format(): stores what fits and counts everything
+static void Latency_FormatChar(char c) {
+    if (FormatLen < FormatSize) {
+        FormatBuf[FormatLen] = c;
+    }
+    FormatLen++;
+}
+
+uint16_t Latency_Format(char *buf, uint16_t size) {
+    FormatBuf = buf;
+    FormatSize = size;
+    FormatLen = 0;
+    Latency_Dump(Latency_FormatChar);
+
+    return FormatLen <= size ? FormatLen : 0;
+}
+
+void Latency_Dump(LatencyPutc_t put) {
+    for (uint8_t stage = LATENCY_STAGE_DISPATCH; stage < LATENCY_NUM_STAGES; stage++) {
+        const LatencyHist_t *hist = &Hist[stage];
+
+        // Summary: "<stage> n=<count> min=<us> avg=<us> max=<us>"
+        Latency_PutString(put, StageNames[stage]);
+        Latency_PutString(put, " n=");
+        Latency_PutNumber(put, hist->Count);
+        Latency_PutString(put, " min=");
+        Latency_PutNumber(put, hist->MinUs);
+        Latency_PutString(put, " avg=");
+        Latency_PutNumber(put, hist->Count ? hist->SumUs / hist->Count : 0);
+        Latency_PutString(put, " max=");
+        Latency_PutNumber(put, hist->MaxUs);
+        Latency_PutString(put, "\r\n");
+
+        // Buckets: "  >=<lower bound in us>: <count>"
+        for (uint8_t i = 0; i < LATENCY_NUM_BUCKETS; i++) {
+            if (hist->Buckets[i]) {
+                Latency_PutString(put, "  >=");
+                Latency_PutNumber(put, i ? (1UL << i) : 0);
+                Latency_PutString(put, "us: ");
+                Latency_PutNumber(put, hist->Buckets[i]);
+                Latency_PutString(put, "\r\n");
+            }
+        }
+    }
+}
@@ -0,0 +1,202 @@
+#include "log.h"
+#include "crc.h"
+#include "latency.h"
+#include "telemetry.h"
+
+#include <stddef.h>
+
+// Compare-and-swap of a word shared with interrupt handlers: stores desired if the word
+// still holds expected. Returns 1 if it was stored
+#if defined(__ICCARM__)
+#include <intrinsics.h>
+static inline uint8_t Log_CompareAndSwap(volatile uint32_t *word, uint32_t expected, uint32_t desired) {
+    if (__LDREX((unsigned long *) word) != expected) {
+        __CLREX();
+        return 0;
+    }
+    return __STREX(desired, (unsigned long *) word) == 0;
+}
+#elif defined(__GNUC__)
+static inline uint8_t Log_CompareAndSwap(volatile uint32_t *word, uint32_t expected, uint32_t desired) {
+    return __atomic_compare_exchange_n(word, &expected, desired, 1, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED);
+}
+#else
+#error "log.c needs a compare-and-swap for this compiler"
+#endif
+
+#define RING_MASK       (LOG_RING_WORDS - 1U)
+
+// Header and timestamp, then the arguments
+#define RECORD_WORDS(NARGS)     (2U + (NARGS))
+#define HEADER_NARGS(HEADER)    ((HEADER) >> 28)
+
+// Sequence and lost records, then the CRC
+#define FRAME_HEADER_LEN        3U
+#define FRAME_CRC_LEN           2U
+
+// Records, 0 where no record is complete. Head is the end of the reserved words (moved
+// by the writers), Tail the start of the oldest record (moved by Log_Drain() only). Both
+// run freely and are masked on access
+static volatile uint32_t Ring[LOG_RING_WORDS];
+static volatile uint32_t Head = 0;
+static volatile uint32_t Tail = 0;
+
+// Records dropped since Log_Init(), and the part of them already reported in a frame
+static volatile uint32_t Dropped = 0;
+static uint32_t Reported = 0;
+
+static LogWrite_t Write = NULL;
+static void *WriteArg = NULL;
+static uint8_t Sequence = 0;
+static uint8_t Frame[LOG_MAX_FRAME];
+static uint8_t Encoded[LOG_MAX_ENCODED];
+
+// Returned by Log_Reserve() when the ring is full
+#define RESERVE_FAILED          0xFFFFFFFFU
+
+// Reserves the words of a record and stores its timestamp. Returns the index of the
+// record in the ring, or RESERVE_FAILED
+static inline uint32_t Log_Reserve(uint32_t words) {
+    uint32_t head;
+
+    do {
+        head = Head;
+        if (head - Tail > LOG_RING_WORDS - words) {
+            uint32_t dropped;
+            do {
+                dropped = Dropped;
+            } while (!Log_CompareAndSwap(&Dropped, dropped, dropped + 1U));
+            return RESERVE_FAILED;
+        }
+    } while (!Log_CompareAndSwap(&Head, head, head + words));
+
+    Ring[(head + 1U) & RING_MASK] = Latency_Cycles();
+    return head & RING_MASK;
+}
+
+void Log_Init(LogWrite_t write, void *arg) {
+    for (uint32_t i = 0; i < LOG_RING_WORDS; i++) {
+        Ring[i] = 0;
+    }
+    Head = 0;
+    Tail = 0;
+    Dropped = 0;
+    Reported = 0;
+    Sequence = 0;
+    Write = write;
+    WriteArg = arg;
+
+    Crc_Init();
+}
+
+// The header goes last: the volatile stores keep their order, and it completes the record
+
+void Log_Write0(uint32_t header) {
+    uint32_t at = Log_Reserve(RECORD_WORDS(0));
+    if (at != RESERVE_FAILED) {
+        Ring[at] = header;
+    }
+}
+
+void Log_Write1(uint32_t header, uint32_t a) {
+    uint32_t at = Log_Reserve(RECORD_WORDS(1));
+    if (at != RESERVE_FAILED) {
+        Ring[(at + 2U) & RING_MASK] = a;
+        Ring[at] = header;
+    }
+}
+
+void Log_Write2(uint32_t header, uint32_t a, uint32_t b) {
+    uint32_t at = Log_Reserve(RECORD_WORDS(2));
+    if (at != RESERVE_FAILED) {
+        Ring[(at + 2U) & RING_MASK] = a;
+        Ring[(at + 3U) & RING_MASK] = b;
+        Ring[at] = header;
+    }
+}
+
+void Log_Write3(uint32_t header, uint32_t a, uint32_t b, uint32_t c) {
+    uint32_t at = Log_Reserve(RECORD_WORDS(3));
+    if (at != RESERVE_FAILED) {
+        Ring[(at + 2U) & RING_MASK] = a;
+        Ring[(at + 3U) & RING_MASK] = b;
+        Ring[(at + 4U) & RING_MASK] = c;
+        Ring[at] = header;
+    }
+}
+
+void Log_Write4(uint32_t header, uint32_t a, uint32_t b, uint32_t c, uint32_t d) {
+    uint32_t at = Log_Reserve(RECORD_WORDS(4));
+    if (at != RESERVE_FAILED) {
+        Ring[(at + 2U) & RING_MASK] = a;
+        Ring[(at + 3U) & RING_MASK] = b;
+        Ring[(at + 4U) & RING_MASK] = c;
+        Ring[(at + 5U) & RING_MASK] = d;
+        Ring[at] = header;
+    }
+}
+
+uint8_t Log_Drain(uint16_t room) {
+    uint8_t count = 0;
+    uint16_t len = FRAME_HEADER_LEN;
+
+    // Below 254 bytes, COBS adds one byte and the delimiter another
+    uint16_t limit = room > LOG_MAX_FRAME + 2U ? LOG_MAX_FRAME : (room > 2U ? room - 2U : 0);
+    if (Write == NULL || limit < FRAME_HEADER_LEN + 4U * RECORD_WORDS(0) + FRAME_CRC_LEN) {
+        return 0;
+    }
+
+    while (Tail != Head) {
+        uint32_t tail = Tail;
+        uint32_t header = Ring[tail & RING_MASK];
+        if (header == 0) {
+            // Reserved, but the writer has not finished it
+            break;
+        }
+
+        uint32_t words = RECORD_WORDS(HEADER_NARGS(header));
+        if (len + 4U * words + FRAME_CRC_LEN > limit) {
+            break;
+        }
+
+        // The words are cleared before Tail gives them back to the writers
+        for (uint32_t i = 0; i < words; i++) {
+            uint32_t word = Ring[(tail + i) & RING_MASK];
+            Ring[(tail + i) & RING_MASK] = 0;
+            Frame[len++] = (uint8_t) word;
+            Frame[len++] = (uint8_t) (word >> 8);
+            Frame[len++] = (uint8_t) (word >> 16);
+            Frame[len++] = (uint8_t) (word >> 24);
+        }
+        Tail = tail + words;
+        count++;
+    }
+
+    uint32_t lost = Dropped - Reported;
+    if (count == 0 && lost == 0) {
+        return 0;
+    }
+    if (lost > 0xFFFFU) {
+        lost = 0xFFFFU;
+    }
+    Reported += lost;
+
+    Frame[0] = Sequence++;
+    Frame[1] = (uint8_t) lost;
+    Frame[2] = (uint8_t) (lost >> 8);
+
+    uint16_t crc = Crc_Ccitt(Frame, len);
+    Frame[len++] = (uint8_t) (crc >> 8);
+    Frame[len++] = (uint8_t) crc;
+
+    Write(Encoded, Telemetry_Cobs(Frame, len, Encoded), WriteArg);
+    return count;
+}
+
+uint8_t Log_Pending(void) {
+    return Tail != Head && Ring[Tail & RING_MASK] != 0;
+}
+
+uint32_t Log_GetDropped(void) {
+    return Dropped;
+}
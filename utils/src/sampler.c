@@ -0,0 +1,266 @@
+#include "sampler.h"
+#include "temperature.h"
+#include "official_tm4c1294ncpdt.h"
+
+#include <stddef.h>
+
+// Registers of an ADC module, and of one of its sequencers, by offset
+#define ADC0_BASE_ADDR          0x40038000UL
+#define ADC1_BASE_ADDR          0x40039000UL
+#define ADC_REG(BASE, OFFSET)   (*((volatile uint32_t *) ((BASE) + (OFFSET))))
+#define ADC_ACTSS               0x000UL
+#define ADC_IM                  0x008UL
+#define ADC_ISC                 0x00CUL
+#define ADC_EMUX                0x014UL
+#define ADC_PSSI                0x028UL
+#define ADC_CC                  0xFC8UL
+#define ADC_SSMUX(SEQ)          (0x040UL + 0x20UL * (SEQ))
+#define ADC_SSCTL(SEQ)          (0x044UL + 0x20UL * (SEQ))
+#define ADC_SSFIFO(SEQ)         (0x048UL + 0x20UL * (SEQ))
+#define ADC_SSOP(SEQ)           (0x050UL + 0x20UL * (SEQ))
+#define ADC_SSEMUX(SEQ)         (0x058UL + 0x20UL * (SEQ))
+#define ADC_SSTSH(SEQ)          (0x05CUL + 0x20UL * (SEQ))
+
+// Bits of a step in SSCTL
+#define STEP_END                0x2UL
+#define STEP_IE                 0x4UL
+#define STEP_TS                 0x8UL
+
+#define TIMER4_IRQ              63U
+
+// A sequencer used by the scheduler, and the channels packed into it on the current tick
+typedef struct {
+    uint32_t Base;
+    uint8_t Seq;
+    uint8_t Depth;
+    uint8_t Irq;
+    volatile uint8_t Busy;
+    uint8_t Steps;
+    uint8_t Plan[8];
+    uint32_t Tick;
+} SamplerUnit_t;
+
+// State of a channel
+typedef struct {
+    SamplerChannel_t Config;
+    uint32_t Divider;
+    uint32_t Countdown;
+    volatile uint16_t Head;
+    volatile uint16_t Tail;
+    volatile uint32_t Dropped;
+} SamplerState_t;
+
+static SamplerUnit_t Units[2] = {
+    { ADC0_BASE_ADDR, 1U, 4U, 15U, 0, 0, {0}, 0 },
+    { ADC1_BASE_ADDR, 0U, 8U, 46U, 0, 0, {0}, 0 }
+};
+
+static SamplerState_t Channels[SAMPLER_MAX_CHANNELS];
+static uint8_t NumChannels = 0;
+static volatile uint32_t Tick = 0;
+
+// Enables an interrupt at the NVIC with the priority of the scheduler
+static void Sampler_EnableIRQ(uint8_t irq) {
+    ((volatile uint8_t *) &NVIC_PRI0_R)[irq] = (uint8_t) (SAMPLER_PRIO << 5);
+    (&NVIC_EN0_R)[irq >> 5] = 1UL << (irq & 0x1FU);
+}
+
+// Sets up a sequencer: software trigger, samples to the FIFO, interrupt at the end
+static void Sampler_InitUnit(const SamplerUnit_t *unit) {
+    uint32_t bit = 1UL << unit->Seq;
+
+    ADC_REG(unit->Base, ADC_ACTSS) &= ~bit;
+    ADC_REG(unit->Base, ADC_CC) = ADC_CC_CS_PIOSC;
+    ADC_REG(unit->Base, ADC_EMUX) &= ~(0xFUL << (unit->Seq * 4U));
+    ADC_REG(unit->Base, ADC_SSOP(unit->Seq)) = 0;
+    ADC_REG(unit->Base, ADC_ISC) = bit;
+    ADC_REG(unit->Base, ADC_IM) |= bit;
+
+    Sampler_EnableIRQ(unit->Irq);
+}
+
+// Loads the channels planned for a sequencer into its steps and starts the conversions
+static void Sampler_Trigger(SamplerUnit_t *unit) {
+    uint32_t bit = 1UL << unit->Seq;
+    uint32_t mux = 0;
+    uint32_t emux = 0;
+    uint32_t ctl = 0;
+    uint32_t tsh = 0;
+
+    for (uint8_t step = 0; step < unit->Steps; step++) {
+        uint8_t input = Channels[unit->Plan[step]].Config.Input;
+        if (input == SAMPLER_TEMP) {
+            ctl |= STEP_TS << (step * 4U);
+            tsh |= TEMP_ADC_TSH << (step * 4U);
+        } else {
+            mux |= (uint32_t) (input & 0xFU) << (step * 4U);
+            emux |= (uint32_t) (input >> 4) << (step * 4U);
+        }
+    }
+    ctl |= (STEP_END | STEP_IE) << ((unit->Steps - 1U) * 4U);
+
+    // The steps can only be changed while the sequencer is disabled
+    ADC_REG(unit->Base, ADC_ACTSS) &= ~bit;
+    ADC_REG(unit->Base, ADC_SSMUX(unit->Seq)) = mux;
+    ADC_REG(unit->Base, ADC_SSEMUX(unit->Seq)) = emux;
+    ADC_REG(unit->Base, ADC_SSCTL(unit->Seq)) = ctl;
+    ADC_REG(unit->Base, ADC_SSTSH(unit->Seq)) = tsh;
+    ADC_REG(unit->Base, ADC_ACTSS) |= bit;
+
+    unit->Tick = Tick;
+    unit->Busy = 1;
+    ADC_REG(unit->Base, ADC_PSSI) = bit;
+}
+
+// Moves the samples of a finished sequence to the ring buffers
+static void Sampler_Collect(SamplerUnit_t *unit) {
+    ADC_REG(unit->Base, ADC_ISC) = 1UL << unit->Seq;
+
+    for (uint8_t step = 0; step < unit->Steps; step++) {
+        SamplerState_t *channel = &Channels[unit->Plan[step]];
+        uint16_t value = (uint16_t) (ADC_REG(unit->Base, ADC_SSFIFO(unit->Seq)) & 0xFFFU);
+        uint16_t next = (channel->Head + 1U) & (channel->Config.Size - 1U);
+
+        if (next == channel->Tail) {
+            channel->Dropped++;
+            continue;
+        }
+
+        channel->Config.Buffer[channel->Head].Tick = unit->Tick;
+        channel->Config.Buffer[channel->Head].Value = value;
+        channel->Head = next;
+    }
+
+    unit->Busy = 0;
+}
+
+int Sampler_Init(const SamplerChannel_t *channels, uint8_t count) {
+    if (count == 0 || count > SAMPLER_MAX_CHANNELS) {
+        return -1;
+    }
+
+    for (uint8_t i = 0; i < count; i++) {
+        const SamplerChannel_t *channel = &channels[i];
+        if (channel->RateHz == 0 || SAMPLER_TICK_HZ % channel->RateHz != 0 ||
+            channel->Buffer == NULL || channel->Size < 2U ||
+            (channel->Size & (channel->Size - 1U)) != 0) {
+            return -1;
+        }
+    }
+
+    NumChannels = count;
+    Tick = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        Channels[i].Config = channels[i];
+        Channels[i].Divider = SAMPLER_TICK_HZ / channels[i].RateHz;
+
+        // Spread the channels over the ticks of their period
+        Channels[i].Countdown = 1U + (i % Channels[i].Divider);
+        Channels[i].Head = 0;
+        Channels[i].Tail = 0;
+        Channels[i].Dropped = 0;
+    }
+
+    // Enable the clocks of both ADCs and the timer, and wait until they are ready
+    SYSCTL_RCGCADC_R |= SYSCTL_RCGCADC_R0 | SYSCTL_RCGCADC_R1;
+    SYSCTL_RCGCTIMER_R |= SYSCTL_RCGCTIMER_R4;
+    while ((SYSCTL_PRADC_R & (SYSCTL_PRADC_R0 | SYSCTL_PRADC_R1)) != (SYSCTL_PRADC_R0 | SYSCTL_PRADC_R1));
+    while (!(SYSCTL_PRTIMER_R & SYSCTL_PRTIMER_R4));
+
+    for (uint8_t u = 0; u < 2U; u++) {
+        Units[u].Busy = 0;
+        Units[u].Steps = 0;
+        Sampler_InitUnit(&Units[u]);
+    }
+
+    // Tick timer: periodic 32-bit down counter on PIOSC
+    TIMER4_CTL_R &= ~TIMER_CTL_TAEN;
+    TIMER4_CFG_R = TIMER_CFG_32_BIT_TIMER;
+    TIMER4_TAMR_R = TIMER_TAMR_TAMR_PERIOD;
+    TIMER4_CC_R = TIMER_CC_ALTCLK;
+    TIMER4_TAILR_R = SAMPLER_CLOCK_FREQ / SAMPLER_TICK_HZ - 1U;
+    TIMER4_ICR_R = TIMER_ICR_TATOCINT;
+    TIMER4_IMR_R = TIMER_IMR_TATOIM;
+    Sampler_EnableIRQ(TIMER4_IRQ);
+
+    return 1;
+}
+
+void Sampler_Start(void) {
+    TIMER4_CTL_R |= TIMER_CTL_TAEN;
+}
+
+void Sampler_Stop(void) {
+    TIMER4_CTL_R &= ~TIMER_CTL_TAEN;
+}
+
+uint8_t Sampler_Read(uint8_t channel, SamplerSample_t *sample) {
+    SamplerState_t *state = &Channels[channel];
+
+    if (state->Tail == state->Head) {
+        return 0;
+    }
+
+    *sample = state->Config.Buffer[state->Tail];
+    state->Tail = (state->Tail + 1U) & (state->Config.Size - 1U);
+    return 1;
+}
+
+uint16_t Sampler_Available(uint8_t channel) {
+    const SamplerState_t *state = &Channels[channel];
+    return (state->Head - state->Tail) & (state->Config.Size - 1U);
+}
+
+uint32_t Sampler_GetDropped(uint8_t channel) {
+    return Channels[channel].Dropped;
+}
+
+uint32_t Sampler_GetTick(void) {
+    return Tick;
+}
+
+void Timer4A_Handler(void) {
+    TIMER4_ICR_R = TIMER_ICR_TATOCINT;
+    Tick++;
+
+    // A sequencer that has not finished the previous tick cannot take new steps
+    uint8_t free0 = Units[0].Busy ? 0 : Units[0].Depth;
+    uint8_t free1 = Units[1].Busy ? 0 : Units[1].Depth;
+    Units[0].Steps = Units[0].Busy ? Units[0].Steps : 0;
+    Units[1].Steps = Units[1].Busy ? Units[1].Steps : 0;
+    uint8_t used0 = 0;
+    uint8_t used1 = 0;
+
+    // Pack the channels that are due, alternating between the ADCs to balance them
+    for (uint8_t i = 0; i < NumChannels; i++) {
+        if (--Channels[i].Countdown) {
+            continue;
+        }
+        Channels[i].Countdown = Channels[i].Divider;
+
+        if (used0 < free0 && (used0 <= used1 || used1 >= free1)) {
+            Units[0].Plan[used0++] = i;
+        } else if (used1 < free1) {
+            Units[1].Plan[used1++] = i;
+        } else {
+            Channels[i].Dropped++;
+        }
+    }
+
+    if (used0) {
+        Units[0].Steps = used0;
+        Sampler_Trigger(&Units[0]);
+    }
+    if (used1) {
+        Units[1].Steps = used1;
+        Sampler_Trigger(&Units[1]);
+    }
+}
+
+void ADC0Sequence1_Handler(void) {
+    Sampler_Collect(&Units[0]);
+}
+
+void ADC1Sequence0_Handler(void) {
+    Sampler_Collect(&Units[1]);
+}
@@ -0,0 +1,254 @@
+#include "scope.h"
+#include "adc_stream.h"
+#include "SSD2119_Display.h"
+#include "official_tm4c1294ncpdt.h"
+
+// States of the capture
+#define STATE_ARMED         0U      // Looking for a trigger
+#define STATE_CAPTURING     1U      // Copying samples into the frame
+#define STATE_READY         2U      // Frame complete, waiting to be drawn
+
+// GPIO port of each analog input (bit in RCGCGPIO, 0 is port A) and its pin
+#define PORT_B              1U
+#define PORT_D              3U
+#define PORT_E              4U
+#define PORT_K              9U
+#define GPIO_BASE(PORT)     (0x40058000UL + 0x1000UL * (PORT))
+#define GPIO_REG(PORT, OFFSET)  (*((volatile uint32_t *) (GPIO_BASE(PORT) + (OFFSET))))
+#define GPIO_DIR            0x400UL
+#define GPIO_AFSEL          0x420UL
+#define GPIO_DEN            0x51CUL
+#define GPIO_AMSEL          0x528UL
+
+static const uint8_t InputPorts[20] = {
+    PORT_E, PORT_E, PORT_E, PORT_E, PORT_D, PORT_D, PORT_D, PORT_D, PORT_E, PORT_E,
+    PORT_B, PORT_B, PORT_D, PORT_D, PORT_D, PORT_D, PORT_K, PORT_K, PORT_K, PORT_K
+};
+static const uint8_t InputPins[20] = {
+    3, 2, 1, 0, 7, 6, 5, 4, 5, 4,
+    4, 5, 3, 2, 1, 0, 0, 1, 2, 3
+};
+
+static ScopeConfig_t Config;
+static uint8_t Running = 0;
+
+// DMA buffers and the frame handed to the main loop
+static uint16_t Buffers[2][SCOPE_BUFFER_LEN];
+static uint16_t Frame[SCOPE_WIDTH];
+static uint16_t FrameLen = 0;
+static volatile uint8_t State = STATE_ARMED;
+static uint8_t IdleBuffers = 0;
+
+// Trigger used for the next capture, copied when the capture is armed
+static volatile uint16_t NextLevel;
+static volatile ScopeEdge_e NextEdge;
+
+// Rows (relative to Y) of the segment drawn in each column, for erasing
+static uint8_t TraceTop[SCOPE_WIDTH];
+static uint8_t TraceBottom[SCOPE_WIDTH];
+static uint8_t TraceDrawn = 0;
+
+static uint32_t Frames = 0;
+static volatile uint32_t Samples = 0;
+
+// Configures the pin of an analog input
+static void Scope_InitPin(uint8_t input) {
+    uint8_t port = InputPorts[input];
+    uint32_t pin = 1UL << InputPins[input];
+
+    SYSCTL_RCGCGPIO_R |= 1UL << port;
+    while (!(SYSCTL_PRGPIO_R & (1UL << port)));
+
+    GPIO_REG(port, GPIO_DIR) &= ~pin;
+    GPIO_REG(port, GPIO_AFSEL) |= pin;
+    GPIO_REG(port, GPIO_DEN) &= ~pin;
+    GPIO_REG(port, GPIO_AMSEL) |= pin;
+}
+
+// Copies samples into the frame, returns 1 once it is full
+static uint8_t Scope_Fill(const uint16_t *samples, uint16_t count) {
+    while (count-- && FrameLen < SCOPE_WIDTH) {
+        Frame[FrameLen++] = *samples++;
+    }
+    return FrameLen == SCOPE_WIDTH;
+}
+
+// Runs in the ADC0 sequencer 0 interrupt for every DMA buffer
+static void Scope_Capture(const uint16_t *samples, uint16_t count, void *arg) {
+    (void) arg;
+    Samples += count;
+
+    if (State == STATE_ARMED) {
+        int32_t start = Scope_FindTrigger(&Config.Trigger, samples, count);
+
+        if (start < 0) {
+            if (!Config.Auto || ++IdleBuffers < SCOPE_AUTO_BUFFERS) {
+                return;
+            }
+            start = 0;
+        }
+
+        IdleBuffers = 0;
+        FrameLen = 0;
+        State = STATE_CAPTURING;
+        samples += start;
+        count -= (uint16_t) start;
+    }
+
+    if (State == STATE_CAPTURING && Scope_Fill(samples, count)) {
+        State = STATE_READY;
+    }
+}
+
+// Row (relative to Y) of a sample, the top row being full scale
+static uint8_t Scope_Row(uint16_t sample) {
+    uint32_t scaled = (uint32_t) sample * (Config.Height - 1U) / SCOPE_FULL_SCALE;
+    return (uint8_t) (Config.Height - 1U - scaled);
+}
+
+// Fills rows [top, bottom] of a column, if not empty
+static void Scope_FillColumn(uint16_t x, int16_t top, int16_t bottom, uint16_t color) {
+    if (top <= bottom) {
+        LCD_DrawFilledRect(x, Config.Y + (uint16_t) top, 1, bottom - top + 1, color);
+    }
+}
+
+int32_t Scope_FindTrigger(ScopeTrigger_t *trigger, const uint16_t *samples, uint16_t count) {
+    // Work on the distance past the level in the direction of the edge, so the same
+    // comparisons serve both edges: the crossing is from below -Hysteresis to 0 or above
+    int32_t sign = trigger->Edge == SCOPE_EDGE_RISING ? 1 : -1;
+    int32_t arm = -(int32_t) trigger->Hysteresis;
+
+    for (uint16_t i = 0; i < count; i++) {
+        int32_t distance = sign * ((int32_t) samples[i] - (int32_t) trigger->Level);
+
+        if (distance < arm) {
+            trigger->Primed = 1;
+        } else if (distance >= 0 && trigger->Primed) {
+            trigger->Primed = 0;
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+int Scope_Init(const ScopeConfig_t *config) {
+    if (config->Input >= sizeof(InputPorts) || config->Height < 2U || config->Height > 256U) {
+        return -1;
+    }
+
+    Config = *config;
+    Config.Trigger.Primed = 0;
+    NextLevel = Config.Trigger.Level;
+    NextEdge = Config.Trigger.Edge;
+    State = STATE_ARMED;
+    IdleBuffers = 0;
+    TraceDrawn = 0;
+    Frames = 0;
+    Samples = 0;
+
+    Scope_InitPin(Config.Input);
+    LCD_DrawFilledRect(Config.X, Config.Y, SCOPE_WIDTH, Config.Height, Config.Background);
+
+    return Scope_SetRate(Config.RateHz);
+}
+
+void Scope_Start(void) {
+    Running = 1;
+    AdcStream_Start();
+}
+
+void Scope_Stop(void) {
+    Running = 0;
+    AdcStream_Stop();
+}
+
+int Scope_SetRate(uint32_t rate_hz) {
+    AdcStreamConfig_t stream;
+
+    stream.Channels[0] = Config.Input;
+    stream.NumChannels = 1;
+    stream.RateHz = rate_hz;
+    stream.Buffers[0] = Buffers[0];
+    stream.Buffers[1] = Buffers[1];
+    stream.Length = SCOPE_BUFFER_LEN;
+    stream.Callback = Scope_Capture;
+    stream.Arg = 0;
+
+    AdcStream_Stop();
+    if (AdcStream_Init(&stream) < 0) {
+        return -1;
+    }
+
+    // A frame in progress mixes both rates: drop it
+    Config.RateHz = rate_hz;
+    if (State != STATE_READY) {
+        State = STATE_ARMED;
+    }
+
+    if (Running) {
+        AdcStream_Start();
+    }
+    return 1;
+}
+
+uint32_t Scope_GetRate(void) {
+    return Config.RateHz;
+}
+
+void Scope_SetTrigger(uint16_t level, ScopeEdge_e edge) {
+    NextLevel = level;
+    NextEdge = edge;
+}
+
+uint8_t Scope_Render(void) {
+    if (State != STATE_READY) {
+        return 0;
+    }
+
+    uint8_t previous = Scope_Row(Frame[0]);
+
+    for (uint16_t column = 0; column < SCOPE_WIDTH; column++) {
+        uint16_t x = Config.X + column;
+        uint8_t row = Scope_Row(Frame[column]);
+        uint8_t top = row < previous ? row : previous;
+        uint8_t bottom = row < previous ? previous : row;
+        previous = row;
+
+        // Erase the parts of the old segment that the new one does not cover
+        if (TraceDrawn) {
+            uint8_t old_top = TraceTop[column];
+            uint8_t old_bottom = TraceBottom[column];
+
+            if (old_top == top && old_bottom == bottom) {
+                continue;
+            }
+            Scope_FillColumn(x, old_top, (old_bottom < top ? old_bottom : top - 1), Config.Background);
+            Scope_FillColumn(x, (old_top > bottom ? old_top : bottom + 1), old_bottom, Config.Background);
+        }
+
+        Scope_FillColumn(x, top, bottom, Config.Trace);
+        TraceTop[column] = top;
+        TraceBottom[column] = bottom;
+    }
+
+    TraceDrawn = 1;
+    Frames++;
+
+    // Arm the next capture with the latest trigger settings
+    Config.Trigger.Level = NextLevel;
+    Config.Trigger.Edge = NextEdge;
+    Config.Trigger.Primed = 0;
+    State = STATE_ARMED;
+
+    return 1;
+}
+
+uint32_t Scope_GetFrames(void) {
+    return Frames;
+}
+
+uint32_t Scope_GetSamples(void) {
+    return Samples;
+}
@@ -0,0 +1,337 @@
+#include "shell.h"
+
+#include <stddef.h>
+#include <string.h>
+
+// Listings written over several polls
+#define LIST_NONE               0U
+#define LIST_COMMANDS           1U
+#define LIST_VARS               2U
+
+// Column of the help text in the listings
+#define HELP_COLUMN             20U
+
+static int Shell_Help(Shell_t *shell, uint8_t argc, char *argv[]);
+static int Shell_Get(Shell_t *shell, uint8_t argc, char *argv[]);
+static int Shell_Set(Shell_t *shell, uint8_t argc, char *argv[]);
+
+static const ShellCommand_t Builtins[] = {
+    { "help", "List the commands", Shell_Help },
+    { "get", "get [name]: print one or all variables", Shell_Get },
+    { "set", "set <name> <value>: change a variable", Shell_Set },
+};
+
+#define NUM_BUILTINS            (sizeof(Builtins) / sizeof(Builtins[0]))
+
+static void Shell_Prompt(Shell_t *shell) {
+    Fmt_Str(&shell->Out, "> ");
+}
+
+// Prints an error message. Returns 1: the command has reported it already
+static int Shell_Error(Shell_t *shell, const char *message) {
+    Fmt_Str(&shell->Out, "error: ");
+    Fmt_Str(&shell->Out, message);
+    Fmt_Str(&shell->Out, "\r\n");
+    return 1;
+}
+
+// Pads a listing line that started at <start> to the help column
+static void Shell_PadTo(Shell_t *shell, uint16_t start) {
+    uint16_t used = (uint16_t) (shell->Out.Len - start);
+    Fmt_Repeat(&shell->Out, ' ', used < HELP_COLUMN ? (uint8_t) (HELP_COLUMN - used) : 1U);
+}
+
+// Prints "name = value", and the help text in a listing
+static void Shell_PrintVar(Shell_t *shell, const ShellVar_t *var, uint8_t with_help) {
+    uint16_t start = shell->Out.Len;
+
+    Fmt_Str(&shell->Out, var->Name);
+    Fmt_Str(&shell->Out, " = ");
+    Fmt_Fixed(&shell->Out, var->Get(), var->Decimals);
+
+    if (with_help) {
+        Shell_PadTo(shell, start);
+        Fmt_Str(&shell->Out, var->Help);
+        if (var->Set == NULL) {
+            Fmt_Str(&shell->Out, " (read-only)");
+        }
+    }
+    Fmt_Str(&shell->Out, "\r\n");
+}
+
+static const ShellVar_t *Shell_FindVar(const Shell_t *shell, const char *name) {
+    for (uint8_t i = 0; i < shell->Config.NumVars; i++) {
+        if (strcmp(shell->Config.Vars[i].Name, name) == 0) {
+            return &shell->Config.Vars[i];
+        }
+    }
+    return NULL;
+}
+
+// Looks up a command, the built-in ones first
+static const ShellCommand_t *Shell_FindCommand(const Shell_t *shell, const char *name) {
+    for (uint8_t i = 0; i < NUM_BUILTINS; i++) {
+        if (strcmp(Builtins[i].Name, name) == 0) {
+            return &Builtins[i];
+        }
+    }
+    for (uint8_t i = 0; i < shell->Config.NumCommands; i++) {
+        if (strcmp(shell->Config.Commands[i].Name, name) == 0) {
+            return &shell->Config.Commands[i];
+        }
+    }
+    return NULL;
+}
+
+// Parses a decimal number into a value scaled by 10^decimals, e.g. "23.5" with 2 decimals
+// is 2350. Extra decimals are cut off. Returns 1, or -1 if it is not a number or too large
+static int Shell_ParseFixed(const char *text, uint8_t decimals, int32_t *value) {
+    int64_t magnitude = 0;
+    int8_t fraction = -1;           // Decimals read so far, -1 before the point
+    uint8_t digits = 0;
+    uint8_t negative = 0;
+
+    if (*text == '-' || *text == '+') {
+        negative = *text++ == '-';
+    }
+
+    for (; *text; text++) {
+        if (*text == '.' && fraction < 0) {
+            fraction = 0;
+            continue;
+        }
+        if (*text < '0' || *text > '9') {
+            return -1;
+        }
+        digits++;
+        if (fraction >= 0) {
+            if (fraction == decimals) {
+                continue;
+            }
+            fraction++;
+        }
+        magnitude = magnitude * 10 + (*text - '0');
+        if (magnitude > 0x80000000LL) {
+            return -1;
+        }
+    }
+
+    for (int8_t i = fraction < 0 ? 0 : fraction; i < decimals; i++) {
+        magnitude *= 10;
+        if (magnitude > 0x80000000LL) {
+            return -1;
+        }
+    }
+
+    if (digits == 0 || (!negative && magnitude > INT32_MAX)) {
+        return -1;
+    }
+    *value = (int32_t) (negative ? -magnitude : magnitude);
+    return 1;
+}
+
+static int Shell_Help(Shell_t *shell, uint8_t argc, char *argv[]) {
+    (void) argc;
+    (void) argv;
+    shell->Listing = LIST_COMMANDS;
+    shell->ListIndex = 0;
+    return 1;
+}
+
+static int Shell_Get(Shell_t *shell, uint8_t argc, char *argv[]) {
+    if (argc == 1) {
+        shell->Listing = LIST_VARS;
+        shell->ListIndex = 0;
+        return 1;
+    }
+    if (argc != 2) {
+        return Shell_Error(shell, "usage: get [name]");
+    }
+
+    const ShellVar_t *var = Shell_FindVar(shell, argv[1]);
+    if (var == NULL) {
+        return Shell_Error(shell, "unknown variable");
+    }
+    Shell_PrintVar(shell, var, 0);
+    return 1;
+}
+
+static int Shell_Set(Shell_t *shell, uint8_t argc, char *argv[]) {
+    int32_t value;
+
+    if (argc != 3) {
+        return Shell_Error(shell, "usage: set <name> <value>");
+    }
+
+    const ShellVar_t *var = Shell_FindVar(shell, argv[1]);
+    if (var == NULL) {
+        return Shell_Error(shell, "unknown variable");
+    }
+    if (var->Set == NULL) {
+        return Shell_Error(shell, "read-only");
+    }
+    if (Shell_ParseFixed(argv[2], var->Decimals, &value) < 0) {
+        return Shell_Error(shell, "invalid number");
+    }
+    if (value < var->Min || value > var->Max) {
+        Fmt_Str(&shell->Out, "error: range is ");
+        Fmt_Fixed(&shell->Out, var->Min, var->Decimals);
+        Fmt_Str(&shell->Out, " to ");
+        Fmt_Fixed(&shell->Out, var->Max, var->Decimals);
+        Fmt_Str(&shell->Out, "\r\n");
+        return 1;
+    }
+    if (var->Set(value) < 0) {
+        return Shell_Error(shell, "value refused");
+    }
+
+    Shell_PrintVar(shell, var, 0);
+    return 1;
+}
+
+// Writes the next lines of a listing, as long as the transmit ring has room for them
+static void Shell_List(Shell_t *shell) {
+    while (shell->Listing != LIST_NONE &&
+           UART_TxSpace(shell->Config.Port) >= SHELL_REPLY_ROOM) {
+        uint8_t index = shell->ListIndex++;
+
+        if (shell->Listing == LIST_COMMANDS && index < NUM_BUILTINS + shell->Config.NumCommands) {
+            const ShellCommand_t *command = index < NUM_BUILTINS ?
+                                            &Builtins[index] :
+                                            &shell->Config.Commands[index - NUM_BUILTINS];
+            uint16_t start = shell->Out.Len;
+            Fmt_Str(&shell->Out, command->Name);
+            Shell_PadTo(shell, start);
+            Fmt_Str(&shell->Out, command->Help);
+            Fmt_Str(&shell->Out, "\r\n");
+        } else if (shell->Listing == LIST_VARS && index < shell->Config.NumVars) {
+            Shell_PrintVar(shell, &shell->Config.Vars[index], 1);
+        } else {
+            shell->Listing = LIST_NONE;
+            Shell_Prompt(shell);
+        }
+    }
+}
+
+// Splits the line into words, in place. Returns the number of words, more than
+// SHELL_MAX_ARGS if there are too many
+static uint8_t Shell_Split(char *line, char *argv[]) {
+    uint8_t argc = 0;
+
+    while (*line) {
+        while (*line == ' ') {
+            *line++ = '\0';
+        }
+        if (*line == '\0') {
+            break;
+        }
+        if (argc == SHELL_MAX_ARGS) {
+            return argc + 1U;
+        }
+        argv[argc++] = line;
+        while (*line && *line != ' ') {
+            line++;
+        }
+    }
+    return argc;
+}
+
+// Runs the line that just ended
+static void Shell_Run(Shell_t *shell) {
+    char *argv[SHELL_MAX_ARGS];
+
+    shell->Line[shell->Len] = '\0';
+    uint8_t argc = Shell_Split(shell->Line, argv);
+
+    if (shell->Overflow) {
+        Shell_Error(shell, "line too long");
+    } else if (argc > SHELL_MAX_ARGS) {
+        Shell_Error(shell, "too many arguments");
+    } else if (argc) {
+        const ShellCommand_t *command = Shell_FindCommand(shell, argv[0]);
+
+        if (command == NULL) {
+            Shell_Error(shell, "unknown command, try help");
+        } else if (command->Handler(shell, argc, argv) < 0) {
+            Fmt_Str(&shell->Out, "error\r\n");
+        }
+    }
+
+    shell->Len = 0;
+    shell->Overflow = 0;
+
+    // A listing prints the prompt once it is done
+    if (shell->Listing == LIST_NONE) {
+        Shell_Prompt(shell);
+    }
+}
+
+// Edits the line with a received character
+static void Shell_Input(Shell_t *shell, char c) {
+    uint8_t last_cr = shell->LastCr;
+    shell->LastCr = c == '\r';
+
+    if (c == '\r' || c == '\n') {
+        if (c == '\n' && last_cr) {
+            return;
+        }
+        Fmt_Str(&shell->Out, "\r\n");
+        Shell_Run(shell);
+    } else if (c == '\b' || c == 0x7F) {
+        if (shell->Len) {
+            shell->Len--;
+            Fmt_Str(&shell->Out, "\b \b");
+        }
+    } else if (c == 0x03) {
+        // Ctrl-C drops the line
+        shell->Len = 0;
+        shell->Overflow = 0;
+        Fmt_Str(&shell->Out, "^C\r\n");
+        Shell_Prompt(shell);
+    } else if (c >= ' ' && c <= '~') {
+        if (shell->Len < SHELL_LINE_LEN - 1U) {
+            shell->Line[shell->Len++] = c;
+            Fmt_Char(&shell->Out, c);
+        } else {
+            shell->Overflow = 1;
+        }
+    }
+}
+
+void Shell_Init(Shell_t *shell, const ShellConfig_t *config) {
+    shell->Config = *config;
+    shell->Len = 0;
+    shell->Overflow = 0;
+    shell->LastCr = 0;
+    shell->Listing = LIST_NONE;
+    shell->ListIndex = 0;
+
+    Fmt_UartSink(&shell->Out, config->Port);
+    Fmt_Str(&shell->Out, "\r\n");
+    Shell_Prompt(shell);
+}
+
+void Shell_Poll(Shell_t *shell) {
+    uint8_t c;
+
+    Shell_List(shell);
+
+    // The rest of the input waits in the receive ring while a listing is written
+    for (uint8_t i = 0; i < SHELL_POLL_BYTES && shell->Listing == LIST_NONE; i++) {
+        if (UART_Read(shell->Config.Port, &c, 1) == 0) {
+            break;
+        }
+        Shell_Input(shell, (char) c);
+    }
+
+    Shell_List(shell);
+}
+
+uint8_t Shell_Busy(const Shell_t *shell) {
+    // A listing holds the input back, and only goes on once the transmit ring has room.
+    // Until then the transmit interrupt drains the ring and there is nothing to do
+    if (shell->Listing != LIST_NONE) {
+        return UART_TxSpace(shell->Config.Port) >= SHELL_REPLY_ROOM;
+    }
+    return UART_RxCount(shell->Config.Port) != 0;
+}
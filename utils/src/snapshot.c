@@ -0,0 +1,41 @@
+#include "snapshot.h"
+
+void Snapshot_Init(Snapshot_t *snapshot) {
+    snapshot->Sequence = 0;
+    snapshot->Value = 0;
+    snapshot->Timestamp = 0;
+}
+
+void Snapshot_Publish(Snapshot_t *snapshot, int32_t value, uint32_t timestamp) {
+    uint32_t sequence = snapshot->Sequence;
+
+    snapshot->Sequence = sequence + 1U;
+    snapshot->Value = value;
+    snapshot->Timestamp = timestamp;
+    snapshot->Sequence = sequence + 2U;
+}
+
+uint8_t Snapshot_IsNew(const Snapshot_t *snapshot, uint32_t seen) {
+    uint32_t sequence = snapshot->Sequence;
+    return sequence != 0 && (sequence | 1U) != (seen | 1U);
+}
+
+uint8_t Snapshot_Read(const Snapshot_t *snapshot, SnapshotSample_t *sample, uint32_t *seen) {
+    uint32_t before;
+    uint32_t after;
+
+    // Retry until no write started or finished during the copy
+    do {
+        before = snapshot->Sequence;
+        sample->Value = snapshot->Value;
+        sample->Timestamp = snapshot->Timestamp;
+        after = snapshot->Sequence;
+    } while ((before & 1U) || before != after);
+
+    if (before == 0 || before == *seen) {
+        return 0;
+    }
+
+    *seen = before;
+    return 1;
+}
@@ -0,0 +1,82 @@
+#include "spectrum_view.h"
+#include "SSD2119_Display.h"
+
+// Fractional bits of the logarithm, and its value at full scale (log2(2^16) = 16)
+#define LOG2_FRAC_BITS      3U
+#define LOG2_FULL_SCALE     (16U << LOG2_FRAC_BITS)
+
+// log2 of a magnitude with LOG2_FRAC_BITS fractional bits, 0 for 0 and 1
+static uint16_t SpectrumView_Log2(uint16_t value) {
+    uint8_t msb = 0;
+
+    if (value < 2U) {
+        return 0;
+    }
+    while (value >> (msb + 1U)) {
+        msb++;
+    }
+
+    // The bits below the leading one approximate the fraction (linear interpolation)
+    uint16_t fraction = (uint16_t) ((((uint32_t) value << LOG2_FRAC_BITS) >> msb) & ((1U << LOG2_FRAC_BITS) - 1U));
+    return (uint16_t) ((msb << LOG2_FRAC_BITS) | fraction);
+}
+
+int SpectrumView_Init(SpectrumView_t *view, const SpectrumViewConfig_t *config) {
+    if (config->NumBars == 0 || config->NumBars > SPECTRUM_VIEW_MAX_BARS ||
+        config->BarWidth == 0 || config->Height == 0) {
+        return -1;
+    }
+
+    view->Config = *config;
+    for (uint8_t i = 0; i < SPECTRUM_VIEW_MAX_BARS; i++) {
+        view->Heights[i] = 0;
+    }
+
+    LCD_DrawFilledRect(config->X, config->Y,
+                       config->NumBars * (config->BarWidth + config->Gap), config->Height,
+                       config->Background);
+    return 1;
+}
+
+uint8_t SpectrumView_Update(SpectrumView_t *view, const uint16_t *magnitude, uint16_t bins) {
+    const SpectrumViewConfig_t *config = &view->Config;
+    uint16_t bottom = config->Y + config->Height;
+    uint8_t redrawn = 0;
+
+    if (bins < 2U) {
+        return 0;
+    }
+
+    for (uint8_t bar = 0; bar < config->NumBars; bar++) {
+        // Bins [first, last) of this bar, without the DC bin
+        uint16_t first = 1U + (uint16_t) ((uint32_t) (bins - 1U) * bar / config->NumBars);
+        uint16_t last = 1U + (uint16_t) ((uint32_t) (bins - 1U) * (bar + 1U) / config->NumBars);
+        uint16_t peak = 0;
+
+        for (uint16_t bin = first; bin < last; bin++) {
+            if (magnitude[bin] > peak) {
+                peak = magnitude[bin];
+            }
+        }
+
+        uint16_t height = (uint16_t) ((uint32_t) SpectrumView_Log2(peak) * config->Height / LOG2_FULL_SCALE);
+        uint16_t old = view->Heights[bar];
+        uint16_t x = config->X + bar * (config->BarWidth + config->Gap);
+
+        if (height == old) {
+            continue;
+        }
+
+        // Paint the part that grew, or erase the part that shrank
+        if (height > old) {
+            LCD_DrawFilledRect(x, bottom - height, config->BarWidth, height - old, config->Bar);
+        } else {
+            LCD_DrawFilledRect(x, bottom - old, config->BarWidth, old - height, config->Background);
+        }
+
+        view->Heights[bar] = height;
+        redrawn++;
+    }
+
+    return redrawn;
+}
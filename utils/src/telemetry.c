@@ -0,0 +1,113 @@
+#include "telemetry.h"
+#include "crc.h"
+
+// Sequence number and start time
+#define FRAME_HEADER_LEN        5U
+
+// Longest record: a time step (1 + 5 bytes) and a value with a 3-byte tag (3 + 5 bytes),
+// since the tags of channels 0x1000 and up have more than 14 bits
+#define RECORD_MAX_LEN          14U
+
+#define CRC_LEN                 2U
+
+// Appends a varint to the open frame
+static void Telemetry_PutVarint(Telemetry_t *telemetry, uint32_t value) {
+    while (value >= 0x80U) {
+        telemetry->Frame[telemetry->Len++] = (uint8_t) (value | 0x80U);
+        value >>= 7;
+    }
+    telemetry->Frame[telemetry->Len++] = (uint8_t) value;
+}
+
+// Appends a record, opening a new frame if needed
+static int Telemetry_Put(Telemetry_t *telemetry, uint16_t channel, uint8_t type,
+                         uint32_t value, uint32_t time) {
+    if (channel > TELEMETRY_MAX_CHANNEL) {
+        return -1;
+    }
+
+    if (telemetry->Len + RECORD_MAX_LEN + CRC_LEN > TELEMETRY_MAX_FRAME) {
+        Telemetry_Flush(telemetry);
+    }
+
+    if (telemetry->Len == 0) {
+        telemetry->Frame[0] = telemetry->Sequence;
+        telemetry->Frame[1] = (uint8_t) time;
+        telemetry->Frame[2] = (uint8_t) (time >> 8);
+        telemetry->Frame[3] = (uint8_t) (time >> 16);
+        telemetry->Frame[4] = (uint8_t) (time >> 24);
+        telemetry->Len = FRAME_HEADER_LEN;
+        telemetry->Time = time;
+    } else if (time != telemetry->Time) {
+        Telemetry_PutVarint(telemetry, TELEMETRY_TYPE_TIME);
+        Telemetry_PutVarint(telemetry, time - telemetry->Time);
+        telemetry->Time = time;
+    }
+
+    Telemetry_PutVarint(telemetry, ((uint32_t) channel << 2) | type);
+    Telemetry_PutVarint(telemetry, value);
+    return 1;
+}
+
+void Telemetry_Init(Telemetry_t *telemetry, TelemetryWrite_t write, void *arg) {
+    telemetry->Write = write;
+    telemetry->Arg = arg;
+    telemetry->Len = 0;
+    telemetry->Sequence = 0;
+    telemetry->Time = 0;
+
+    Crc_Init();
+}
+
+int Telemetry_PutInt(Telemetry_t *telemetry, uint16_t channel, int32_t value, uint32_t time) {
+    // Zigzag: the sign goes to bit 0, so small magnitudes give short varints
+    uint32_t zigzag = ((uint32_t) value << 1) ^ (uint32_t) (value >> 31);
+    return Telemetry_Put(telemetry, channel, TELEMETRY_TYPE_INT, zigzag, time);
+}
+
+int Telemetry_PutUInt(Telemetry_t *telemetry, uint16_t channel, uint32_t value, uint32_t time) {
+    return Telemetry_Put(telemetry, channel, TELEMETRY_TYPE_UINT, value, time);
+}
+
+void Telemetry_Flush(Telemetry_t *telemetry) {
+    if (telemetry->Len == 0) {
+        return;
+    }
+
+    uint16_t crc = Crc_Ccitt(telemetry->Frame, telemetry->Len);
+    telemetry->Frame[telemetry->Len++] = (uint8_t) (crc >> 8);
+    telemetry->Frame[telemetry->Len++] = (uint8_t) crc;
+
+    uint16_t len = Telemetry_Cobs(telemetry->Frame, telemetry->Len, telemetry->Encoded);
+    telemetry->Write(telemetry->Encoded, len, telemetry->Arg);
+
+    telemetry->Sequence++;
+    telemetry->Len = 0;
+}
+
+uint16_t Telemetry_Cobs(const uint8_t *in, uint16_t len, uint8_t *out) {
+    // Each block starts with a code: the distance to the next zero (or 0xFF for 254
+    // bytes without one), which is filled in once the block ends
+    uint16_t code_pos = 0;
+    uint16_t pos = 1;
+    uint8_t code = 1;
+
+    for (uint16_t i = 0; i < len; i++) {
+        if (in[i] == 0) {
+            out[code_pos] = code;
+            code_pos = pos++;
+            code = 1;
+        } else {
+            out[pos++] = in[i];
+            if (++code == 0xFFU) {
+                out[code_pos] = code;
+                code_pos = pos++;
+                code = 1;
+            }
+        }
+    }
+    out[code_pos] = code;
+    out[pos++] = 0;
+
+    return pos;
+}
@@ -0,0 +1,10 @@
+#include "temperature.h"
+#include "fmt.h"
+
+uint8_t Temp_Format(char *buffer, int32_t centi) {
+    FmtSink_t sink;
+
+    Fmt_BufferSink(&sink, buffer, TEMP_STR_LEN);
+    Fmt_Fixed(&sink, centi, 2);
+    return (uint8_t) sink.Len;
+}
@@ -0,0 +1,26 @@
+#include "timebase.h"
+#include "official_tm4c1294ncpdt.h"
+
+// Milliseconds since Timebase_Init()
+static volatile uint32_t Millis = 0;
+
+void Timebase_Init(void) {
+    // Stop SysTick while it is being configured
+    NVIC_ST_CTRL_R = 0;
+    NVIC_ST_RELOAD_R = (TIMEBASE_CLOCK_FREQ / TIMEBASE_TICK_HZ) - 1U;
+    NVIC_ST_CURRENT_R = 0;
+
+    // SysTick priority lives in bits 31:29 of SYSPRI3
+    NVIC_SYS_PRI3_R = (NVIC_SYS_PRI3_R & 0x1FFFFFFFUL) | ((uint32_t) TIMEBASE_PRIO << 29);
+
+    // CLK_SRC cleared selects PIOSC / 4, which does not change with the system clock
+    NVIC_ST_CTRL_R = NVIC_ST_CTRL_INTEN | NVIC_ST_CTRL_ENABLE;
+}
+
+uint32_t Timebase_Millis(void) {
+    return Millis;
+}
+
+void SysTick_Handler(void) {
+    Millis++;
+}
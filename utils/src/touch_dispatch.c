@@ -0,0 +1,213 @@
+#include "touch_dispatch.h"
+#include "SSD2119_Touch.h"
+
+#include <stddef.h>
+
+// Registered regions, indexed by region id
+static TouchRegion_t Regions[TOUCH_MAX_REGIONS];
+static uint8_t NumRegions = 0;
+
+// Each cell holds a bitmask of the regions that overlap it (bit <i> is region <i>)
+static uint32_t Grid[TOUCH_GRID_SIZE][TOUCH_GRID_SIZE];
+
+// Recognizer that filters the samples and times the gestures
+static TouchGesture_t Gesture;
+static uint8_t GestureReady = 0;
+
+// Region under the finger when it landed (receives taps and swipes), and region
+// that currently holds the touch (receives long-presses, drags and the release)
+static int8_t Origin = TOUCH_NO_REGION;
+static int8_t Captured = TOUCH_NO_REGION;
+
+// De Bruijn sequence used to find the index of the lowest set bit of a mask
+static const uint8_t DeBruijnIndex[32] = {
+     0,  1, 28,  2, 29, 14, 24,  3, 30, 22, 20, 15, 25, 17,  4,  8,
+    31, 27, 13, 23, 21, 19, 16,  7, 26, 12, 18,  6, 11,  5, 10,  9
+};
+
+#define LOWEST_BIT_INDEX(MASK)      (DeBruijnIndex[(((MASK) & -(MASK)) * 0x077CB531UL) >> 27])
+
+// Sends an event to the callback of a region
+static void TouchDispatch_Emit(int8_t region, TouchEvent_e type, const TouchGestureEvent_t *gesture) {
+    TouchEvent_t event;
+
+    if (region == TOUCH_NO_REGION || Regions[region].Callback == NULL) {
+        return;
+    }
+
+    event.Type = type;
+    event.X = gesture->X;
+    event.Y = gesture->Y;
+    event.DX = gesture->DX;
+    event.DY = gesture->DY;
+    event.Timestamp = gesture->Timestamp;
+    Regions[region].Callback(region, &event, Regions[region].Arg);
+}
+
+// Checks if (x, y) lies strictly within a region
+static uint8_t TouchDispatch_Inside(const TouchRegion_t *region, unsigned long x, unsigned long y) {
+    return region->Left < x && x < region->Right && region->Bottom < y && y < region->Top;
+}
+
+// Loads the default gesture configuration the first time the dispatcher is used
+static void TouchDispatch_InitGesture(void) {
+    if (!GestureReady) {
+        TouchGesture_Init(&Gesture, NULL);
+        GestureReady = 1;
+    }
+}
+
+// Releases the captured region, if any
+static void TouchDispatch_Release(const TouchGestureEvent_t *gesture) {
+    int8_t released = Captured;
+    Captured = TOUCH_NO_REGION;
+    TouchDispatch_Emit(released, TOUCH_EVENT_RELEASE, gesture);
+}
+
+void TouchDispatch_Reset(void) {
+    for (uint8_t i = 0; i < TOUCH_GRID_SIZE; i++) {
+        for (uint8_t j = 0; j < TOUCH_GRID_SIZE; j++) {
+            Grid[i][j] = 0;
+        }
+    }
+
+    NumRegions = 0;
+    Origin = TOUCH_NO_REGION;
+    Captured = TOUCH_NO_REGION;
+
+    // Restart the recognizer but keep its configuration
+    TouchDispatch_InitGesture();
+    TouchGesture_Init(&Gesture, &Gesture.Config);
+}
+
+int8_t TouchDispatch_Register(const TouchRegion_t *region) {
+    if (NumRegions >= TOUCH_MAX_REGIONS || region->Left >= region->Right ||
+        region->Bottom >= region->Top || region->Right > (1U << TOUCH_RAW_BITS) ||
+        region->Top > (1U << TOUCH_RAW_BITS)) {
+        return TOUCH_NO_REGION;
+    }
+
+    int8_t id = (int8_t) NumRegions;
+    Regions[id] = *region;
+    NumRegions++;
+
+    // Mark every cell overlapped by the region. Limits are exclusive, so the cells
+    // holding Left and Right themselves only matter for the coordinates in between
+    uint16_t col_first = (region->Left + 1U) >> TOUCH_GRID_SHIFT;
+    uint16_t col_last = (region->Right - 1U) >> TOUCH_GRID_SHIFT;
+    uint16_t row_first = (region->Bottom + 1U) >> TOUCH_GRID_SHIFT;
+    uint16_t row_last = (region->Top - 1U) >> TOUCH_GRID_SHIFT;
+
+    for (uint16_t col = col_first; col <= col_last; col++) {
+        for (uint16_t row = row_first; row <= row_last; row++) {
+            Grid[col][row] |= (1UL << id);
+        }
+    }
+
+    return id;
+}
+
+void TouchDispatch_SetLongPress(uint32_t ms) {
+    TouchDispatch_InitGesture();
+    Gesture.Config.LongPressMs = ms;
+}
+
+void TouchDispatch_SetRepeat(uint32_t ms) {
+    TouchDispatch_InitGesture();
+    Gesture.Config.RepeatMs = ms;
+}
+
+void TouchDispatch_SetGestureConfig(const TouchGestureConfig_t *config) {
+    TouchDispatch_InitGesture();
+    Gesture.Config = *config;
+}
+
+int8_t TouchDispatch_HitTest(unsigned long x, unsigned long y) {
+    if (x >= (1UL << TOUCH_RAW_BITS) || y >= (1UL << TOUCH_RAW_BITS)) {
+        return TOUCH_NO_REGION;
+    }
+
+    // Only the few regions that overlap this cell have to be checked
+    uint32_t candidates = Grid[x >> TOUCH_GRID_SHIFT][y >> TOUCH_GRID_SHIFT];
+
+    while (candidates) {
+        int8_t id = (int8_t) LOWEST_BIT_INDEX(candidates);
+        if (TouchDispatch_Inside(&Regions[id], x, y)) {
+            return id;
+        }
+        candidates &= candidates - 1U;
+    }
+
+    return TOUCH_NO_REGION;
+}
+
+void TouchDispatch_Process(unsigned long x, unsigned long y, uint32_t now) {
+    TouchGestureEvent_t gesture;
+
+    TouchDispatch_InitGesture();
+    if (TouchGesture_Process(&Gesture, x, y, now, &gesture)) {
+        switch (gesture.Type) {
+            case GESTURE_DOWN:
+                Origin = TouchDispatch_HitTest(gesture.X, gesture.Y);
+                Captured = Origin;
+                TouchDispatch_Emit(Captured, TOUCH_EVENT_PRESS, &gesture);
+                break;
+
+            case GESTURE_LONG_PRESS:
+                TouchDispatch_Emit(Captured, TOUCH_EVENT_LONG_PRESS, &gesture);
+                break;
+
+            case GESTURE_REPEAT:
+                TouchDispatch_Emit(Captured, TOUCH_EVENT_REPEAT, &gesture);
+                break;
+
+            case GESTURE_DRAG:
+                if (Captured != TOUCH_NO_REGION && 
+                    TouchDispatch_Inside(&Regions[Captured], gesture.X, gesture.Y)) {
+                    TouchDispatch_Emit(Captured, TOUCH_EVENT_DRAG, &gesture);
+                }
+                break;
+
+            case GESTURE_TAP:
+                TouchDispatch_Emit(Origin, TOUCH_EVENT_TAP, &gesture);
+                TouchDispatch_Release(&gesture);
+                break;
+
+            case GESTURE_SWIPE:
+                TouchDispatch_Emit(Origin, TOUCH_EVENT_SWIPE, &gesture);
+                TouchDispatch_Release(&gesture);
+                break;
+
+            case GESTURE_UP:
+            default:
+                TouchDispatch_Release(&gesture);
+                break;
+        }
+    }
+
+    if (!TouchGesture_IsDown(&Gesture)) {
+        return;
+    }
+
+    // The finger may slide off the captured region, or into another region
+    gesture.X = Gesture.X;
+    gesture.Y = Gesture.Y;
+    gesture.DX = 0;
+    gesture.DY = 0;
+    gesture.Timestamp = now;
+
+    if (Captured != TOUCH_NO_REGION && !TouchDispatch_Inside(&Regions[Captured], Gesture.X, Gesture.Y)) {
+        TouchDispatch_Release(&gesture);
+    }
+
+    if (Captured == TOUCH_NO_REGION) {
+        Captured = TouchDispatch_HitTest(Gesture.X, Gesture.Y);
+        TouchDispatch_Emit(Captured, TOUCH_EVENT_PRESS, &gesture);
+    }
+}
+
+void TouchDispatch_Poll(uint32_t now) {
+    unsigned long x = Touch_ReadX();
+    unsigned long y = Touch_ReadY();
+    TouchDispatch_Process(x, y, now);
+}
@@ -0,0 +1,179 @@
+#include "touch_gesture.h"
+
+#include <stddef.h>
+
+// States of the recognizer
+#define STATE_IDLE          0U      // No finger on the panel
+#define STATE_PRESSED       1U      // Finger down and still
+#define STATE_LONG          2U      // Finger held still past the long-press time
+#define STATE_DRAGGING      3U      // Finger moved past the slop
+
+#define ABS16(V)            ((V) < 0 ? -(V) : (V))
+
+// Median of three values
+static uint16_t Median3(uint16_t a, uint16_t b, uint16_t c) {
+    if (a > b) {
+        uint16_t t = a;
+        a = b;
+        b = t;
+    }
+    if (b > c) {
+        b = c;
+    }
+    return a > b ? a : b;
+}
+
+// Adds a sample to the median filter and updates the filtered position
+static void TouchGesture_Filter(TouchGesture_t *gesture, uint16_t x, uint16_t y) {
+    gesture->HistX[gesture->HistPos] = x;
+    gesture->HistY[gesture->HistPos] = y;
+    gesture->HistPos = (gesture->HistPos + 1U) % GESTURE_MEDIAN_LEN;
+    if (gesture->HistLen < GESTURE_MEDIAN_LEN) {
+        gesture->HistLen++;
+    }
+
+    if (gesture->HistLen < GESTURE_MEDIAN_LEN) {
+        gesture->X = x;
+        gesture->Y = y;
+    } else {
+        gesture->X = Median3(gesture->HistX[0], gesture->HistX[1], gesture->HistX[2]);
+        gesture->Y = Median3(gesture->HistY[0], gesture->HistY[1], gesture->HistY[2]);
+    }
+}
+
+// Fills the common fields of an event
+static uint8_t TouchGesture_Emit(TouchGesture_t *gesture, TouchGestureEvent_t *event,
+                                 TouchGesture_e type, int16_t dx, int16_t dy, uint32_t now) {
+    event->Type = type;
+    event->Direction = SWIPE_LEFT;
+    event->X = gesture->X;
+    event->Y = gesture->Y;
+    event->DX = dx;
+    event->DY = dy;
+    event->Duration = now - gesture->DownTime;
+    event->Timestamp = now;
+    return 1;
+}
+
+void TouchGesture_DefaultConfig(TouchGestureConfig_t *config) {
+    config->LongPressMs = GESTURE_LONG_PRESS_DEFAULT_MS;
+    config->RepeatMs = GESTURE_REPEAT_DEFAULT_MS;
+    config->TapMaxMs = GESTURE_TAP_MAX_DEFAULT_MS;
+    config->SwipeMaxMs = GESTURE_SWIPE_MAX_DEFAULT_MS;
+    config->SlopCounts = GESTURE_SLOP_DEFAULT;
+    config->SwipeMinCounts = GESTURE_SWIPE_MIN_DEFAULT;
+    config->DebounceDown = GESTURE_DEBOUNCE_DOWN_DEFAULT;
+    config->DebounceUp = GESTURE_DEBOUNCE_UP_DEFAULT;
+}
+
+void TouchGesture_Init(TouchGesture_t *gesture, const TouchGestureConfig_t *config) {
+    if (config == NULL) {
+        TouchGesture_DefaultConfig(&gesture->Config);
+    } else {
+        gesture->Config = *config;
+    }
+
+    gesture->HistLen = 0;
+    gesture->HistPos = 0;
+    gesture->TouchedCount = 0;
+    gesture->UntouchedCount = 0;
+    gesture->State = STATE_IDLE;
+    gesture->X = 0;
+    gesture->Y = 0;
+    gesture->DownTime = 0;
+    gesture->RepeatTime = 0;
+}
+
+uint8_t TouchGesture_IsDown(const TouchGesture_t *gesture) {
+    return gesture->State != STATE_IDLE;
+}
+
+uint8_t TouchGesture_Process(TouchGesture_t *gesture, unsigned long x, unsigned long y,
+                             uint32_t now, TouchGestureEvent_t *event) {
+    TouchGestureConfig_t *config = &gesture->Config;
+    uint8_t touched = (GESTURE_RAW_MIN <= x && x <= GESTURE_RAW_MAX &&
+                       GESTURE_RAW_MIN <= y && y <= GESTURE_RAW_MAX);
+
+    // Debounce: count consecutive touched/untouched samples
+    if (touched) {
+        gesture->UntouchedCount = 0;
+        if (gesture->TouchedCount < 0xFFU) {
+            gesture->TouchedCount++;
+        }
+        TouchGesture_Filter(gesture, (uint16_t) x, (uint16_t) y);
+    } else {
+        gesture->TouchedCount = 0;
+        if (gesture->UntouchedCount < 0xFFU) {
+            gesture->UntouchedCount++;
+        }
+    }
+
+    if (gesture->State == STATE_IDLE) {
+        if (gesture->TouchedCount < config->DebounceDown) {
+            return 0;
+        }
+
+        gesture->State = STATE_PRESSED;
+        gesture->DownTime = now;
+        gesture->StartX = gesture->LastX = gesture->X;
+        gesture->StartY = gesture->LastY = gesture->Y;
+        return TouchGesture_Emit(gesture, event, GESTURE_DOWN, 0, 0, now);
+    }
+
+    int16_t totalX = (int16_t) gesture->X - (int16_t) gesture->StartX;
+    int16_t totalY = (int16_t) gesture->Y - (int16_t) gesture->StartY;
+
+    // Finger lifted: decide which gesture has just finished
+    if (gesture->UntouchedCount >= config->DebounceUp) {
+        uint8_t state = gesture->State;
+        uint32_t duration = now - gesture->DownTime;
+
+        gesture->State = STATE_IDLE;
+        gesture->HistLen = 0;
+        gesture->HistPos = 0;
+
+        if (state == STATE_PRESSED && duration <= config->TapMaxMs) {
+            return TouchGesture_Emit(gesture, event, GESTURE_TAP, 0, 0, now);
+        }
+
+        if (state == STATE_DRAGGING && duration <= config->SwipeMaxMs &&
+            (ABS16(totalX) >= (int16_t) config->SwipeMinCounts ||
+             ABS16(totalY) >= (int16_t) config->SwipeMinCounts)) {
+            TouchGesture_Emit(gesture, event, GESTURE_SWIPE, totalX, totalY, now);
+            if (ABS16(totalX) >= ABS16(totalY)) {
+                event->Direction = totalX > 0 ? SWIPE_RIGHT : SWIPE_LEFT;
+            } else {
+                event->Direction = totalY > 0 ? SWIPE_UP : SWIPE_DOWN;
+            }
+            return 1;
+        }
+
+        return TouchGesture_Emit(gesture, event, GESTURE_UP, 0, 0, now);
+    }
+
+    // Finger still down: look for movement, then for a long-press
+    int16_t dx = (int16_t) gesture->X - (int16_t) gesture->LastX;
+    int16_t dy = (int16_t) gesture->Y - (int16_t) gesture->LastY;
+
+    if (ABS16(dx) >= (int16_t) config->SlopCounts || ABS16(dy) >= (int16_t) config->SlopCounts) {
+        gesture->State = STATE_DRAGGING;
+        gesture->LastX = gesture->X;
+        gesture->LastY = gesture->Y;
+        return TouchGesture_Emit(gesture, event, GESTURE_DRAG, dx, dy, now);
+    }
+
+    if (gesture->State == STATE_PRESSED && now - gesture->DownTime >= config->LongPressMs) {
+        gesture->State = STATE_LONG;
+        gesture->RepeatTime = now;
+        return TouchGesture_Emit(gesture, event, GESTURE_LONG_PRESS, 0, 0, now);
+    }
+
+    // Repeats keep their period even if the samples come late
+    if (gesture->State == STATE_LONG && config->RepeatMs &&
+        now - gesture->RepeatTime >= config->RepeatMs) {
+        gesture->RepeatTime += config->RepeatMs;
+        return TouchGesture_Emit(gesture, event, GESTURE_REPEAT, 0, 0, now);
+    }
+
+    return 0;
+}
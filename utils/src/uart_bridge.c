@@ -0,0 +1,35 @@
+#include "uart_bridge.h"
+
+// Moves bytes from the receive ring of one port to the transmit ring of the other
+static uint16_t UartBridge_Forward(UartPort_e from, UartPort_e to) {
+    uint8_t chunk[UART_BRIDGE_CHUNK];
+    uint16_t total = 0;
+
+    while (1) {
+        uint16_t space = UART_TxSpace(to);
+        uint16_t count = UART_Read(from, chunk, space < sizeof(chunk) ? space : sizeof(chunk));
+
+        if (count == 0) {
+            return total;
+        }
+        UART_Write(to, chunk, count);
+        total += count;
+    }
+}
+
+int UartBridge_Init(UartBridge_t *bridge, UartPort_e a, UartPort_e b) {
+    if (a == b) {
+        return -1;
+    }
+
+    bridge->PortA = a;
+    bridge->PortB = b;
+    return 1;
+}
+
+uint16_t UartBridge_Poll(UartBridge_t *bridge) {
+    uint16_t a_to_b = UartBridge_Forward(bridge->PortA, bridge->PortB);
+    uint16_t b_to_a = UartBridge_Forward(bridge->PortB, bridge->PortA);
+
+    return a_to_b + b_to_a;
+}
@@ -0,0 +1,631 @@
+#include "uart_ring.h"
+#include "official_tm4c1294ncpdt.h"
+
+#include <stddef.h>
+
+// Makes a write to the NVIC take effect before the next instruction
+#if defined(__ICCARM__)
+#include <intrinsics.h>
+#define UART_RING_BARRIER()     do { __DSB(); __ISB(); } while (0)
+#elif defined(__GNUC__) && defined(__arm__)
+#define UART_RING_BARRIER()     __asm volatile ("dsb\n\tisb" ::: "memory")
+#else
+#define UART_RING_BARRIER()     ((void) 0)
+#endif
+
+// Registers of a UART by offset, the modules are 4 KB apart
+#define UART0_BASE_ADDR         0x4000C000UL
+#define UART_BASE(PORT)         (UART0_BASE_ADDR + 0x1000UL * (PORT))
+#define UART_REG(BASE, OFFSET)  (*((volatile uint32_t *) ((BASE) + (OFFSET))))
+#define UART_DR                 0x000UL
+#define UART_ECR                0x004UL
+#define UART_FR                 0x018UL
+#define UART_IBRD               0x024UL
+#define UART_FBRD               0x028UL
+#define UART_LCRH               0x02CUL
+#define UART_CTL                0x030UL
+#define UART_IFLS               0x034UL
+#define UART_IM                 0x038UL
+#define UART_MIS                0x040UL
+#define UART_ICR                0x044UL
+#define UART_DMACTL             0x048UL
+#define UART_CC                 0xFC8UL
+
+// Control word of a uDMA task: bytes of a buffer to the data register. The last task of
+// a chain is a basic transfer, which ends the chain
+#define UART_DMA_TASK(LENGTH, MODE) (UDMA_CHCTL_DSTINC_NONE | UDMA_CHCTL_DSTSIZE_8 |        \
+                                     UDMA_CHCTL_SRCINC_8 | UDMA_CHCTL_SRCSIZE_8 |           \
+                                     UDMA_CHCTL_ARBSIZE_4 |                                 \
+                                     (((uint32_t) (LENGTH) - 1U) << UDMA_CHCTL_XFERSIZE_S) | \
+                                     (MODE))
+
+// Control word of the primary entry: copies each task (4 words) into the alternate entry
+#define UART_DMA_LIST(TASKS)        (UDMA_CHCTL_DSTINC_32 | UDMA_CHCTL_DSTSIZE_32 |         \
+                                     UDMA_CHCTL_SRCINC_32 | UDMA_CHCTL_SRCSIZE_32 |         \
+                                     UDMA_CHCTL_ARBSIZE_4 |                                 \
+                                     ((4U * (uint32_t) (TASKS) - 1U) << UDMA_CHCTL_XFERSIZE_S) | \
+                                     UDMA_CHCTL_XFERMODE_PER_SG)
+
+// Queues of message buffers, by index in the pool (a power of two above UART_MSG_MAX_COUNT)
+#define MSG_QUEUE_LEN           16U
+#define MSG_QUEUE_MASK          (MSG_QUEUE_LEN - 1U)
+
+// States of the uDMA transmission of a port
+#define DMA_IDLE                0U
+#define DMA_PENDING             1U      // Waiting for the ring to send the bytes before it
+#define DMA_ACTIVE              2U
+
+// Divisor of a baud rate
+typedef struct {
+    uint32_t Brd64;                 // IBRD and FBRD: clock / (oversampling * baud) in 1/64ths
+    uint8_t Hse;                    // 1 for 8 samples per bit, 0 for 16
+    int32_t Error;                  // In ppm of the baud rate
+} UartDivisor_t;
+
+// State of a port
+typedef struct {
+    uint32_t Base;
+    uint32_t BaudRate;
+    UartClock_e ClockSource;
+    UartDivisor_t Divisor;
+    uint8_t *TxBuffer;
+    uint16_t TxMask;
+    volatile uint16_t TxHead;
+    volatile uint16_t TxTail;
+    uint8_t *RxBuffer;
+    uint16_t RxMask;
+    volatile uint16_t RxHead;
+    volatile uint16_t RxTail;
+    volatile uint32_t RxOverruns;
+    uint8_t FlowControl;
+    volatile uint8_t RxPaused;      // Receive interrupts masked until the ring has room
+    UartMessage_t *MsgPool;         // Message mode if not NULL
+    UartMessage_t *MsgCurrent;      // Being filled by the interrupt, NULL if none
+    uint8_t MsgFree[MSG_QUEUE_LEN]; // Buffers released by the main loop
+    volatile uint8_t MsgFreeHead;
+    volatile uint8_t MsgFreeTail;
+    uint8_t MsgReady[MSG_QUEUE_LEN];// Buffers filled by the interrupt, oldest first
+    volatile uint8_t MsgReadyHead;
+    volatile uint8_t MsgReadyTail;
+    UDMA_Entry_t *DmaTasks;
+    uint8_t DmaMaxTasks;
+    uint8_t DmaTaskCount;
+    volatile uint8_t DmaState;
+    uint16_t DmaMark;               // Ring position where the chain goes
+    UartDmaCallback_t DmaCallback;
+    void *DmaArg;
+} UartRing_t;
+
+static UartRing_t Ports[UART_RING_NUM_PORTS];
+
+// The system clock runs from PIOSC out of reset
+static uint32_t SystemClock = UART_RING_PIOSC_FREQ;
+
+static const uint8_t PortIrqs[UART_RING_NUM_PORTS] = { 5U, 6U, 33U, 56U, 57U, 58U, 59U, 60U };
+
+// uDMA channel and encoding that serve the transmit FIFO of each UART
+static const uint8_t DmaChannels[UART_RING_NUM_PORTS] = { 9U, 23U, 13U, 17U, 19U, 7U, 11U, 21U };
+static const uint8_t DmaEncodings[UART_RING_NUM_PORTS] = { 0U, 0U, 1U, 2U, 2U, 2U, 2U, 2U };
+
+// Rounds clock / (oversampling * baud) to the nearest 1/64. Returns the error of the rate
+// it gives in ppm, or INT32_MAX if the divisor is out of range (1 to 65535 + 63/64)
+static int32_t UART_DivisorError(uint32_t clock, uint32_t baud, uint32_t oversampling,
+                                 uint32_t *brd64) {
+    uint64_t brd = ((uint64_t) clock * 64U / oversampling + baud / 2U) / baud;
+
+    if (brd < 64U || brd > 0x3FFFFFU) {
+        return INT32_MAX;
+    }
+    *brd64 = (uint32_t) brd;
+
+    // Actual rate in micro-bits/s, minus the requested one, per bit/s
+    int64_t rate = (int64_t) ((uint64_t) clock * 64000000U / (oversampling * brd));
+    return (int32_t) ((rate - (int64_t) baud * 1000000) / (int64_t) baud);
+}
+
+// Picks the oversampling and divisor of a baud rate. Returns 1, or -1 if the rate cannot
+// be reached within UART_RING_MAX_ERROR
+static int UART_ComputeDivisor(uint32_t clock, uint32_t baud, UartDivisor_t *divisor) {
+    uint32_t brd16 = 0;
+    uint32_t brd8 = 0;
+    int32_t error16 = UART_DivisorError(clock, baud, 16U, &brd16);
+    int32_t error8 = UART_DivisorError(clock, baud, 8U, &brd8);
+    int32_t abs16 = error16 < 0 ? -error16 : error16;
+    int32_t abs8 = error8 < 0 ? -error8 : error8;
+
+    if (abs16 <= UART_RING_TARGET_ERROR || abs16 <= abs8) {
+        divisor->Brd64 = brd16;
+        divisor->Hse = 0;
+        divisor->Error = error16;
+    } else {
+        divisor->Brd64 = brd8;
+        divisor->Hse = 1;
+        divisor->Error = error8;
+    }
+
+    return divisor->Error <= UART_RING_MAX_ERROR && divisor->Error >= -UART_RING_MAX_ERROR ?
+           1 : -1;
+}
+
+// Loads a divisor into a disabled UART. Writing LCRH latches IBRD and FBRD
+static void UART_RingSetDivisor(UartRing_t *ring) {
+    UART_REG(ring->Base, UART_IBRD) = ring->Divisor.Brd64 >> 6;
+    UART_REG(ring->Base, UART_FBRD) = ring->Divisor.Brd64 & 0x3FUL;
+    UART_REG(ring->Base, UART_LCRH) = UART_LCRH_WLEN_8 | UART_LCRH_FEN;
+}
+
+// Enables an interrupt at the NVIC with the priority of the UARTs
+static void UART_RingEnableIRQ(uint8_t irq) {
+    ((volatile uint8_t *) &NVIC_PRI0_R)[irq] = (uint8_t) (UART_RING_PRIO << 5);
+    (&NVIC_EN0_R)[irq >> 5] = 1UL << (irq & 0x1FU);
+}
+
+// Keeps the interrupt of a port from running while the caller changes what the ISR
+// changes too (UART_IM, the uDMA state). An interrupt raised meanwhile stays pending and
+// runs at UART_RingUnlock()
+static void UART_RingLock(uint8_t port) {
+    uint8_t irq = PortIrqs[port];
+
+    (&NVIC_DIS0_R)[irq >> 5] = 1UL << (irq & 0x1FU);
+    UART_RING_BARRIER();
+}
+
+static void UART_RingUnlock(uint8_t port) {
+    uint8_t irq = PortIrqs[port];
+
+    (&NVIC_EN0_R)[irq >> 5] = 1UL << (irq & 0x1FU);
+}
+
+// Moves bytes from the transmit ring to the FIFO until one of them is full or empty.
+// Bytes queued after a uDMA chain wait for the chain
+static void UART_RingFill(UartRing_t *ring) {
+    uint16_t tail = ring->TxTail;
+    uint16_t end;
+
+    if (ring->DmaState == DMA_ACTIVE) {
+        return;
+    }
+    end = ring->DmaState == DMA_PENDING ? ring->DmaMark : ring->TxHead;
+
+    while (tail != end && !(UART_REG(ring->Base, UART_FR) & UART_FR_TXFF)) {
+        UART_REG(ring->Base, UART_DR) = ring->TxBuffer[tail];
+        tail = (tail + 1U) & ring->TxMask;
+    }
+    ring->TxTail = tail;
+}
+
+// Starts the uDMA chain of a port. The transmit interrupt must be masked
+static void UART_DmaStart(UartRing_t *ring, uint8_t port) {
+    uint8_t channel = DmaChannels[port];
+    UDMA_Entry_t *primary = UDMA_Primary(channel);
+
+    UDMA_AssignChannel(channel, DmaEncodings[port]);
+
+    // The primary entry copies the tasks one by one into the alternate entry
+    primary->SrcEnd = &ring->DmaTasks[ring->DmaTaskCount - 1U].Unused;
+    primary->DstEnd = &UDMA_Alternate(channel)->Unused;
+    primary->Control = UART_DMA_LIST(ring->DmaTaskCount);
+
+    ring->DmaState = DMA_ACTIVE;
+    UART_REG(ring->Base, UART_ICR) = UART_ICR_DMATXIC;
+    UART_REG(ring->Base, UART_IM) |= UART_IM_DMATXIM;
+    UDMA_EnableChannel(channel);
+    UART_REG(ring->Base, UART_DMACTL) |= UART_DMACTL_TXDMAE;
+}
+
+// Ends the uDMA chain of a port and resumes the ring
+static void UART_DmaFinish(UartRing_t *ring, uint8_t port) {
+    UART_REG(ring->Base, UART_DMACTL) &= ~UART_DMACTL_TXDMAE;
+    UART_REG(ring->Base, UART_IM) &= ~UART_IM_DMATXIM;
+    ring->DmaState = DMA_IDLE;
+
+    if (ring->DmaCallback != NULL) {
+        ring->DmaCallback((UartPort_e) port, ring->DmaArg);
+    }
+
+    UART_RingFill(ring);
+    if (ring->TxTail != ring->TxHead) {
+        UART_REG(ring->Base, UART_IM) |= UART_IM_TXIM;
+    }
+}
+
+// Moves bytes from the FIFO to the receive ring. With flow control a full ring leaves
+// the bytes in the FIFO, so that RTS pauses the sender
+static void UART_RingDrain(UartRing_t *ring) {
+    uint16_t head = ring->RxHead;
+
+    while (!(UART_REG(ring->Base, UART_FR) & UART_FR_RXFE)) {
+        uint16_t next = (head + 1U) & ring->RxMask;
+
+        if (next == ring->RxTail && ring->FlowControl) {
+            ring->RxPaused = 1;
+            UART_REG(ring->Base, UART_IM) &= ~(UART_IM_RXIM | UART_IM_RTIM);
+            break;
+        }
+
+        uint32_t data = UART_REG(ring->Base, UART_DR);
+        if (data & UART_DR_OE) {
+            ring->RxOverruns++;
+        }
+        if (next == ring->RxTail) {
+            ring->RxOverruns++;
+        } else {
+            ring->RxBuffer[head] = (uint8_t) data;
+            head = next;
+        }
+    }
+    ring->RxHead = head;
+}
+
+// Hands a message over to UART_ReceiveMessage()
+static void UART_MsgPublish(UartRing_t *ring, UartMessage_t *message, uint8_t end_of_burst) {
+    uint8_t head = ring->MsgReadyHead;
+
+    message->EndOfBurst = end_of_burst;
+    ring->MsgReady[head] = (uint8_t) (message - ring->MsgPool);
+    ring->MsgReadyHead = (head + 1U) & MSG_QUEUE_MASK;
+}
+
+// Moves bytes from the FIFO to the current message. A receive interrupt takes
+// UART_RX_BATCH bytes, so at least one stays in the FIFO and the time-out fires once the
+// line goes idle. The time-out empties the FIFO and ends the message
+static void UART_MsgDrain(UartRing_t *ring, uint32_t status) {
+    UartMessage_t *message = ring->MsgCurrent;
+    uint8_t timeout = (status & UART_MIS_RTMIS) != 0;
+    uint8_t count = timeout ? 16U : (status & UART_MIS_RXMIS) ? UART_RX_BATCH : 0U;
+
+    while (count-- && !(UART_REG(ring->Base, UART_FR) & UART_FR_RXFE)) {
+        // A full buffer is only handed over when the burst goes on, so that the
+        // time-out can still mark the end of a burst that fills it exactly
+        if (message != NULL && message->Length == UART_MSG_SIZE) {
+            UART_MsgPublish(ring, message, 0);
+            message = NULL;
+        }
+
+        if (message == NULL && ring->MsgFreeTail != ring->MsgFreeHead) {
+            message = &ring->MsgPool[ring->MsgFree[ring->MsgFreeTail]];
+            ring->MsgFreeTail = (ring->MsgFreeTail + 1U) & MSG_QUEUE_MASK;
+            message->Length = 0;
+        }
+
+        uint32_t data = UART_REG(ring->Base, UART_DR);
+        if (data & UART_DR_OE) {
+            ring->RxOverruns++;
+        }
+        if (message == NULL) {
+            ring->RxOverruns++;
+        } else {
+            message->Data[message->Length++] = (uint8_t) data;
+        }
+    }
+
+    if (timeout && message != NULL && (UART_REG(ring->Base, UART_FR) & UART_FR_RXFE)) {
+        UART_MsgPublish(ring, message, 1);
+        message = NULL;
+    }
+    ring->MsgCurrent = message;
+}
+
+// Serves the interrupt of a port
+static void UART_RingService(uint8_t port) {
+    UartRing_t *ring = &Ports[port];
+    uint32_t status = UART_REG(ring->Base, UART_MIS);
+
+    // In message mode the receive interrupt is left to clear itself once the FIFO drops
+    // below the watermark, so that it fires again if the batch did not get it there
+    UART_REG(ring->Base, UART_ICR) = ring->MsgPool != NULL ? status & ~UART_ICR_RXIC : status;
+
+    if (ring->MsgPool != NULL) {
+        UART_MsgDrain(ring, status);
+    } else if (!ring->RxPaused) {
+        // Also runs when UART_Read() resumes a paused reception, with no status bit set
+        UART_RingDrain(ring);
+    }
+
+    if (status & UART_MIS_TXMIS) {
+        UART_RingFill(ring);
+
+        // The bytes before a waiting chain are out: hand the FIFO to the uDMA
+        if (ring->DmaState == DMA_PENDING && ring->TxTail == ring->DmaMark) {
+            UART_REG(ring->Base, UART_IM) &= ~UART_IM_TXIM;
+            UART_DmaStart(ring, port);
+        }
+
+        // Nothing left to send: the next UART_Write() restarts the transmission
+        if (ring->TxTail == ring->TxHead) {
+            UART_REG(ring->Base, UART_IM) &= ~UART_IM_TXIM;
+        }
+    }
+
+    if ((status & UART_MIS_DMATXMIS) && ring->DmaState == DMA_ACTIVE &&
+        !UDMA_IsChannelEnabled(DmaChannels[port])) {
+        UART_DmaFinish(ring, port);
+    }
+}
+
+int UART_RingInit(UartPort_e port, const UartRingConfig_t *config) {
+    if (port >= UART_RING_NUM_PORTS || config->BaudRate == 0 ||
+        config->TxBuffer == NULL || config->TxSize < 2U || (config->TxSize & (config->TxSize - 1U)) ||
+        (config->MsgPool == NULL && (config->RxBuffer == NULL || config->RxSize < 2U ||
+                                     (config->RxSize & (config->RxSize - 1U)))) ||
+        (config->MsgPool != NULL && (config->MsgCount == 0 || config->MsgCount > UART_MSG_MAX_COUNT)) ||
+        (config->DmaTasks != NULL && config->DmaMaxTasks == 0)) {
+        return -1;
+    }
+
+    UartDivisor_t divisor;
+    uint32_t clock = config->ClockSource == UART_CLOCK_SYSTEM ? SystemClock : UART_RING_PIOSC_FREQ;
+    if (UART_ComputeDivisor(clock, config->BaudRate, &divisor) < 0) {
+        return -1;
+    }
+
+    UartRing_t *ring = &Ports[port];
+    ring->Base = UART_BASE(port);
+    ring->BaudRate = config->BaudRate;
+    ring->ClockSource = config->ClockSource;
+    ring->Divisor = divisor;
+    ring->TxBuffer = config->TxBuffer;
+    ring->TxMask = config->TxSize - 1U;
+    ring->TxHead = 0;
+    ring->TxTail = 0;
+    ring->RxBuffer = config->RxBuffer;
+    ring->RxMask = config->RxBuffer != NULL ? config->RxSize - 1U : 0U;
+    ring->RxHead = 0;
+    ring->RxTail = 0;
+    ring->RxOverruns = 0;
+    ring->FlowControl = config->FlowControl;
+    ring->RxPaused = 0;
+    ring->MsgPool = config->MsgPool;
+    ring->MsgCurrent = NULL;
+    ring->MsgReadyHead = 0;
+    ring->MsgReadyTail = 0;
+    ring->MsgFreeTail = 0;
+    ring->MsgFreeHead = ring->MsgPool != NULL ? config->MsgCount : 0U;
+    for (uint8_t i = 0; i < ring->MsgFreeHead; i++) {
+        ring->MsgFree[i] = i;
+    }
+    ring->DmaTasks = config->DmaTasks;
+    ring->DmaMaxTasks = config->DmaMaxTasks;
+    ring->DmaState = DMA_IDLE;
+
+    if (ring->DmaTasks != NULL) {
+        UDMA_Init();
+    }
+
+    // Enable the clock of the UART and wait until it is ready
+    SYSCTL_RCGCUART_R |= 1UL << port;
+    while (!(SYSCTL_PRUART_R & (1UL << port)));
+
+    // UART must be disabled while it is configured
+    UART_REG(ring->Base, UART_CTL) = 0;
+    UART_RingSetDivisor(ring);
+    UART_REG(ring->Base, UART_CC) = ring->ClockSource == UART_CLOCK_SYSTEM ?
+                                    UART_CC_CS_SYSCLK : UART_CC_CS_PIOSC;
+    UART_REG(ring->Base, UART_IFLS) = UART_IFLS_TX2_8 | UART_IFLS_RX4_8;
+
+    // Receive interrupts stay enabled, the transmit one only while the ring holds data
+    UART_REG(ring->Base, UART_ECR) = 0;
+    UART_REG(ring->Base, UART_DMACTL) = 0;
+    UART_REG(ring->Base, UART_ICR) = 0xFFFFFFFFUL;
+    UART_REG(ring->Base, UART_IM) = UART_IM_RXIM | UART_IM_RTIM;
+    UART_REG(ring->Base, UART_CTL) = UART_CTL_UARTEN | UART_CTL_TXE | UART_CTL_RXE |
+                                     (ring->Divisor.Hse ? UART_CTL_HSE : 0) |
+                                     (ring->FlowControl ? UART_CTL_RTSEN | UART_CTL_CTSEN : 0);
+
+    UART_RingEnableIRQ(PortIrqs[port]);
+    return 1;
+}
+
+int UART_SetSystemClock(uint32_t freq) {
+    int status = 1;
+
+    SystemClock = freq;
+
+    for (uint8_t port = 0; port < UART_RING_NUM_PORTS; port++) {
+        UartRing_t *ring = &Ports[port];
+        UartDivisor_t divisor;
+
+        // Ports that were never configured have no base address
+        if (ring->Base == 0 || ring->ClockSource != UART_CLOCK_SYSTEM) {
+            continue;
+        }
+        if (UART_ComputeDivisor(freq, ring->BaudRate, &divisor) < 0) {
+            status = -1;
+            continue;
+        }
+        ring->Divisor = divisor;
+
+        // The divisor and HSE only change while the UART is disabled. The FIFOs keep
+        // their contents, and the interrupts do not touch these registers
+        uint32_t ctl = UART_REG(ring->Base, UART_CTL);
+        UART_REG(ring->Base, UART_CTL) = ctl & ~UART_CTL_UARTEN;
+        UART_RingSetDivisor(ring);
+        ctl = divisor.Hse ? ctl | UART_CTL_HSE : ctl & ~UART_CTL_HSE;
+        UART_REG(ring->Base, UART_CTL) = ctl;
+    }
+
+    return status;
+}
+
+uint32_t UART_GetBaudRate(UartPort_e port) {
+    const UartRing_t *ring = &Ports[port];
+    return (uint32_t) ((int64_t) ring->BaudRate +
+                       (int64_t) ring->BaudRate * ring->Divisor.Error / 1000000);
+}
+
+int32_t UART_GetBaudError(UartPort_e port) {
+    return Ports[port].Divisor.Error;
+}
+
+uint16_t UART_Write(UartPort_e port, const uint8_t *data, uint16_t len) {
+    UartRing_t *ring = &Ports[port];
+    uint16_t head = ring->TxHead;
+    uint16_t written = 0;
+
+    while (written < len) {
+        uint16_t next = (head + 1U) & ring->TxMask;
+        if (next == ring->TxTail) {
+            break;
+        }
+        ring->TxBuffer[head] = data[written++];
+        head = next;
+    }
+    ring->TxHead = head;
+
+    // With the interrupt locked out the ISR leaves TxTail alone, so the FIFO can be
+    // topped up from here. If bytes are left, the FIFO is full and will cross the
+    // watermark again, which raises the interrupt that sends the rest. A uDMA chain
+    // waiting or in progress sends them when it is done instead
+    UART_RingLock((uint8_t) port);
+    if (ring->DmaState == DMA_IDLE) {
+        UART_RingFill(ring);
+        if (ring->TxTail != ring->TxHead) {
+            UART_REG(ring->Base, UART_IM) |= UART_IM_TXIM;
+        }
+    }
+    UART_RingUnlock((uint8_t) port);
+
+    return written;
+}
+
+int UART_WriteDma(UartPort_e port, const UartSegment_t *segments, uint8_t count,
+                  UartDmaCallback_t callback, void *arg) {
+    UartRing_t *ring = &Ports[port];
+
+    if (ring->DmaTasks == NULL || ring->DmaState != DMA_IDLE || count == 0 ||
+        count > ring->DmaMaxTasks) {
+        return -1;
+    }
+
+    // One task per buffer, each one loaded into the alternate entry in turn
+    for (uint8_t i = 0; i < count; i++) {
+        if (segments[i].Data == NULL || segments[i].Length == 0 ||
+            segments[i].Length > UDMA_MAX_TRANSFER) {
+            return -1;
+        }
+
+        UDMA_Entry_t *task = &ring->DmaTasks[i];
+        task->SrcEnd = &segments[i].Data[segments[i].Length - 1U];
+        task->DstEnd = (volatile void *) (ring->Base + UART_DR);
+        task->Control = UART_DMA_TASK(segments[i].Length, i + 1U < count ?
+                                      UDMA_CHCTL_XFERMODE_PER_SGA : UDMA_CHCTL_XFERMODE_BASIC);
+        task->Unused = 0;
+    }
+    ring->DmaTaskCount = count;
+    ring->DmaCallback = callback;
+    ring->DmaArg = arg;
+
+    // The chain goes after the bytes queued so far. The ISR starts it once they are out
+    UART_RingLock((uint8_t) port);
+    UART_REG(ring->Base, UART_IM) &= ~UART_IM_TXIM;
+    ring->DmaMark = ring->TxHead;
+    if (ring->TxTail == ring->DmaMark) {
+        UART_DmaStart(ring, (uint8_t) port);
+    } else {
+        ring->DmaState = DMA_PENDING;
+        UART_REG(ring->Base, UART_IM) |= UART_IM_TXIM;
+    }
+    UART_RingUnlock((uint8_t) port);
+
+    return 1;
+}
+
+uint8_t UART_DmaBusy(UartPort_e port) {
+    return Ports[port].DmaState != DMA_IDLE;
+}
+
+uint16_t UART_Read(UartPort_e port, uint8_t *data, uint16_t len) {
+    UartRing_t *ring = &Ports[port];
+    uint16_t tail = ring->RxTail;
+    uint16_t count = 0;
+
+    while (count < len && tail != ring->RxHead) {
+        data[count++] = ring->RxBuffer[tail];
+        tail = (tail + 1U) & ring->RxMask;
+    }
+    ring->RxTail = tail;
+
+    // There is room again: let the ISR empty the FIFO, which lets RTS resume the sender
+    if (ring->RxPaused && count) {
+        uint8_t irq = PortIrqs[port];
+        UART_RingLock((uint8_t) port);
+        ring->RxPaused = 0;
+        UART_REG(ring->Base, UART_IM) |= UART_IM_RXIM | UART_IM_RTIM;
+        (&NVIC_PEND0_R)[irq >> 5] = 1UL << (irq & 0x1FU);
+        UART_RingUnlock((uint8_t) port);
+    }
+
+    return count;
+}
+
+UartMessage_t *UART_ReceiveMessage(UartPort_e port) {
+    UartRing_t *ring = &Ports[port];
+    uint8_t tail = ring->MsgReadyTail;
+
+    if (ring->MsgPool == NULL || tail == ring->MsgReadyHead) {
+        return NULL;
+    }
+
+    ring->MsgReadyTail = (tail + 1U) & MSG_QUEUE_MASK;
+    return &ring->MsgPool[ring->MsgReady[tail]];
+}
+
+void UART_ReleaseMessage(UartPort_e port, UartMessage_t *message) {
+    UartRing_t *ring = &Ports[port];
+    uint8_t head = ring->MsgFreeHead;
+
+    ring->MsgFree[head] = (uint8_t) (message - ring->MsgPool);
+    ring->MsgFreeHead = (head + 1U) & MSG_QUEUE_MASK;
+}
+
+uint16_t UART_TxSpace(UartPort_e port) {
+    const UartRing_t *ring = &Ports[port];
+    return (uint16_t) ((ring->TxTail - ring->TxHead - 1U) & ring->TxMask);
+}
+
+uint16_t UART_RxCount(UartPort_e port) {
+    const UartRing_t *ring = &Ports[port];
+    return (uint16_t) ((ring->RxHead - ring->RxTail) & ring->RxMask);
+}
+
+uint8_t UART_TxDone(UartPort_e port) {
+    const UartRing_t *ring = &Ports[port];
+    return ring->TxTail == ring->TxHead && ring->DmaState == DMA_IDLE &&
+           !(UART_REG(ring->Base, UART_FR) & UART_FR_BUSY);
+}
+
+uint32_t UART_GetRxOverruns(UartPort_e port) {
+    return Ports[port].RxOverruns;
+}
+
+void UART0_Handler(void) {
+    UART_RingService(0U);
+}
+
+void UART1_Handler(void) {
+    UART_RingService(1U);
+}
+
+void UART2_Handler(void) {
+    UART_RingService(2U);
+}
+
+void UART3_Handler(void) {
+    UART_RingService(3U);
+}
+
+void UART4_Handler(void) {
+    UART_RingService(4U);
+}
+
+void UART5_Handler(void) {
+    UART_RingService(5U);
+}
+
+void UART6_Handler(void) {
+    UART_RingService(6U);
+}
+
+void UART7_Handler(void) {
+    UART_RingService(7U);
+}
@@ -0,0 +1,73 @@
+#include "udma.h"
+#include "official_tm4c1294ncpdt.h"
+
+// Primary entries first, then the alternate entries (at offset 0x200)
+#pragma data_alignment=1024
+static UDMA_Entry_t ControlTable[2U * UDMA_NUM_CHANNELS];
+
+static uint8_t Ready = 0;
+static volatile uint32_t Errors = 0;
+
+void UDMA_Init(void) {
+    if (Ready) {
+        return;
+    }
+
+    // Enable the clock and wait until the controller is ready
+    SYSCTL_RCGCDMA_R |= SYSCTL_RCGCDMA_R0;
+    while (!(SYSCTL_PRDMA_R & SYSCTL_PRDMA_R0));
+
+    UDMA_CFG_R = UDMA_CFG_MASTEN;
+    UDMA_CTLBASE_R = (uint32_t) ControlTable;
+
+    // Report bus errors
+    UDMA_ERRCLR_R = 1;
+    // IRQ 45: priority in bits 15:13 of PRI11
+    NVIC_PRI11_R = (NVIC_PRI11_R & ~0x0000E000UL) | ((uint32_t) UDMA_ERROR_PRIO << 13);
+    NVIC_EN1_R = 1UL << (UDMA_ERROR_IRQ - 32U);
+
+    Ready = 1;
+}
+
+void UDMA_AssignChannel(uint8_t channel, uint8_t encoding) {
+    // Each CHMAP register holds a 4-bit field for 8 consecutive channels
+    volatile uint32_t *map = &UDMA_CHMAP0_R + (channel >> 3);
+    uint8_t shift = (channel & 0x7U) * 4U;
+    *map = (*map & ~(0xFUL << shift)) | ((uint32_t) encoding << shift);
+
+    uint32_t mask = 1UL << channel;
+    UDMA_ENACLR_R = mask;
+    UDMA_PRIOCLR_R = mask;
+    UDMA_ALTCLR_R = mask;
+    UDMA_USEBURSTCLR_R = mask;
+    UDMA_REQMASKCLR_R = mask;
+}
+
+UDMA_Entry_t *UDMA_Primary(uint8_t channel) {
+    return &ControlTable[channel];
+}
+
+UDMA_Entry_t *UDMA_Alternate(uint8_t channel) {
+    return &ControlTable[UDMA_NUM_CHANNELS + channel];
+}
+
+void UDMA_EnableChannel(uint8_t channel) {
+    UDMA_ENASET_R = 1UL << channel;
+}
+
+void UDMA_DisableChannel(uint8_t channel) {
+    UDMA_ENACLR_R = 1UL << channel;
+}
+
+uint8_t UDMA_IsChannelEnabled(uint8_t channel) {
+    return (UDMA_ENASET_R >> channel) & 1U;
+}
+
+uint32_t UDMA_GetErrorCount(void) {
+    return Errors;
+}
+
+void DMA0_Error_Handler(void) {
+    UDMA_ERRCLR_R = 1;
+    Errors++;
+}
@@ -0,0 +1,91 @@
+#include "watch.h"
+
+#include <stddef.h>
+
+// Reads a variable, sign-extended if it is signed
+static uint32_t Watch_Read(const WatchVar_t *var) {
+    switch (var->Size) {
+        case 1:
+            return var->Signed ? (uint32_t) (int32_t) *(const volatile int8_t *) var->Address :
+                                 *(const volatile uint8_t *) var->Address;
+        case 2:
+            return var->Signed ? (uint32_t) (int32_t) *(const volatile int16_t *) var->Address :
+                                 *(const volatile uint16_t *) var->Address;
+        default:
+            return *(const volatile uint32_t *) var->Address;
+    }
+}
+
+int Watch_Init(Watch_t *watch, const WatchConfig_t *config, uint32_t now) {
+    if (config->Telemetry == NULL || config->Vars == NULL || config->NumVars == 0 ||
+        config->NumVars > WATCH_MAX_VARS || config->MaxPerPoll == 0 ||
+        config->FirstChannel + config->NumVars - 1U > TELEMETRY_MAX_CHANNEL) {
+        return -1;
+    }
+
+    for (uint8_t i = 0; i < config->NumVars; i++) {
+        uint8_t size = config->Vars[i].Size;
+        if (size != 1U && size != 2U && size != 4U) {
+            return -1;
+        }
+    }
+
+    watch->Config = *config;
+    watch->NextRound = now;
+    watch->Cursor = config->NumVars;
+    watch->Full = 1;
+    watch->Rounds = 0;
+    return 1;
+}
+
+uint8_t Watch_Poll(Watch_t *watch, uint32_t now) {
+    const WatchConfig_t *config = &watch->Config;
+    uint8_t count = 0;
+
+    if (watch->Cursor == config->NumVars) {
+        if ((int32_t) (now - watch->NextRound) < 0) {
+            return 0;
+        }
+
+        // Rounds that could not be served in time are skipped, not caught up on
+        watch->NextRound += config->Period;
+        if ((int32_t) (now - watch->NextRound) >= 0) {
+            watch->NextRound = now + config->Period;
+        }
+
+        watch->Cursor = 0;
+        if (config->Keyframe && ++watch->Rounds >= config->Keyframe) {
+            watch->Full = 1;
+        }
+        if (!config->OnChange) {
+            watch->Full = 1;
+        }
+    }
+
+    while (count < config->MaxPerPoll && watch->Cursor < config->NumVars) {
+        uint8_t index = watch->Cursor++;
+        const WatchVar_t *var = &config->Vars[index];
+        uint32_t value = Watch_Read(var);
+        uint16_t channel = config->FirstChannel + index;
+
+        if (watch->Full || value != watch->Last[index]) {
+            if (var->Signed) {
+                Telemetry_PutInt(config->Telemetry, channel, (int32_t) value, now);
+            } else {
+                Telemetry_PutUInt(config->Telemetry, channel, value, now);
+            }
+        }
+        watch->Last[index] = value;
+        count++;
+    }
+
+    if (watch->Cursor == config->NumVars) {
+        Telemetry_Flush(config->Telemetry);
+        if (watch->Full) {
+            watch->Full = 0;
+            watch->Rounds = 0;
+        }
+    }
+
+    return count;
+}